@@ -27,7 +27,13 @@ func GetPackage() *denv.Package {
 	maintest.Dependencies = append(maintest.Dependencies, xbasepkg.GetMainLib())
 	maintest.Dependencies = append(maintest.Dependencies, mainlib)
 
+	// 'xtime' benchmark application
+	mainbench := denv.SetupDefaultCppAppProject("xtime_bench", "github.com\\jurgen-kluft\\xtime")
+	mainbench.Dependencies = append(mainbench.Dependencies, xbasepkg.GetMainLib())
+	mainbench.Dependencies = append(mainbench.Dependencies, mainlib)
+
 	mainpkg.AddMainLib(mainlib)
+	mainpkg.AddMainApp(mainbench)
 	mainpkg.AddUnittest(maintest)
 	return mainpkg
 }
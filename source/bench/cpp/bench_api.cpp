@@ -0,0 +1,528 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timer.h"
+#include "xtime/x_frame_rate.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_datetime.h"
+#include "xtime/private/x_time_source.h"
+
+#include "bench_harness.h"
+
+#include <chrono>
+
+using namespace xcore;
+
+namespace
+{
+	// Every benchmark folds its results into the checksum, the inputs depend on
+	// the loop counter so that nothing can be hoisted out of the loop.
+
+	// A real clock, the harness measures with x_GetTime()
+	class bench_time_source : public time_source_t
+	{
+	public:
+		virtual s64		getTimeInTicks()
+		{
+			return (s64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		virtual s64		getTicksPerSecond()
+		{
+			return 1000000000;
+		}
+	};
+
+	// The same source published for all threads, so every call pins it, and
+	// installed for the calling thread only, which needs no pin. The difference is
+	// the cost of the pin.
+	void sBenchTimeSource(bench_runner_t &runner)
+	{
+		static bench_time_source sSource;
+		time_source_t *previous = x_SetTimeSource(&sSource);
+		runner.run("x_GetTime, shared source", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTime();
+			return sum;
+		});
+		runner.runScaling("x_GetTime, shared source (threads)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTime();
+			return sum;
+		});
+		x_SetTimeSource(previous);
+
+		runner.run("x_GetTime, thread source", [](u32, u64 n) {
+			time_source_t *previous = x_SetThreadTimeSource(&sSource);
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTime();
+			x_SetThreadTimeSource(previous);
+			return sum;
+		});
+		runner.runScaling("x_GetTime, thread source (threads)", [](u32, u64 n) {
+			time_source_t *previous = x_SetThreadTimeSource(&sSource);
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTime();
+			x_SetThreadTimeSource(previous);
+			return sum;
+		});
+	}
+
+	void sBenchTime(bench_runner_t &runner)
+	{
+		runner.group("x_time.h");
+
+		runner.run("x_GetTime", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTime();
+			return sum;
+		});
+		runner.runScaling("x_GetTime (threads)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTime();
+			return sum;
+		});
+		sBenchTimeSource(runner);
+		runner.run("x_GetTicksPerSecond", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_GetTicksPerSecond();
+			return sum;
+		});
+		runner.run("x_GetTimeSec", [](u32, u64 n) {
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += x_GetTimeSec();
+			return (u64)sum;
+		});
+		runner.run("x_TicksToSec", [](u32, u64 n) {
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += x_TicksToSec((tick_t)i);
+			return (u64)sum;
+		});
+		runner.run("x_TicksToMs", [](u32, u64 n) {
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += x_TicksToMs((tick_t)i);
+			return (u64)sum;
+		});
+		runner.run("x_TicksToUs", [](u32, u64 n) {
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += x_TicksToUs((tick_t)i);
+			return (u64)sum;
+		});
+		runner.run("x_SecondsToTicks", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_SecondsToTicks((f64)(i & 1023) * 0.001);
+			return sum;
+		});
+		runner.run("x_MillisecondsToTicks", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_MillisecondsToTicks((f64)(i & 1023));
+			return sum;
+		});
+		runner.run("x_MicrosecondsToTicks", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)x_MicrosecondsToTicks((f64)(i & 1023));
+			return sum;
+		});
+	}
+
+	void sBenchTimer(bench_runner_t &runner)
+	{
+		runner.group("x_timer.h");
+
+		runner.run("timer_t::start/stop", [](u32, u64 n) {
+			xcore::timer_t timer;
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				timer.start();
+				sum += (u64)timer.stop();
+			}
+			return sum;
+		});
+		runner.run("timer_t::read", [](u32, u64 n) {
+			xcore::timer_t timer;
+			timer.start();
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)timer.read();
+			return sum;
+		});
+		runner.run("timer_t::trip", [](u32, u64 n) {
+			xcore::timer_t timer;
+			timer.start();
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)timer.trip();
+			return sum + (u64)timer.getNumTrips();
+		});
+		runner.runScaling("timer_t::trip (threads)", [](u32, u64 n) {
+			xcore::timer_t timer;
+			timer.start();
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += (u64)timer.trip();
+			return sum;
+		});
+		runner.run("timer_t::readSec/Ms/Us", [](u32, u64 n) {
+			xcore::timer_t timer;
+			timer.start();
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += timer.readSec() + timer.readMs() + timer.readUs();
+			return (u64)sum;
+		});
+		runner.run("timer_t::tripSec/Ms/Us", [](u32, u64 n) {
+			xcore::timer_t timer;
+			timer.start();
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += timer.tripSec() + timer.tripMs() + timer.tripUs();
+			return (u64)sum;
+		});
+		runner.run("timer_t::stopSec/Ms/Us", [](u32, u64 n) {
+			xcore::timer_t timer;
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				timer.start();
+				sum += timer.stopSec() + timer.stopMs() + timer.stopUs();
+			}
+			return (u64)sum;
+		});
+		runner.run("timer_t::getAverageMs", [](u32, u64 n) {
+			xcore::timer_t timer;
+			timer.start();
+			f64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += timer.getAverageMs();
+			return (u64)sum + (timer.isRunning() ? 1 : 0);
+		});
+		runner.run("timer_t::reset", [](u32, u64 n) {
+			xcore::timer_t timer;
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				timer.start();
+				timer.reset();
+				sum += (u64)timer.getNumTrips();
+			}
+			return sum;
+		});
+	}
+
+	void sBenchFrameRate(bench_runner_t &runner)
+	{
+		runner.group("x_frame_rate.h");
+
+		runner.run("framerate_t::markFrame", [](u32, u64 n) {
+			framerate_t fps;
+			for (u64 i = 0; i < n; ++i)
+				fps.markFrame();
+			f32 rate = 0.0f;
+			fps.getFrameRate(rate);
+			return (u64)rate;
+		});
+		runner.run("framerate_t::getFrameRate", [](u32, u64 n) {
+			framerate_t fps;
+			fps.markFrame();
+			u64 sum = 0;
+			f32 rate = 0.0f;
+			for (u64 i = 0; i < n; ++i)
+				sum += fps.getFrameRate(rate) ? 1 : 0;
+			return sum;
+		});
+		runner.run("framerate_t::restart", [](u32, u64 n) {
+			framerate_t fps;
+			u64 sum = 0;
+			f32 rate = 0.0f;
+			for (u64 i = 0; i < n; ++i)
+			{
+				fps.restart();
+				sum += fps.getFrameRate(rate) ? 1 : 0;
+			}
+			return sum;
+		});
+	}
+
+	void sBenchTimeSpan(bench_runner_t &runner)
+	{
+		runner.group("x_timespan.h");
+
+		runner.run("timespan_t(ticks)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += timespan_t(i).ticks();
+			return sum;
+		});
+		runner.run("timespan_t(d, h, m, s, ms)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += timespan_t((s32)(i & 31), 12, 30, 15, 500).ticks();
+			return sum;
+		});
+		runner.run("timespan_t::days..milliseconds", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				timespan_t const ts(i * X_CONSTANT_64(1234567));
+				sum += (u64)(ts.days() + ts.hours() + ts.minutes() + ts.seconds() + ts.milliseconds());
+			}
+			return sum;
+		});
+		runner.run("timespan_t::totalDays..totalMilliseconds", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				timespan_t const ts(i * X_CONSTANT_64(1234567));
+				sum += ts.totalDays() + ts.totalHours() + ts.totalMinutes() + ts.totalSeconds() + ts.totalMilliseconds();
+			}
+			return sum;
+		});
+		runner.run("timespan_t::add/substract", [](u32, u64 n) {
+			timespan_t ts(0);
+			timespan_t const step(3);
+			timespan_t const back(1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				ts.add(step);
+				ts.substract(back);
+			}
+			return ts.ticks();
+		});
+		runner.run("timespan_t::negate/duration", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				timespan_t ts(i + 1);
+				sum += ts.negate().duration().ticks();
+			}
+			return sum;
+		});
+		runner.run("timespan_t operators", [](u32, u64 n) {
+			u64 sum = 0;
+			timespan_t const one(1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				timespan_t const a(i);
+				timespan_t b = a + one;
+				b -= one;
+				b += one;
+				sum += (b - a).ticks() + (a < b ? 1 : 0) + (a == b ? 1 : 0) + (a >= b ? 1 : 0);
+			}
+			return sum;
+		});
+		runner.run("timespan_t::compareTo/equals", [](u32, u64 n) {
+			u64 sum = 0;
+			timespan_t const pivot(X_CONSTANT_64(1) << 20);
+			for (u64 i = 0; i < n; ++i)
+			{
+				timespan_t const ts(i);
+				sum += (u64)(ts.compareTo(pivot) + 1) + (ts.equals(pivot) ? 1 : 0);
+			}
+			return sum;
+		});
+		runner.run("timespan_t::sFromDays..sFromTicks", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				u64 const v = i & 1023;
+				sum += timespan_t::sFromDays(v).ticks() + timespan_t::sFromHours(v).ticks() + timespan_t::sFromMinutes(v).ticks();
+				sum += timespan_t::sFromSeconds(v).ticks() + timespan_t::sFromMilliseconds(v).ticks() + timespan_t::sFromTicks(v).ticks();
+			}
+			return sum;
+		});
+		runner.run("timespan_t::sTimeToTicks", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += timespan_t::sTimeToTicks((s32)(i & 31), 12, 30, 15, 500);
+			return sum;
+		});
+	}
+
+	void sBenchDateTime(bench_runner_t &runner)
+	{
+		runner.group("x_datetime.h");
+
+		runner.run("datetime_t(y, m, d)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t(1900 + (s32)(i & 255), 1 + (s32)(i % 12), 1 + (s32)(i % 28)).ticks();
+			return sum;
+		});
+		runner.run("datetime_t(y, m, d, h, m, s, ms)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t(1900 + (s32)(i & 255), 1 + (s32)(i % 12), 1 + (s32)(i % 28), (s32)(i % 24), 30, 15, 500).ticks();
+			return sum;
+		});
+		runner.run("datetime_t::year/month/day", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				datetime_t const dt(base.ticks() + i * X_CONSTANT_64(8640000000));
+				sum += (u64)(dt.year() + (s32)dt.month() + dt.day());
+			}
+			return sum;
+		});
+		runner.run("datetime_t::hour..millisecond", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				datetime_t const dt(base.ticks() + i * X_CONSTANT_64(12345678));
+				sum += (u64)(dt.hour() + dt.minute() + dt.second() + dt.millisecond());
+			}
+			return sum;
+		});
+		runner.run("datetime_t::date/timeOfDay", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				datetime_t const dt(base.ticks() + i * X_CONSTANT_64(12345678));
+				sum += dt.date().ticks() + dt.timeOfDay().ticks();
+			}
+			return sum;
+		});
+		runner.run("datetime_t::dayOfWeek/dayOfYear", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				datetime_t const dt(base.ticks() + i * X_CONSTANT_64(8640000000));
+				sum += (u64)((s32)dt.dayOfWeek() + (s32)dt.dayOfWeekShort() + dt.dayOfYear() + (s32)dt.monthShort());
+			}
+			return sum;
+		});
+		runner.run("datetime_t::addYears/addMonths", [](u32, u64 n) {
+			datetime_t dt(1900, 1, 31);
+			for (u64 i = 0; i < n; ++i)
+			{
+				dt.addMonths(1);
+				if ((i & 1023) == 1023)
+				{
+					dt.addYears(-85);
+				}
+			}
+			return dt.ticks();
+		});
+		runner.run("datetime_t::addDays..addMilliseconds", [](u32, u64 n) {
+			datetime_t dt(1900, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				dt.addDays(1).addHours(1).addMinutes(1).addSeconds(1).addMilliseconds(1);
+				if ((i & 4095) == 4095)
+					dt = datetime_t(1900, 1, 1);
+			}
+			return dt.ticks();
+		});
+		runner.run("datetime_t::add/addTicks/subtract", [](u32, u64 n) {
+			datetime_t dt(2000, 1, 1);
+			timespan_t const step(10);
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				dt.add(step).addTicks(5).subtract(timespan_t(3));
+				sum += dt.subtract(datetime_t(2000, 1, 1)).ticks();
+			}
+			return sum;
+		});
+		runner.run("datetime_t operators", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			timespan_t const one(1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				datetime_t const a(base.ticks() + i);
+				datetime_t const b = a + one;
+				datetime_t const c = b - one;
+				sum += (b - a).ticks() + (a < b ? 1 : 0) + (a == c ? 1 : 0) + (a != b ? 1 : 0) + (a > b ? 1 : 0) + (a <= c ? 1 : 0) + (b >= a ? 1 : 0);
+			}
+			return sum;
+		});
+		runner.run("datetime_t::compareTo/equals/swap", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t pivot(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+			{
+				datetime_t dt(pivot.ticks() + (i & 1));
+				sum += (u64)(dt.compareTo(pivot) + 1) + (dt.equals(pivot) ? 1 : 0);
+				dt.swap(pivot);
+			}
+			return sum + pivot.ticks();
+		});
+		runner.run("datetime_t::toBinary/sFromBinary", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t::sFromBinary(datetime_t(base.ticks() + i).toBinary()).ticks();
+			return sum;
+		});
+		// sFromFileTime is left out, the mac backend converts a file time by walking
+		// the calendar which makes it too slow to be measured this way.
+		runner.run("datetime_t::toFileTime", [](u32, u64 n) {
+			u64 sum = 0;
+			datetime_t const base(2000, 1, 1);
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t(base.ticks() + i * X_CONSTANT_64(10000000)).toFileTime();
+			return sum;
+		});
+		runner.run("datetime_t::sDaysInMonth/sDaysInYear/sIsLeapYear", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+			{
+				s32 const year = 1600 + (s32)(i & 1023);
+				sum += (u64)(datetime_t::sDaysInMonth(year, 1 + (s32)(i % 12)) + datetime_t::sDaysInYear(year) + (datetime_t::sIsLeapYear(year) ? 1 : 0));
+			}
+			return sum;
+		});
+		runner.run("datetime_t::sNow", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t::sNow().ticks();
+			return sum;
+		});
+		runner.run("datetime_t::sNowUtc", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t::sNowUtc().ticks();
+			return sum;
+		});
+		runner.runScaling("datetime_t::sNowUtc (threads)", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t::sNowUtc().ticks();
+			return sum;
+		});
+		runner.run("datetime_t::sToday", [](u32, u64 n) {
+			u64 sum = 0;
+			for (u64 i = 0; i < n; ++i)
+				sum += datetime_t::sToday().ticks();
+			return sum;
+		});
+	}
+}
+
+void gBenchApi(bench_runner_t &runner)
+{
+	sBenchTime(runner);
+	sBenchTimer(runner);
+	sBenchFrameRate(runner);
+	sBenchTimeSpan(runner);
+	sBenchDateTime(runner);
+}
@@ -0,0 +1,82 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_asof_join.h"
+
+#include "bench_harness.h"
+
+using namespace xcore;
+
+namespace
+{
+	inline u32 sNextRandom(u32 &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	const u32 sNumTrades = 2 * 1024 * 1024;
+	const u32 sNumQuotes = 8 * 1024 * 1024;
+
+	// Sorted times from the market open, on average 'gap' ticks apart
+	void sFill(datetime_t *times, u32 count, u32 gap, u32 seed)
+	{
+		u32 rnd = seed;
+		u64 t = datetime_t(2024, 5, 17, 9, 30, 0).ticks();
+		for (u32 i = 0; i < count; ++i)
+		{
+			t += sNextRandom(rnd) % (2 * gap);
+			times[i] = datetime_t(t);
+		}
+	}
+
+	u64 sJoin(const datetime_t *trades, u32 num_trades, const datetime_t *quotes, asof_pair_t *pairs, const asof_options_t &options, u64 n)
+	{
+		// One operation is one left row
+		u64 checksum = 0;
+		while (n > 0)
+		{
+			u32 const count = n < num_trades ? (u32)n : num_trades;
+			u32 const joined = x_AsOfJoin(trades, count, quotes, sNumQuotes, pairs, options);
+			checksum += joined > 0 ? pairs[joined - 1].mRight : 0;
+			n -= count;
+		}
+		return checksum;
+	}
+}
+
+void gBenchAsOfJoin(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("x_asof_join.h"))
+		return;
+
+	datetime_t *trades = (datetime_t *)allocator->allocate(sNumTrades * (u32)sizeof(datetime_t), 64);
+	datetime_t *quotes = (datetime_t *)allocator->allocate(sNumQuotes * (u32)sizeof(datetime_t), 64);
+	asof_pair_t *pairs = (asof_pair_t *)allocator->allocate(sNumTrades * (u32)sizeof(asof_pair_t), 64);
+
+	// 4 quotes per trade, a trade every ~2 ms
+	sFill(trades, sNumTrades, 20000, 0x9E3779B9);
+	sFill(quotes, sNumQuotes, 5000, 0x12345678);
+
+	asof_options_t options;
+	runner.run("merge, 4 quotes per trade", [&](u32, u64 n) { return sJoin(trades, sNumTrades, quotes, pairs, options, n); });
+
+	options.mTolerance = timespan_t::sFromMilliseconds(1);
+	runner.run("merge, 4 quotes per trade, 1 ms tolerance", [&](u32, u64 n) { return sJoin(trades, sNumTrades, quotes, pairs, options, n); });
+
+	options.mTolerance = timespan_t::sMaxValue;
+	options.mNumThreads = 0;
+	runner.run("partitioned, all hardware threads", [&](u32, u64 n) { return sJoin(trades, sNumTrades, quotes, pairs, options, n); });
+
+	// Sparse trades skip long runs of quotes
+	sFill(trades, sNumTrades / 64, 20000 * 64, 0x9E3779B9);
+	options.mNumThreads = 1;
+	runner.run("merge, 256 quotes per trade", [&](u32, u64 n) { return sJoin(trades, sNumTrades / 64, quotes, pairs, options, n); });
+
+	allocator->deallocate(pairs);
+	allocator->deallocate(quotes);
+	allocator->deallocate(trades);
+}
@@ -0,0 +1,128 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_delta_codec.h"
+
+#include "bench_harness.h"
+
+#include <stdio.h>
+
+using namespace xcore;
+
+namespace
+{
+	inline u32 sNextRandom(u32 &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	const u32 sNumValues = 64 * 1024;
+
+	// Samples every 1 ms from a clock with 1 ns resolution, no jitter
+	void sFixedInterval(tick_t *values)
+	{
+		for (u32 i = 0; i < sNumValues; ++i)
+			values[i] = X_CONSTANT_64(1700000000000000000) + (tick_t)i * 1000000;
+	}
+
+	// Samples every 1 ms with up to 50 us of scheduling jitter
+	void sJittered(tick_t *values)
+	{
+		u32 rnd = 0x9E3779B9;
+		for (u32 i = 0; i < sNumValues; ++i)
+			values[i] = X_CONSTANT_64(1700000000000000000) + (tick_t)i * 1000000 + (tick_t)(sNextRandom(rnd) % 50000);
+	}
+
+	// Events that arrive in bursts of 1 to 64 a few us apart, with idle gaps of up to 100 ms
+	void sBursty(tick_t *values)
+	{
+		u32 rnd = 0x9E3779B9;
+		tick_t t = X_CONSTANT_64(1700000000000000000);
+		u32 burst = 0;
+		for (u32 i = 0; i < sNumValues; ++i)
+		{
+			if (burst == 0)
+			{
+				burst = 1 + (sNextRandom(rnd) & 63);
+				t += sNextRandom(rnd) % 100000000;
+			}
+			else
+			{
+				t += 1000 + (sNextRandom(rnd) & 4095);
+			}
+			--burst;
+			values[i] = t;
+		}
+	}
+
+	void sPattern(bench_runner_t &runner, const char *name, const char *encode_name, const char *decode_name, tick_t *values, tick_t *decoded, u8 *buffer, u32 capacity)
+	{
+		delta_encoder_t encoder;
+		encoder.init(buffer, capacity);
+		encoder.write(values, sNumValues);
+		u32 const bytes = encoder.finish();
+
+		// One operation is one value
+		runner.run(encode_name, [&](u32, u64 n) {
+			u64 checksum = 0;
+			while (n > 0)
+			{
+				u32 const count = n < sNumValues ? (u32)n : sNumValues;
+				delta_encoder_t e;
+				e.init(buffer, capacity);
+				e.write(values, count);
+				checksum += e.finish();
+				n -= count;
+			}
+			return checksum;
+		});
+
+		bool const ran = runner.run(decode_name, [&](u32, u64 n) {
+			u64 checksum = 0;
+			while (n > 0)
+			{
+				u32 const count = n < sNumValues ? (u32)n : sNumValues;
+				delta_decoder_t d;
+				d.init(buffer, bytes, count);
+				d.read(decoded, count);
+				checksum += (u64)decoded[count - 1];
+				n -= count;
+			}
+			return checksum;
+		});
+
+		f64 const bits = (f64)bytes * 8.0 / (f64)sNumValues;
+		printf("    %s: %.2f bits per value, ratio %.1f:1", name, bits, 64.0 / bits);
+		if (ran)
+		{
+			bench_result_t const &result = runner.getResult(runner.getNumResults() - 1);
+			printf(", decode %.2f GB/s", (f64)sizeof(tick_t) / result.mNsPerOp);
+		}
+		printf("\n");
+	}
+}
+
+void gBenchDeltaCodec(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("x_delta_codec.h"))
+		return;
+
+	u32 const capacity = sNumValues * 10;
+	tick_t *values = (tick_t *)allocator->allocate(sNumValues * (u32)sizeof(tick_t), 8);
+	tick_t *decoded = (tick_t *)allocator->allocate(sNumValues * (u32)sizeof(tick_t), 8);
+	u8 *buffer = (u8 *)allocator->allocate(capacity, 8);
+
+	sFixedInterval(values);
+	sPattern(runner, "fixed 1 ms", "encode, fixed 1 ms", "decode, fixed 1 ms", values, decoded, buffer, capacity);
+	sJittered(values);
+	sPattern(runner, "jittered 1 ms", "encode, jittered 1 ms", "decode, jittered 1 ms", values, decoded, buffer, capacity);
+	sBursty(values);
+	sPattern(runner, "bursty", "encode, bursty", "decode, bursty", values, decoded, buffer, capacity);
+
+	allocator->deallocate(buffer);
+	allocator->deallocate(decoded);
+	allocator->deallocate(values);
+}
@@ -0,0 +1,327 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_running_stats.h"
+
+#include "bench_harness.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace xcore
+{
+	bench_config_t::bench_config_t()
+		: mWarmupMs(50)
+		, mRepetitions(15)
+		, mMinSampleUs(2000)
+		, mOutlierMads(3.0)
+		, mMaxThreads(0)
+		, mFilter(NULL)
+	{
+	}
+
+	f64			x_BenchStudentT(u32 df)
+	{
+		static const f64 sTable[] = {
+			12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+		};
+		if (df == 0)
+			return 0.0;
+		if (df <= 30)
+			return sTable[df - 1];
+		if (df <= 40)
+			return 2.021;
+		if (df <= 60)
+			return 2.000;
+		if (df <= 120)
+			return 1.980;
+		return 1.960;
+	}
+
+	namespace xbench
+	{
+		static void		sSort(f64* values, u32 count)
+		{
+			for (u32 i = 1; i < count; ++i)
+			{
+				f64 const v = values[i];
+				u32 j = i;
+				for (; j > 0 && values[j - 1] > v; --j)
+					values[j] = values[j - 1];
+				values[j] = v;
+			}
+		}
+
+		static f64		sMedian(const f64* sorted, u32 count)
+		{
+			if ((count & 1) == 1)
+				return sorted[count / 2];
+			return 0.5 * (sorted[count / 2 - 1] + sorted[count / 2]);
+		}
+
+		static bool		sContains(const char* str, const char* pattern)
+		{
+			for (; *str != '\0'; ++str)
+			{
+				const char* a = str;
+				const char* b = pattern;
+				while (*a != '\0' && *a == *b)
+				{
+					++a;
+					++b;
+				}
+				if (*b == '\0')
+					return true;
+			}
+			return *pattern == '\0';
+		}
+	}
+
+	bench_runner_t::bench_runner_t()
+		: mAllocator(NULL)
+		, mGroup("")
+		, mResults(NULL)
+		, mNumResults(0)
+		, mMaxResults(0)
+		, mSamples(NULL)
+	{
+	}
+
+	bench_runner_t::~bench_runner_t()
+	{
+		ASSERTS(mAllocator == NULL, "bench_runner_t: exit() was not called");
+	}
+
+	void		bench_runner_t::init(alloc_t* allocator, const bench_config_t& config)
+	{
+		mAllocator = allocator;
+		mConfig = config;
+		if (mConfig.mRepetitions == 0)
+			mConfig.mRepetitions = 1;
+		if (mConfig.mMaxThreads == 0)
+			mConfig.mMaxThreads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+		mGroup = "";
+		mNumResults = 0;
+		mMaxResults = 64;
+		mResults = (bench_result_t*)allocator->allocate(mMaxResults * (u32)sizeof(bench_result_t), sizeof(void*));
+		mSamples = (f64*)allocator->allocate(mConfig.mRepetitions * (u32)sizeof(f64), sizeof(f64));
+	}
+
+	void		bench_runner_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		mAllocator->deallocate(mResults);
+		mAllocator->deallocate(mSamples);
+		mResults = NULL;
+		mSamples = NULL;
+		mNumResults = 0;
+		mMaxResults = 0;
+		mAllocator = NULL;
+	}
+
+	bool		bench_runner_t::group(const char* name)
+	{
+		mGroup = name;
+		if (mConfig.mFilter != NULL && !xbench::sContains(name, mConfig.mFilter))
+			return false;
+		printf("%s\n", name);
+		return true;
+	}
+
+	bool		bench_runner_t::selected(const char* name) const
+	{
+		if (mConfig.mFilter == NULL)
+			return true;
+		return xbench::sContains(mGroup, mConfig.mFilter) || xbench::sContains(name, mConfig.mFilter);
+	}
+
+	bench_result_t&	bench_runner_t::push()
+	{
+		if (mNumResults == mMaxResults)
+		{
+			bench_result_t* results = (bench_result_t*)mAllocator->allocate(2 * mMaxResults * (u32)sizeof(bench_result_t), sizeof(void*));
+			for (u32 i = 0; i < mNumResults; ++i)
+				results[i] = mResults[i];
+			mAllocator->deallocate(mResults);
+			mResults = results;
+			mMaxResults *= 2;
+		}
+		return mResults[mNumResults++];
+	}
+
+	// Double the number of iterations until one sample takes long enough to
+	// make the resolution of the clock and the call overhead irrelevant.
+	u64			bench_runner_t::calibrate(bench_fn_t fn, void* user)
+	{
+		tick_t const target = x_MicrosecondsToTicks((f64)mConfig.mMinSampleUs);
+		u64 iterations = 1;
+		while (true)
+		{
+			tick_t const start = x_GetTime();
+			fn(user, 0, iterations);
+			tick_t const elapsed = x_GetTime() - start;
+			if (elapsed >= target || iterations >= (X_CONSTANT_64(1) << 40))
+				break;
+			// Aim directly at the target once the measurement is meaningful
+			if (elapsed > target / 16)
+				iterations = (u64)((f64)iterations * (f64)target / (f64)elapsed) + 1;
+			else
+				iterations *= 2;
+		}
+		return iterations;
+	}
+
+	// A threaded sample lasts as long as its slowest thread
+	tick_t		bench_runner_t::sample(bench_fn_t fn, void* user, u32 threads, u64 iterations, u64& checksum)
+	{
+		if (threads <= 1)
+		{
+			tick_t const start = x_GetTime();
+			checksum += fn(user, 0, iterations);
+			return x_GetTime() - start;
+		}
+
+		std::atomic<u32> ready(0);
+		std::vector<tick_t> elapsed(threads, 0);
+		std::vector<u64> sums(threads, 0);
+		std::vector<std::thread> workers;
+		for (u32 t = 0; t < threads; ++t)
+		{
+			workers.push_back(std::thread([&, t]() {
+				ready.fetch_add(1, std::memory_order_acq_rel);
+				while (ready.load(std::memory_order_acquire) < threads)
+				{
+				}
+				tick_t const start = x_GetTime();
+				sums[t] = fn(user, t, iterations);
+				elapsed[t] = x_GetTime() - start;
+			}));
+		}
+
+		tick_t longest = 0;
+		for (u32 t = 0; t < threads; ++t)
+		{
+			workers[t].join();
+			checksum += sums[t];
+			if (elapsed[t] > longest)
+				longest = elapsed[t];
+		}
+		return longest;
+	}
+
+	bool		bench_runner_t::run(const char* name, bench_fn_t fn, void* user, u32 threads)
+	{
+		if (!selected(name))
+			return false;
+		if (threads == 0)
+			threads = 1;
+
+		u64 const iterations = calibrate(fn, user);
+
+		u64 checksum = 0;
+		tick_t const warmup = x_MillisecondsToTicks((f64)mConfig.mWarmupMs);
+		tick_t const warmup_start = x_GetTime();
+		while ((x_GetTime() - warmup_start) < warmup)
+			sample(fn, user, threads, iterations, checksum);
+
+		u32 const n = mConfig.mRepetitions;
+		for (u32 i = 0; i < n; ++i)
+			mSamples[i] = x_TicksToUs(sample(fn, user, threads, iterations, checksum)) * 1000.0 / (f64)iterations;
+
+		// Reject samples that are far from the median, the deviation is the scaled
+		// median absolute deviation which is not influenced by the outliers.
+		xbench::sSort(mSamples, n);
+		f64 const median = xbench::sMedian(mSamples, n);
+
+		f64* deviations = (f64*)mAllocator->allocate(n * (u32)sizeof(f64), sizeof(f64));
+		for (u32 i = 0; i < n; ++i)
+			deviations[i] = mSamples[i] > median ? mSamples[i] - median : median - mSamples[i];
+		xbench::sSort(deviations, n);
+		f64 const mad = 1.4826 * xbench::sMedian(deviations, n);
+		mAllocator->deallocate(deviations);
+
+		running_stats_t stats;
+		u32 rejected = 0;
+		for (u32 i = 0; i < n; ++i)
+		{
+			f64 const d = mSamples[i] > median ? mSamples[i] - median : median - mSamples[i];
+			if (mad > 0.0 && d > mConfig.mOutlierMads * mad)
+				rejected++;
+			else
+				stats.add(mSamples[i]);
+		}
+
+		bench_result_t& result = push();
+		result.mGroup = mGroup;
+		result.mName = name;
+		result.mThreads = threads;
+		result.mIterations = iterations;
+		result.mSamples = n;
+		result.mRejected = rejected;
+		result.mNsPerOp = stats.mean();
+		result.mNsPerOpMedian = median;
+		result.mNsPerOpStdDev = stats.stddev();
+		result.mNsPerOpMin = stats.min();
+		result.mNsPerOpMax = stats.max();
+		f64 const margin = stats.count() > 1 ? x_BenchStudentT((u32)stats.count() - 1) * stats.stddev() / sqrt((f64)stats.count()) : 0.0;
+		result.mNsPerOpCiLow = stats.mean() - margin;
+		result.mNsPerOpCiHigh = stats.mean() + margin;
+		result.mOpsPerSec = stats.mean() > 0.0 ? (f64)threads * 1000000000.0 / stats.mean() : 0.0;
+		result.mChecksum = checksum;
+		print(result);
+		return true;
+	}
+
+	void		bench_runner_t::runScaling(const char* name, bench_fn_t fn, void* user)
+	{
+		f64 single = 0.0;
+		for (u32 threads = 1; threads <= mConfig.mMaxThreads; threads *= 2)
+		{
+			if (!run(name, fn, user, threads))
+				return;
+			f64 const rate = mResults[mNumResults - 1].mOpsPerSec;
+			if (threads == 1)
+				single = rate;
+			else if (single > 0.0)
+				printf("  %-40s %24s scaling efficiency %5.1f%%\n", "", "", 100.0 * rate / (single * threads));
+		}
+	}
+
+	void		bench_runner_t::add(const char* name, u32 threads, u64 iterations, tick_t elapsed, u64 checksum)
+	{
+		if (!selected(name))
+			return;
+
+		f64 const ns = iterations > 0 ? x_TicksToUs(elapsed) * 1000.0 / (f64)iterations : 0.0;
+		bench_result_t& result = push();
+		result.mGroup = mGroup;
+		result.mName = name;
+		result.mThreads = threads;
+		result.mIterations = iterations;
+		result.mSamples = 1;
+		result.mRejected = 0;
+		result.mNsPerOp = ns;
+		result.mNsPerOpMedian = ns;
+		result.mNsPerOpStdDev = 0.0;
+		result.mNsPerOpMin = ns;
+		result.mNsPerOpMax = ns;
+		result.mNsPerOpCiLow = ns;
+		result.mNsPerOpCiHigh = ns;
+		result.mOpsPerSec = ns > 0.0 ? (f64)threads * 1000000000.0 / ns : 0.0;
+		result.mChecksum = checksum;
+		print(result);
+	}
+
+	void		bench_runner_t::print(const bench_result_t& r) const
+	{
+		printf("  %-40s %3u thr %10.2f ns/op (+/- %6.2f, median %10.2f) %14.0f ops/s  %2u/%2u rejected\n", r.mName, r.mThreads, r.mNsPerOp, r.mNsPerOpStdDev,
+			   r.mNsPerOpMedian, r.mOpsPerSec, r.mRejected, r.mSamples);
+	}
+};
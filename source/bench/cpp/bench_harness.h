@@ -0,0 +1,140 @@
+#ifndef __X_TIME_BENCH_HARNESS_H__
+#define __X_TIME_BENCH_HARNESS_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A small statistical benchmark harness.
+     *
+     *      A benchmark is a function that runs 'iterations' operations and returns a
+     *      checksum (so the work can not be optimized away). The harness finds the
+     *      number of iterations that makes one sample last at least mMinSampleUs,
+     *      warms up for mWarmupMs, then takes mRepetitions samples. Samples that are
+     *      further than mOutlierMads median absolute deviations from the median are
+     *      rejected, the statistics are computed over the remaining samples.
+     *      The result carries the 95% confidence interval of the mean so results of
+     *      different runs can be compared (see bench_report.h).
+     *
+     *      runScaling() runs the same benchmark on 1, 2, 4 .. mMaxThreads threads at
+     *      the same time, every thread runs the calibrated number of iterations.
+     *
+     *  Example:
+     * <CODE>
+     *       bench_runner_t runner;
+     *       runner.init(allocator, bench_config_t());
+     *       runner.run("x_GetTime", [](u32 thread, u64 n) {
+     *           u64 sum = 0;
+     *           for (u64 i = 0; i < n; ++i)
+     *               sum += x_GetTime();
+     *           return sum;
+     *       });
+     *       runner.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    struct bench_config_t
+    {
+        bench_config_t();
+
+        u32 mWarmupMs;
+        u32 mRepetitions;
+        u32 mMinSampleUs;
+        f64 mOutlierMads;
+        u32 mMaxThreads;
+        const char *mFilter; ///< Only run benchmarks whose name contains this, NULL runs all
+    };
+
+    struct bench_result_t
+    {
+        const char *mGroup;
+        const char *mName;
+        u32 mThreads;
+        u64 mIterations; ///< Per sample and per thread
+        u32 mSamples;
+        u32 mRejected;
+        f64 mNsPerOp; ///< Mean of the accepted samples
+        f64 mNsPerOpMedian;
+        f64 mNsPerOpStdDev;
+        f64 mNsPerOpMin;
+        f64 mNsPerOpMax;
+        f64 mNsPerOpCiLow; ///< 95% confidence interval of the mean
+        f64 mNsPerOpCiHigh;
+        f64 mOpsPerSec; ///< Of all threads together
+        u64 mChecksum;
+    };
+
+    ///< Two-sided 95% quantile of the Student t distribution
+    extern f64 x_BenchStudentT(u32 degrees_of_freedom);
+
+    typedef u64 (*bench_fn_t)(void *user, u32 thread, u64 iterations);
+
+    class bench_runner_t
+    {
+    public:
+        bench_runner_t();
+        ~bench_runner_t();
+
+        void init(alloc_t *allocator, const bench_config_t &config);
+        void exit();
+
+        const bench_config_t &getConfig() const { return mConfig; }
+
+        ///< Benchmarks that follow are reported under this group, returns false when the filter excludes it
+        bool group(const char *name);
+
+        bool run(const char *name, bench_fn_t fn, void *user, u32 threads = 1);
+        void runScaling(const char *name, bench_fn_t fn, void *user);
+
+        template <typename F>
+        bool run(const char *name, F f, u32 threads = 1)
+        {
+            return run(name, &sCall<F>, &f, threads);
+        }
+
+        template <typename F>
+        void runScaling(const char *name, F f)
+        {
+            runScaling(name, &sCall<F>, &f);
+        }
+
+        ///< Report a result that was measured outside of the harness
+        void add(const char *name, u32 threads, u64 iterations, tick_t elapsed, u64 checksum);
+
+        u32 getNumResults() const { return mNumResults; }
+        const bench_result_t &getResult(u32 index) const { return mResults[index]; }
+
+    private:
+        template <typename F>
+        static u64 sCall(void *user, u32 thread, u64 iterations)
+        {
+            return (*(F *)user)(thread, iterations);
+        }
+
+        bool selected(const char *name) const;
+        u64 calibrate(bench_fn_t fn, void *user);
+        tick_t sample(bench_fn_t fn, void *user, u32 threads, u64 iterations, u64 &checksum);
+        bench_result_t &push();
+        void print(const bench_result_t &result) const;
+
+        alloc_t *mAllocator;
+        bench_config_t mConfig;
+        const char *mGroup;
+        bench_result_t *mResults;
+        u32 mNumResults;
+        u32 mMaxResults;
+        f64 *mSamples;
+    };
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,116 @@
+#include "xbase/x_base.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+
+#include "bench_harness.h"
+#include "bench_report.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace xcore;
+
+extern void gBenchApi(bench_runner_t &runner);
+extern void gBenchRadixHeap(alloc_t *allocator, bench_runner_t &runner);
+extern void gBenchScheduler(alloc_t *allocator, bench_runner_t &runner);
+extern void gBenchStopwatchPool(alloc_t *allocator, bench_runner_t &runner);
+extern void gBenchDeltaCodec(alloc_t *allocator, bench_runner_t &runner);
+extern void gBenchPackedTicks(alloc_t *allocator, bench_runner_t &runner);
+extern void gBenchTimeSearch(alloc_t *allocator, bench_runner_t &runner);
+extern void gBenchAsOfJoin(alloc_t *allocator, bench_runner_t &runner);
+
+static void sUsage()
+{
+	printf("usage: xtime_bench [--filter <text>] [--reps <n>] [--warmup <ms>] [--sample <us>] [--threads <n>] [--outlier <mads>]\n");
+	printf("                   [--json <file>] [--baseline <file>] [--threshold <percent>]\n");
+}
+
+int main(int argc, char **argv)
+{
+	bench_config_t config;
+	const char *json = NULL;
+	const char *baseline_file = NULL;
+	f64 threshold = 5.0;
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *arg = argv[i];
+		const char *value = (i + 1) < argc ? argv[i + 1] : NULL;
+		if (value != NULL && strcmp(arg, "--filter") == 0)
+			config.mFilter = value;
+		else if (value != NULL && strcmp(arg, "--reps") == 0)
+			config.mRepetitions = (u32)atoi(value);
+		else if (value != NULL && strcmp(arg, "--warmup") == 0)
+			config.mWarmupMs = (u32)atoi(value);
+		else if (value != NULL && strcmp(arg, "--sample") == 0)
+			config.mMinSampleUs = (u32)atoi(value);
+		else if (value != NULL && strcmp(arg, "--threads") == 0)
+			config.mMaxThreads = (u32)atoi(value);
+		else if (value != NULL && strcmp(arg, "--outlier") == 0)
+			config.mOutlierMads = atof(value);
+		else if (value != NULL && strcmp(arg, "--json") == 0)
+			json = value;
+		else if (value != NULL && strcmp(arg, "--baseline") == 0)
+			baseline_file = value;
+		else if (value != NULL && strcmp(arg, "--threshold") == 0)
+			threshold = atof(value);
+		else
+		{
+			sUsage();
+			return 1;
+		}
+		++i;
+	}
+
+	xbase::x_Init();
+	xtime::x_Init();
+
+	alloc_t *allocator = alloc_t::get_system();
+
+	// Load the baseline before running so that a bad file fails early
+	bench_baseline_t baseline;
+	baseline.init(allocator);
+	if (baseline_file != NULL && !baseline.load(baseline_file))
+	{
+		printf("error: unable to read baseline '%s'\n", baseline_file);
+		baseline.exit();
+		xtime::x_Exit();
+		xbase::x_Exit();
+		return 1;
+	}
+
+	bench_environment_t env;
+	env.detect();
+
+	bench_runner_t runner;
+	runner.init(allocator, config);
+
+	printf("xtime benchmarks, %u repetitions, up to %u threads\n", runner.getConfig().mRepetitions, runner.getConfig().mMaxThreads);
+	printf("%s, %u hardware threads, %s\n", env.mCpu, env.mHardwareThreads, env.mPlatform);
+	printf("%s, %lld ticks per second, resolution %.1f ns, overhead %.1f ns\n", env.mClockSource, (long long)env.mTicksPerSecond, env.mClockResolutionNs,
+		   env.mClockOverheadNs);
+	gBenchApi(runner);
+	gBenchRadixHeap(allocator, runner);
+	gBenchScheduler(allocator, runner);
+	gBenchStopwatchPool(allocator, runner);
+	gBenchDeltaCodec(allocator, runner);
+	gBenchPackedTicks(allocator, runner);
+	gBenchTimeSearch(allocator, runner);
+	gBenchAsOfJoin(allocator, runner);
+
+	int exit_code = 0;
+	if (json != NULL && !x_BenchWriteJson(json, env, runner))
+	{
+		printf("error: unable to write '%s'\n", json);
+		exit_code = 1;
+	}
+	if (baseline_file != NULL && x_BenchCompare(runner, baseline, threshold / 100.0) > 0)
+		exit_code = 2;
+
+	baseline.exit();
+	runner.exit();
+	xtime::x_Exit();
+	xbase::x_Exit();
+	return exit_code;
+}
@@ -0,0 +1,110 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_packed_ticks.h"
+
+#include "bench_harness.h"
+
+#include <stdio.h>
+
+using namespace xcore;
+
+namespace
+{
+	inline u32 sNextRandom(u32 &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	const u32 sNumValues = 1024 * 1024;
+
+	// datetime_t ticks (100 ns) sampled every 1 ms with up to 50 us of jitter
+	void sFill(tick_t *values)
+	{
+		u32 rnd = 0x9E3779B9;
+		tick_t const start = (tick_t)datetime_t(2024, 1, 1).ticks();
+		for (u32 i = 0; i < sNumValues; ++i)
+			values[i] = start + (tick_t)i * 10000 + (tick_t)(sNextRandom(rnd) % 500);
+	}
+}
+
+void gBenchPackedTicks(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("x_packed_ticks.h"))
+		return;
+
+	tick_t *values = (tick_t *)allocator->allocate(sNumValues * (u32)sizeof(tick_t), 16);
+	sFill(values);
+
+	packed_ticks_t column;
+	column.init(allocator, sNumValues / packed_ticks_t::BLOCK_SIZE);
+	column.append(values, sNumValues);
+	u32 const num_blocks = column.getNumBlocks();
+
+	// One operation is one value
+	bool const decoded = runner.run("decode all blocks", [&](u32, u64 n) {
+		tick_t out[packed_ticks_t::BLOCK_SIZE];
+		u64 checksum = 0;
+		u32 block = 0;
+		for (u64 i = 0; i < n; i += packed_ticks_t::BLOCK_SIZE)
+		{
+			column.decode(block, out);
+			checksum += (u64)out[block & (packed_ticks_t::BLOCK_SIZE - 1)];
+			block = block + 1 < num_blocks ? block + 1 : 0;
+		}
+		return checksum;
+	});
+	f64 decode_ns = decoded ? runner.getResult(runner.getNumResults() - 1).mNsPerOp : 0.0;
+
+	runner.run("get, random index", [&](u32, u64 n) {
+		u32 rnd = 0x12345678;
+		u64 checksum = 0;
+		for (u64 i = 0; i < n; ++i)
+			checksum += (u64)column.get(sNextRandom(rnd) & (sNumValues - 1));
+		return checksum;
+	});
+
+	// One operation is one scan of the whole column
+	runner.run("count, 1% of the range", [&](u32, u64 n) {
+		u64 checksum = 0;
+		tick_t const from = values[sNumValues / 2];
+		tick_t const until = values[sNumValues / 2 + sNumValues / 100];
+		for (u64 i = 0; i < n; ++i)
+			checksum += column.count(from, until);
+		return checksum;
+	});
+
+	runner.run("count, 50% of the range", [&](u32, u64 n) {
+		u64 checksum = 0;
+		tick_t const from = values[sNumValues / 4];
+		tick_t const until = values[sNumValues / 4 + sNumValues / 2];
+		for (u64 i = 0; i < n; ++i)
+			checksum += column.count(from, until);
+		return checksum;
+	});
+
+	runner.run("count, 50% of the range, raw array", [&](u32, u64 n) {
+		u64 checksum = 0;
+		tick_t const from = values[sNumValues / 4];
+		tick_t const until = values[sNumValues / 4 + sNumValues / 2];
+		for (u64 i = 0; i < n; ++i)
+		{
+			for (u32 j = 0; j < sNumValues; ++j)
+				checksum += (values[j] >= from && values[j] < until) ? 1 : 0;
+		}
+		return checksum;
+	});
+
+	f64 const bits = (f64)column.getNumBytes() * 8.0 / (f64)sNumValues;
+	printf("    1 ms jittered samples: %.2f bits per value, ratio %.1f:1", bits, 64.0 / bits);
+	if (decoded)
+		printf(", decode %.2f GB/s", (f64)sizeof(tick_t) / decode_ns);
+	printf("\n");
+
+	column.exit();
+	allocator->deallocate(values);
+}
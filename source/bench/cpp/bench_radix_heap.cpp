@@ -0,0 +1,159 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_radix_heap.h"
+
+#include "bench_harness.h"
+
+#include <stdio.h>
+#include <queue>
+#include <vector>
+
+using namespace xcore;
+
+namespace
+{
+	struct event_t
+	{
+		u32 mId;
+		u32 mData;
+	};
+
+	struct queued_event_t
+	{
+		u64 mKey;
+		event_t mEvent;
+
+		bool operator<(const queued_event_t &other) const { return mKey > other.mKey; }
+	};
+
+	inline u32 sNextRandom(u32 &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	const u32 sNumEvents = 10 * 1000 * 1000;
+	const u32 sNumPending = 64 * 1024;
+
+	// 'Hold' model: keep a fixed number of pending events, every popped event
+	// schedules a new one a random delay after its own time.
+	u64 sHoldRadixHeap(alloc_t *allocator)
+	{
+		radix_heap_t<event_t> queue;
+		queue.init(allocator, 64);
+
+		u32 rnd = 0x9E3779B9;
+		for (u32 i = 0; i < sNumPending; ++i)
+		{
+			event_t e = { i, 0 };
+			queue.push(sNextRandom(rnd) & 0xFFFFF, e);
+		}
+
+		u64 checksum = 0;
+		for (u32 i = 0; i < sNumEvents; ++i)
+		{
+			u64 when = 0;
+			event_t e;
+			queue.pop(when, e);
+			checksum += when;
+			queue.push(when + (sNextRandom(rnd) & 0xFFFFF), e);
+		}
+		queue.exit();
+		return checksum;
+	}
+
+	u64 sHoldPriorityQueue()
+	{
+		std::priority_queue<queued_event_t> queue;
+
+		u32 rnd = 0x9E3779B9;
+		for (u32 i = 0; i < sNumPending; ++i)
+		{
+			queued_event_t e = { sNextRandom(rnd) & 0xFFFFF, { i, 0 } };
+			queue.push(e);
+		}
+
+		u64 checksum = 0;
+		for (u32 i = 0; i < sNumEvents; ++i)
+		{
+			queued_event_t e = queue.top();
+			queue.pop();
+			checksum += e.mKey;
+			e.mKey += sNextRandom(rnd) & 0xFFFFF;
+			queue.push(e);
+		}
+		return checksum;
+	}
+
+	// Bulk model: push all events with ascending-ish timestamps, then drain
+	u64 sBulkRadixHeap(alloc_t *allocator)
+	{
+		radix_heap_t<event_t> queue;
+		queue.init(allocator, 1024);
+
+		u32 rnd = 0x9E3779B9;
+		u64 base = 0;
+		for (u32 i = 0; i < sNumEvents; ++i)
+		{
+			base += sNextRandom(rnd) & 0xFF;
+			event_t e = { i, 0 };
+			queue.push(base + (sNextRandom(rnd) & 0xFFFF), e);
+		}
+
+		u64 checksum = 0;
+		u64 when = 0;
+		event_t e;
+		while (queue.pop(when, e))
+			checksum += when;
+		queue.exit();
+		return checksum;
+	}
+
+	u64 sBulkPriorityQueue()
+	{
+		std::priority_queue<queued_event_t> queue;
+
+		u32 rnd = 0x9E3779B9;
+		u64 base = 0;
+		for (u32 i = 0; i < sNumEvents; ++i)
+		{
+			base += sNextRandom(rnd) & 0xFF;
+			queued_event_t e = { base + (sNextRandom(rnd) & 0xFFFF), { i, 0 } };
+			queue.push(e);
+		}
+
+		u64 checksum = 0;
+		while (!queue.empty())
+		{
+			checksum += queue.top().mKey;
+			queue.pop();
+		}
+		return checksum;
+	}
+
+}
+
+void gBenchRadixHeap(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("radix_heap_t vs std::priority_queue"))
+		return;
+
+	tick_t t = x_GetTime();
+	u64 c = sHoldRadixHeap(allocator);
+	runner.add("hold, radix_heap_t", 1, sNumEvents, x_GetTime() - t, c);
+
+	t = x_GetTime();
+	c = sHoldPriorityQueue();
+	runner.add("hold, std::priority_queue", 1, sNumEvents, x_GetTime() - t, c);
+
+	t = x_GetTime();
+	c = sBulkRadixHeap(allocator);
+	runner.add("bulk, radix_heap_t", 1, sNumEvents, x_GetTime() - t, c);
+
+	t = x_GetTime();
+	c = sBulkPriorityQueue();
+	runner.add("bulk, std::priority_queue", 1, sNumEvents, x_GetTime() - t, c);
+}
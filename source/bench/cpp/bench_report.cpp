@@ -0,0 +1,636 @@
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+
+#include "bench_report.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(TARGET_MAC)
+#include <sys/sysctl.h>
+#endif
+
+namespace xcore
+{
+	namespace xbenchreport
+	{
+		static void		sCopy(char* dst, u32 size, const char* src)
+		{
+			u32 i = 0;
+			for (; (i + 1) < size && src[i] != '\0'; ++i)
+				dst[i] = src[i];
+			dst[i] = '\0';
+		}
+
+		static void		sCpuName(char* name, u32 size)
+		{
+			sCopy(name, size, "unknown");
+#if defined(_MSC_VER)
+			int regs[4];
+			__cpuid(regs, 0x80000000);
+			if ((u32)regs[0] >= 0x80000004)
+			{
+				char brand[49];
+				for (int i = 0; i < 3; ++i)
+				{
+					__cpuid(regs, 0x80000002 + i);
+					memcpy(brand + i * 16, regs, 16);
+				}
+				brand[48] = '\0';
+				sCopy(name, size, brand);
+			}
+#elif defined(__x86_64__) || defined(__i386__)
+			unsigned int regs[4];
+			if (__get_cpuid(0x80000000, &regs[0], &regs[1], &regs[2], &regs[3]) && regs[0] >= 0x80000004)
+			{
+				char brand[49];
+				for (unsigned int i = 0; i < 3; ++i)
+				{
+					__get_cpuid(0x80000002 + i, &regs[0], &regs[1], &regs[2], &regs[3]);
+					memcpy(brand + i * 16, regs, 16);
+				}
+				brand[48] = '\0';
+				sCopy(name, size, brand);
+			}
+#elif defined(TARGET_MAC)
+			size_t length = size;
+			if (sysctlbyname("machdep.cpu.brand_string", name, &length, NULL, 0) != 0)
+				sCopy(name, size, "unknown");
+#endif
+			// The brand string is padded with spaces
+			char* begin = name;
+			while (*begin == ' ')
+				++begin;
+			u32 length = (u32)strlen(begin);
+			while (length > 0 && begin[length - 1] == ' ')
+				--length;
+			memmove(name, begin, length);
+			name[length] = '\0';
+		}
+
+		static void		sWriteString(FILE* file, const char* str)
+		{
+			fputc('"', file);
+			for (; *str != '\0'; ++str)
+			{
+				char const c = *str;
+				if (c == '"' || c == '\\')
+					fprintf(file, "\\%c", c);
+				else if ((unsigned char)c < 0x20)
+					fprintf(file, "\\u%04x", (u32)(unsigned char)c);
+				else
+					fputc(c, file);
+			}
+			fputc('"', file);
+		}
+
+		/**
+		 * A minimal JSON reader, strings are decoded in place (the decoded string is
+		 * never longer than its encoding) so they can point into the text buffer.
+		 * Only \uXXXX escapes below 0x80 are decoded, which is all the writer emits.
+		 */
+		struct reader_t
+		{
+			char*		mCursor;
+			bool		mError;
+		};
+
+		static void		sSkipSpace(reader_t& r)
+		{
+			while (*r.mCursor == ' ' || *r.mCursor == '\t' || *r.mCursor == '\r' || *r.mCursor == '\n')
+				++r.mCursor;
+		}
+
+		static bool		sAccept(reader_t& r, char c)
+		{
+			sSkipSpace(r);
+			if (*r.mCursor != c)
+				return false;
+			++r.mCursor;
+			return true;
+		}
+
+		static void		sExpect(reader_t& r, char c)
+		{
+			if (!sAccept(r, c))
+				r.mError = true;
+		}
+
+		static const char*	sString(reader_t& r)
+		{
+			sSkipSpace(r);
+			if (r.mError || *r.mCursor != '"')
+			{
+				r.mError = true;
+				return "";
+			}
+			char* const str = ++r.mCursor;
+			char* dst = str;
+			while (*r.mCursor != '"')
+			{
+				char c = *r.mCursor++;
+				if (c == '\0')
+				{
+					r.mError = true;
+					return "";
+				}
+				if (c == '\\')
+				{
+					c = *r.mCursor++;
+					if (c == 'n')
+						c = '\n';
+					else if (c == 't')
+						c = '\t';
+					else if (c == 'r')
+						c = '\r';
+					else if (c == 'u')
+					{
+						char hex[5] = {0, 0, 0, 0, 0};
+						for (s32 i = 0; i < 4 && *r.mCursor != '\0'; ++i)
+							hex[i] = *r.mCursor++;
+						c = (char)strtol(hex, NULL, 16);
+					}
+					else if (c == '\0')
+					{
+						r.mError = true;
+						return "";
+					}
+				}
+				*dst++ = c;
+			}
+			++r.mCursor;
+			*dst = '\0';
+			return str;
+		}
+
+		static f64		sNumber(reader_t& r)
+		{
+			sSkipSpace(r);
+			char* end = r.mCursor;
+			f64 const value = strtod(r.mCursor, &end);
+			if (end == r.mCursor)
+				r.mError = true;
+			r.mCursor = end;
+			return value;
+		}
+
+		static void		sSkipValue(reader_t& r, s32 depth)
+		{
+			sSkipSpace(r);
+			if (r.mError || depth > 64)
+			{
+				r.mError = true;
+				return;
+			}
+			char const c = *r.mCursor;
+			if (c == '"')
+			{
+				sString(r);
+			}
+			else if (c == '{' || c == '[')
+			{
+				char const close = c == '{' ? '}' : ']';
+				++r.mCursor;
+				if (sAccept(r, close))
+					return;
+				do
+				{
+					if (c == '{')
+					{
+						sString(r);
+						sExpect(r, ':');
+					}
+					sSkipValue(r, depth + 1);
+				} while (!r.mError && sAccept(r, ','));
+				sExpect(r, close);
+			}
+			else if (strncmp(r.mCursor, "true", 4) == 0 || strncmp(r.mCursor, "null", 4) == 0)
+			{
+				r.mCursor += 4;
+			}
+			else if (strncmp(r.mCursor, "false", 5) == 0)
+			{
+				r.mCursor += 5;
+			}
+			else
+			{
+				sNumber(r);
+			}
+		}
+
+		static void		sReadEnvironment(reader_t& r, bench_environment_t& env)
+		{
+			sExpect(r, '{');
+			if (sAccept(r, '}'))
+				return;
+			do
+			{
+				const char* key = sString(r);
+				sExpect(r, ':');
+				if (strcmp(key, "platform") == 0)
+					sCopy(env.mPlatform, sizeof(env.mPlatform), sString(r));
+				else if (strcmp(key, "cpu") == 0)
+					sCopy(env.mCpu, sizeof(env.mCpu), sString(r));
+				else if (strcmp(key, "clock_source") == 0)
+					sCopy(env.mClockSource, sizeof(env.mClockSource), sString(r));
+				else if (strcmp(key, "date") == 0)
+					sCopy(env.mDate, sizeof(env.mDate), sString(r));
+				else if (strcmp(key, "hardware_threads") == 0)
+					env.mHardwareThreads = (u32)sNumber(r);
+				else if (strcmp(key, "ticks_per_second") == 0)
+					env.mTicksPerSecond = (s64)sNumber(r);
+				else if (strcmp(key, "clock_resolution_ns") == 0)
+					env.mClockResolutionNs = sNumber(r);
+				else if (strcmp(key, "clock_overhead_ns") == 0)
+					env.mClockOverheadNs = sNumber(r);
+				else
+					sSkipValue(r, 0);
+			} while (!r.mError && sAccept(r, ','));
+			sExpect(r, '}');
+		}
+
+		static void		sReadResult(reader_t& r, bench_result_t& result)
+		{
+			memset(&result, 0, sizeof(result));
+			result.mGroup = "";
+			result.mName = "";
+			sExpect(r, '{');
+			if (sAccept(r, '}'))
+				return;
+			do
+			{
+				const char* key = sString(r);
+				sExpect(r, ':');
+				if (strcmp(key, "group") == 0)
+					result.mGroup = sString(r);
+				else if (strcmp(key, "name") == 0)
+					result.mName = sString(r);
+				else if (strcmp(key, "threads") == 0)
+					result.mThreads = (u32)sNumber(r);
+				else if (strcmp(key, "iterations") == 0)
+					result.mIterations = (u64)sNumber(r);
+				else if (strcmp(key, "samples") == 0)
+					result.mSamples = (u32)sNumber(r);
+				else if (strcmp(key, "rejected") == 0)
+					result.mRejected = (u32)sNumber(r);
+				else if (strcmp(key, "ns_per_op") == 0)
+					result.mNsPerOp = sNumber(r);
+				else if (strcmp(key, "ns_per_op_median") == 0)
+					result.mNsPerOpMedian = sNumber(r);
+				else if (strcmp(key, "ns_per_op_stddev") == 0)
+					result.mNsPerOpStdDev = sNumber(r);
+				else if (strcmp(key, "ns_per_op_min") == 0)
+					result.mNsPerOpMin = sNumber(r);
+				else if (strcmp(key, "ns_per_op_max") == 0)
+					result.mNsPerOpMax = sNumber(r);
+				else if (strcmp(key, "ns_per_op_ci_low") == 0)
+					result.mNsPerOpCiLow = sNumber(r);
+				else if (strcmp(key, "ns_per_op_ci_high") == 0)
+					result.mNsPerOpCiHigh = sNumber(r);
+				else if (strcmp(key, "ops_per_sec") == 0)
+					result.mOpsPerSec = sNumber(r);
+				else
+					sSkipValue(r, 0);
+			} while (!r.mError && sAccept(r, ','));
+			sExpect(r, '}');
+		}
+
+		static const char*	sVerdict(bench_comparison_t::EVerdict verdict)
+		{
+			switch (verdict)
+			{
+			case bench_comparison_t::FASTER: return "faster";
+			case bench_comparison_t::SLOWER: return "SLOWER";
+			case bench_comparison_t::UNSURE: return "unsure";
+			case bench_comparison_t::NEW: return "new";
+			default: return "same";
+			}
+		}
+	}
+
+	bench_environment_t::bench_environment_t()
+		: mHardwareThreads(0)
+		, mTicksPerSecond(0)
+		, mClockResolutionNs(0.0)
+		, mClockOverheadNs(0.0)
+	{
+		mPlatform[0] = '\0';
+		mCpu[0] = '\0';
+		mClockSource[0] = '\0';
+		mDate[0] = '\0';
+	}
+
+	void		bench_environment_t::detect()
+	{
+#if defined(TARGET_MAC)
+		xbenchreport::sCopy(mPlatform, sizeof(mPlatform), "mac");
+		xbenchreport::sCopy(mClockSource, sizeof(mClockSource), "clock_gettime(CLOCK_MONOTONIC)");
+#elif defined(TARGET_PC)
+		xbenchreport::sCopy(mPlatform, sizeof(mPlatform), "win32");
+		xbenchreport::sCopy(mClockSource, sizeof(mClockSource), "QueryPerformanceCounter");
+#else
+		xbenchreport::sCopy(mPlatform, sizeof(mPlatform), "unknown");
+		xbenchreport::sCopy(mClockSource, sizeof(mClockSource), "unknown");
+#endif
+		xbenchreport::sCpuName(mCpu, sizeof(mCpu));
+		mHardwareThreads = std::thread::hardware_concurrency();
+		mTicksPerSecond = x_GetTicksPerSecond();
+
+		tick_t resolution = 0;
+		for (s32 i = 0; i < 1000; ++i)
+		{
+			tick_t const t0 = x_GetTime();
+			tick_t t1 = x_GetTime();
+			while (t1 == t0)
+				t1 = x_GetTime();
+			if (resolution == 0 || (t1 - t0) < resolution)
+				resolution = t1 - t0;
+		}
+		mClockResolutionNs = x_TicksToUs(resolution) * 1000.0;
+
+		s32 const calls = 100000;
+		tick_t const start = x_GetTime();
+		for (s32 i = 0; i < calls; ++i)
+			x_GetTime();
+		mClockOverheadNs = x_TicksToUs(x_GetTime() - start) * 1000.0 / (f64)calls;
+
+		datetime_t const now = datetime_t::sNowUtc();
+		snprintf(mDate, sizeof(mDate), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", now.year(), (s32)now.month(), now.day(), now.hour(), now.minute(), now.second(),
+				 now.millisecond());
+	}
+
+	bool		x_BenchWriteJson(const char* filename, const bench_environment_t& env, const bench_runner_t& runner)
+	{
+		FILE* file = fopen(filename, "wb");
+		if (file == NULL)
+			return false;
+
+		fprintf(file, "{\n  \"version\": 1,\n  \"environment\": {\n");
+		fprintf(file, "    \"platform\": ");
+		xbenchreport::sWriteString(file, env.mPlatform);
+		fprintf(file, ",\n    \"cpu\": ");
+		xbenchreport::sWriteString(file, env.mCpu);
+		fprintf(file, ",\n    \"clock_source\": ");
+		xbenchreport::sWriteString(file, env.mClockSource);
+		fprintf(file, ",\n    \"date\": ");
+		xbenchreport::sWriteString(file, env.mDate);
+		fprintf(file, ",\n    \"hardware_threads\": %u,\n    \"ticks_per_second\": %lld,\n", env.mHardwareThreads, (long long)env.mTicksPerSecond);
+		fprintf(file, "    \"clock_resolution_ns\": %.3f,\n    \"clock_overhead_ns\": %.3f\n  },\n", env.mClockResolutionNs, env.mClockOverheadNs);
+
+		bench_config_t const& config = runner.getConfig();
+		fprintf(file, "  \"config\": {\n    \"warmup_ms\": %u,\n    \"repetitions\": %u,\n    \"min_sample_us\": %u,\n", config.mWarmupMs, config.mRepetitions,
+				config.mMinSampleUs);
+		fprintf(file, "    \"outlier_mads\": %.3f,\n    \"max_threads\": %u\n  },\n", config.mOutlierMads, config.mMaxThreads);
+
+		fprintf(file, "  \"results\": [");
+		for (u32 i = 0; i < runner.getNumResults(); ++i)
+		{
+			bench_result_t const& r = runner.getResult(i);
+			fprintf(file, "%s\n    {\"group\": ", i == 0 ? "" : ",");
+			xbenchreport::sWriteString(file, r.mGroup);
+			fprintf(file, ", \"name\": ");
+			xbenchreport::sWriteString(file, r.mName);
+			fprintf(file, ", \"threads\": %u, \"iterations\": %llu, \"samples\": %u, \"rejected\": %u,", r.mThreads, (unsigned long long)r.mIterations, r.mSamples,
+					r.mRejected);
+			fprintf(file, " \"ns_per_op\": %.9g, \"ns_per_op_median\": %.9g, \"ns_per_op_stddev\": %.9g,", r.mNsPerOp, r.mNsPerOpMedian, r.mNsPerOpStdDev);
+			fprintf(file, " \"ns_per_op_min\": %.9g, \"ns_per_op_max\": %.9g,", r.mNsPerOpMin, r.mNsPerOpMax);
+			fprintf(file, " \"ns_per_op_ci_low\": %.9g, \"ns_per_op_ci_high\": %.9g,", r.mNsPerOpCiLow, r.mNsPerOpCiHigh);
+			fprintf(file, " \"ops_per_sec\": %.9g}", r.mOpsPerSec);
+		}
+		fprintf(file, "\n  ]\n}\n");
+
+		bool const ok = ferror(file) == 0;
+		fclose(file);
+		return ok;
+	}
+
+	bench_baseline_t::bench_baseline_t()
+		: mAllocator(NULL)
+		, mResults(NULL)
+		, mNumResults(0)
+		, mText(NULL)
+	{
+	}
+
+	bench_baseline_t::~bench_baseline_t()
+	{
+		ASSERTS(mAllocator == NULL, "bench_baseline_t: exit() was not called");
+	}
+
+	void		bench_baseline_t::init(alloc_t* allocator)
+	{
+		mAllocator = allocator;
+	}
+
+	void		bench_baseline_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		clear();
+		mAllocator = NULL;
+	}
+
+	void		bench_baseline_t::clear()
+	{
+		if (mResults != NULL)
+			mAllocator->deallocate(mResults);
+		if (mText != NULL)
+			mAllocator->deallocate(mText);
+		mResults = NULL;
+		mText = NULL;
+		mNumResults = 0;
+		mEnvironment = bench_environment_t();
+	}
+
+	bool		bench_baseline_t::load(const char* filename)
+	{
+		ASSERT(mAllocator != NULL);
+		clear();
+
+		FILE* file = fopen(filename, "rb");
+		if (file == NULL)
+			return false;
+		fseek(file, 0, SEEK_END);
+		long const size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (size <= 0)
+		{
+			fclose(file);
+			return false;
+		}
+		mText = (char*)mAllocator->allocate((u32)size + 1, sizeof(void*));
+		size_t const read = fread(mText, 1, (size_t)size, file);
+		fclose(file);
+		mText[read] = '\0';
+
+		// Every result is an object, the number of '{' is an upper bound
+		u32 max_results = 0;
+		for (const char* c = mText; *c != '\0'; ++c)
+			max_results += *c == '{' ? 1 : 0;
+		if (max_results > 0)
+			mResults = (bench_result_t*)mAllocator->allocate(max_results * (u32)sizeof(bench_result_t), sizeof(void*));
+
+		xbenchreport::reader_t r;
+		r.mCursor = mText;
+		r.mError = false;
+		bool has_results = false;
+		xbenchreport::sExpect(r, '{');
+		if (!xbenchreport::sAccept(r, '}'))
+		{
+			do
+			{
+				const char* key = xbenchreport::sString(r);
+				xbenchreport::sExpect(r, ':');
+				if (strcmp(key, "environment") == 0)
+				{
+					xbenchreport::sReadEnvironment(r, mEnvironment);
+				}
+				else if (strcmp(key, "results") == 0)
+				{
+					has_results = true;
+					xbenchreport::sExpect(r, '[');
+					if (xbenchreport::sAccept(r, ']'))
+						continue;
+					do
+					{
+						if (mNumResults == max_results)
+						{
+							r.mError = true;
+							break;
+						}
+						xbenchreport::sReadResult(r, mResults[mNumResults++]);
+					} while (!r.mError && xbenchreport::sAccept(r, ','));
+					xbenchreport::sExpect(r, ']');
+				}
+				else
+				{
+					xbenchreport::sSkipValue(r, 0);
+				}
+			} while (!r.mError && xbenchreport::sAccept(r, ','));
+			xbenchreport::sExpect(r, '}');
+		}
+
+		if (r.mError || !has_results)
+		{
+			clear();
+			return false;
+		}
+		return true;
+	}
+
+	const bench_result_t*	bench_baseline_t::find(const char* group, const char* name, u32 threads) const
+	{
+		for (u32 i = 0; i < mNumResults; ++i)
+		{
+			bench_result_t const& r = mResults[i];
+			if (r.mThreads == threads && strcmp(r.mName, name) == 0 && strcmp(r.mGroup, group) == 0)
+				return &r;
+		}
+		return NULL;
+	}
+
+	// Welch's t-interval of the difference of the means, it does not assume that
+	// both runs have the same variance or the same number of samples.
+	void		x_BenchCompare(const bench_result_t& baseline, const bench_result_t& current, f64 threshold, bench_comparison_t& outComparison)
+	{
+		outComparison.mVerdict = bench_comparison_t::SAME;
+		outComparison.mDelta = 0.0;
+		outComparison.mDeltaLow = 0.0;
+		outComparison.mDeltaHigh = 0.0;
+		outComparison.mUngated = false;
+		if (baseline.mNsPerOp <= 0.0)
+			return;
+
+		u32 const n1 = baseline.mSamples - baseline.mRejected;
+		u32 const n2 = current.mSamples - current.mRejected;
+		f64 const diff = current.mNsPerOp - baseline.mNsPerOp;
+		outComparison.mDelta = diff / baseline.mNsPerOp;
+
+		// Without repeated samples there is no interval, only the threshold can gate
+		if (n1 <= 1 || n2 <= 1)
+		{
+			outComparison.mUngated = true;
+			outComparison.mDeltaLow = outComparison.mDelta;
+			outComparison.mDeltaHigh = outComparison.mDelta;
+			if (outComparison.mDelta > threshold)
+				outComparison.mVerdict = bench_comparison_t::SLOWER;
+			else if (outComparison.mDelta < -threshold)
+				outComparison.mVerdict = bench_comparison_t::FASTER;
+			return;
+		}
+
+		f64 margin = 0.0;
+		f64 const v1 = baseline.mNsPerOpStdDev * baseline.mNsPerOpStdDev / (f64)n1;
+		f64 const v2 = current.mNsPerOpStdDev * current.mNsPerOpStdDev / (f64)n2;
+		f64 const se2 = v1 + v2;
+		if (se2 > 0.0)
+		{
+			f64 const df = se2 * se2 / (v1 * v1 / (f64)(n1 - 1) + v2 * v2 / (f64)(n2 - 1));
+			margin = x_BenchStudentT(df < 1.0 ? 1 : (u32)df) * sqrt(se2);
+		}
+		outComparison.mDeltaLow = (diff - margin) / baseline.mNsPerOp;
+		outComparison.mDeltaHigh = (diff + margin) / baseline.mNsPerOp;
+
+		if (outComparison.mDelta > threshold)
+			outComparison.mVerdict = outComparison.mDeltaLow > 0.0 ? bench_comparison_t::SLOWER : bench_comparison_t::UNSURE;
+		else if (outComparison.mDelta < -threshold && outComparison.mDeltaHigh < 0.0)
+			outComparison.mVerdict = bench_comparison_t::FASTER;
+	}
+
+	u32			x_BenchCompare(const bench_runner_t& runner, const bench_baseline_t& baseline, f64 threshold)
+	{
+		bench_environment_t const& env = baseline.getEnvironment();
+		printf("\ncomparing against baseline of %s (%s, %lld ticks per second), threshold %.1f%%\n", env.mDate, env.mCpu, (long long)env.mTicksPerSecond,
+			   threshold * 100.0);
+		if (env.mTicksPerSecond != x_GetTicksPerSecond())
+			printf("warning: the baseline was measured with a different time source\n");
+
+		u32 regressions = 0;
+		u32 ungated = 0;
+		const char* group = NULL;
+		for (u32 i = 0; i < runner.getNumResults(); ++i)
+		{
+			bench_result_t const& current = runner.getResult(i);
+			if (group == NULL || strcmp(group, current.mGroup) != 0)
+			{
+				group = current.mGroup;
+				printf("%s\n", group);
+			}
+
+			bench_comparison_t comparison;
+			const bench_result_t* base = baseline.find(current.mGroup, current.mName, current.mThreads);
+			if (base == NULL)
+			{
+				comparison.mVerdict = bench_comparison_t::NEW;
+				printf("  %-40s %3u thr %10s -> %10.2f ns/op %36s\n", current.mName, current.mThreads, "", current.mNsPerOp, xbenchreport::sVerdict(comparison.mVerdict));
+				continue;
+			}
+
+			x_BenchCompare(*base, current, threshold, comparison);
+			if (comparison.mVerdict == bench_comparison_t::SLOWER)
+				regressions++;
+			if (comparison.mUngated)
+			{
+				ungated++;
+				printf("  %-40s %3u thr %10.2f -> %10.2f ns/op %+7.1f%% %-20s %s\n", current.mName, current.mThreads, base->mNsPerOp, current.mNsPerOp,
+					   comparison.mDelta * 100.0, "[ungated]", xbenchreport::sVerdict(comparison.mVerdict));
+				continue;
+			}
+			printf("  %-40s %3u thr %10.2f -> %10.2f ns/op %+7.1f%% [%+7.1f%%, %+7.1f%%] %s\n", current.mName, current.mThreads, base->mNsPerOp, current.mNsPerOp,
+				   comparison.mDelta * 100.0, comparison.mDeltaLow * 100.0, comparison.mDeltaHigh * 100.0, xbenchreport::sVerdict(comparison.mVerdict));
+		}
+
+		printf("%u regression(s), %u single-sample result(s) gated on the threshold only\n", regressions, ungated);
+		return regressions;
+	}
+};
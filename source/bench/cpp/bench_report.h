@@ -0,0 +1,119 @@
+#ifndef __X_TIME_BENCH_REPORT_H__
+#define __X_TIME_BENCH_REPORT_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+#include "bench_harness.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Machine readable benchmark results and a baseline comparison.
+     *
+     *      x_BenchWriteJson() writes the environment, the configuration and all the
+     *      results of a bench_runner_t to a JSON file. Such a file can be loaded as
+     *      a bench_baseline_t and x_BenchCompare() compares a new run against it.
+     *
+     *      A benchmark is a regression when the 95% confidence interval of the
+     *      difference of the means (Welch) lies entirely above zero and the mean is
+     *      more than 'threshold' slower. Noise in either run widens the interval, so
+     *      an unstable benchmark is reported as 'unsure' instead of as a regression.
+     *      A result of a single sample (bench_runner_t::add) has no interval, it is
+     *      reported as ungated and is a regression when the mean alone is more than
+     *      'threshold' slower.
+     *
+     *  Example:
+     * <CODE>
+     *       bench_environment_t env;
+     *       env.detect();
+     *       x_BenchWriteJson("current.json", env, runner);
+     *
+     *       bench_baseline_t baseline;
+     *       baseline.init(allocator);
+     *       if (baseline.load("baseline.json"))
+     *           regressions = x_BenchCompare(runner, baseline, 0.05);
+     *       baseline.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    struct bench_environment_t
+    {
+        bench_environment_t();
+
+        ///< Fill in the properties of this machine and of the active time source
+        void detect();
+
+        char mPlatform[32];
+        char mCpu[128];
+        char mClockSource[64];
+        u32 mHardwareThreads;
+        s64 mTicksPerSecond;
+        f64 mClockResolutionNs; ///< Smallest observed non-zero difference of x_GetTime()
+        f64 mClockOverheadNs;   ///< Average cost of one x_GetTime() call
+        char mDate[32];         ///< UTC, ISO 8601
+    };
+
+    class bench_baseline_t
+    {
+    public:
+        bench_baseline_t();
+        ~bench_baseline_t();
+
+        void init(alloc_t *allocator);
+        void exit();
+
+        ///< Returns false when the file can not be read or is not a benchmark result file
+        bool load(const char *filename);
+
+        const bench_environment_t &getEnvironment() const { return mEnvironment; }
+
+        u32 getNumResults() const { return mNumResults; }
+        const bench_result_t &getResult(u32 index) const { return mResults[index]; }
+        const bench_result_t *find(const char *group, const char *name, u32 threads) const;
+
+    private:
+        void clear();
+
+        alloc_t *mAllocator;
+        bench_environment_t mEnvironment;
+        bench_result_t *mResults;
+        u32 mNumResults;
+        char *mText; ///< File contents, group and name strings point into it
+    };
+
+    struct bench_comparison_t
+    {
+        enum EVerdict
+        {
+            SAME = 0,
+            FASTER,
+            SLOWER,
+            UNSURE, ///< Slower by more than the threshold but not significant
+            NEW,    ///< Not in the baseline
+        };
+
+        EVerdict mVerdict;
+        f64 mDelta;     ///< Relative difference of the means, positive is slower
+        f64 mDeltaLow;  ///< 95% confidence interval of the relative difference
+        f64 mDeltaHigh;
+        bool mUngated;  ///< One of the results has a single sample, the verdict is based on the means only
+    };
+
+    extern bool x_BenchWriteJson(const char *filename, const bench_environment_t &env, const bench_runner_t &runner);
+
+    extern void x_BenchCompare(const bench_result_t &baseline, const bench_result_t &current, f64 threshold, bench_comparison_t &outComparison);
+
+    ///< Prints a comparison of every result of the runner, returns the number of regressions
+    extern u32 x_BenchCompare(const bench_runner_t &runner, const bench_baseline_t &baseline, f64 threshold);
+
+}; // namespace xcore
+
+#endif
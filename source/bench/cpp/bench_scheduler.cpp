@@ -0,0 +1,106 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_scheduler.h"
+
+#include "bench_harness.h"
+
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using namespace xcore;
+
+namespace
+{
+	// A periodic job that burns a small, fixed amount of cpu work
+	class work_job : public job_t
+	{
+	public:
+		work_job() : mSink(0) {}
+
+		virtual void	execute(tick_t now)
+		{
+			u64 v = (u64)now;
+			for (s32 i = 0; i < 256; ++i)
+				v = v * 6364136223846793005ULL + 1442695040888963407ULL;
+			mSink += v;
+		}
+
+		u64			mSink;
+	};
+
+	const u32 sJobsPerWorker = 64;
+	const f64 sRunTimeMs = 250.0;
+
+	const char *sNames[] = { "1 worker", "2 workers", "4 workers", "8 workers", "16 workers", "32 workers", "64 workers" };
+
+	f64 sRunScheduler(alloc_t *allocator, bench_runner_t &runner, const char *name, u32 num_threads)
+	{
+		scheduler_t scheduler;
+		scheduler.init(allocator, num_threads);
+
+		std::vector<work_job> jobs(num_threads * sJobsPerWorker);
+		tick_t const period = x_MicrosecondsToTicks(10.0);
+		tick_t const start = x_GetTime();
+		for (u32 i = 0; i < jobs.size(); ++i)
+			scheduler.schedulePeriodic(&jobs[i], start, period, (i & 1) ? job_t::FIXED_RATE : job_t::FIXED_DELAY, i % num_threads);
+
+		std::vector<std::thread> threads;
+		for (u32 i = 0; i < num_threads; ++i)
+			threads.push_back(std::thread(&scheduler_t::run, &scheduler, i));
+
+		tick_t const duration = x_MillisecondsToTicks(sRunTimeMs);
+		while ((x_GetTime() - start) < duration)
+			std::this_thread::yield();
+
+		scheduler.requestStop();
+		for (u32 i = 0; i < num_threads; ++i)
+			threads[i].join();
+		tick_t const elapsed = x_GetTime() - start;
+
+		u64 executed = 0, stolen = 0;
+		for (u32 i = 0; i < num_threads; ++i)
+		{
+			executed += scheduler.getNumExecuted(i);
+			stolen += scheduler.getNumStolen(i);
+		}
+
+		f64 max_lateness_us = 0.0, avg_lateness_us = 0.0;
+		for (u32 i = 0; i < jobs.size(); ++i)
+		{
+			f64 const l = x_TicksToUs(jobs[i].getMaxLateness());
+			if (l > max_lateness_us)
+				max_lateness_us = l;
+			avg_lateness_us += jobs[i].getAverageLatenessUs();
+		}
+		avg_lateness_us /= (f64)jobs.size();
+
+		for (u32 i = 0; i < jobs.size(); ++i)
+			jobs[i].cancel();
+		scheduler.exit();
+
+		f64 const jobs_per_sec = (f64)executed / x_TicksToSec(elapsed);
+		runner.add(name, num_threads, executed / num_threads, elapsed, executed);
+		printf("  %-40s stolen %5.2f%%  lateness avg %8.2f us  max %10.2f us\n", "",
+			   executed > 0 ? 100.0 * (f64)stolen / (f64)executed : 0.0, avg_lateness_us, max_lateness_us);
+		return jobs_per_sec;
+	}
+}
+
+void gBenchScheduler(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("scheduler_t scaling, 64 periodic jobs per worker"))
+		return;
+
+	f64 single = 0.0;
+	for (u32 i = 0, threads = 1; threads <= 64; ++i, threads *= 2)
+	{
+		f64 const rate = sRunScheduler(allocator, runner, sNames[i], threads);
+		if (threads == 1)
+			single = rate;
+		else if (single > 0.0)
+			printf("              scaling efficiency %5.1f%%\n", 100.0 * rate / (single * threads));
+	}
+	printf("  hardware threads: %u\n", std::thread::hardware_concurrency());
+}
@@ -0,0 +1,134 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timer.h"
+#include "xtime/x_stopwatch_pool.h"
+
+#include "bench_harness.h"
+
+#include <stdio.h>
+#include <vector>
+
+using namespace xcore;
+
+namespace
+{
+	const u32 sNumFrames = 100;
+
+	// Every frame: start all, stop all and read all in milliseconds
+	f64 sFramesTimers(u32 count)
+	{
+		std::vector<xcore::timer_t> timers(count);
+		std::vector<f64> ms(count);
+
+		f64 checksum = 0.0;
+		for (u32 f = 0; f < sNumFrames; ++f)
+		{
+			for (u32 i = 0; i < count; ++i)
+				timers[i].start();
+			for (u32 i = 0; i < count; ++i)
+				timers[i].stop();
+			for (u32 i = 0; i < count; ++i)
+				ms[i] = timers[i].readMs();
+			checksum += ms[count - 1];
+		}
+		return checksum;
+	}
+
+	f64 sFramesPool(alloc_t *allocator, u32 count)
+	{
+		stopwatch_pool_t pool;
+		pool.init(allocator, count);
+		std::vector<f64> ms(count);
+
+		f64 checksum = 0.0;
+		for (u32 f = 0; f < sNumFrames; ++f)
+		{
+			pool.startAll();
+			pool.stopAll();
+			pool.readMs(0, count, &ms[0]);
+			checksum += ms[count - 1];
+		}
+		pool.exit();
+		return checksum;
+	}
+
+	// Every frame: start and stop a scattered quarter of the stopwatches
+	f64 sBatchTimers(u32 count, const std::vector<u32> &indices)
+	{
+		std::vector<xcore::timer_t> timers(count);
+		u32 const n = (u32)indices.size();
+
+		for (u32 f = 0; f < sNumFrames; ++f)
+		{
+			for (u32 i = 0; i < n; ++i)
+				timers[indices[i]].start();
+			for (u32 i = 0; i < n; ++i)
+				timers[indices[i]].stop();
+		}
+		return timers[indices[0]].readMs();
+	}
+
+	f64 sBatchPool(alloc_t *allocator, u32 count, const std::vector<u32> &indices)
+	{
+		stopwatch_pool_t pool;
+		pool.init(allocator, count);
+		u32 const n = (u32)indices.size();
+
+		for (u32 f = 0; f < sNumFrames; ++f)
+		{
+			pool.startBatch(&indices[0], n);
+			pool.stopBatch(&indices[0], n);
+		}
+		tick_t t = pool.read(indices[0]);
+		pool.exit();
+		return x_TicksToMs(t);
+	}
+}
+
+void gBenchStopwatchPool(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("stopwatch_pool_t vs std::vector<timer_t>, 100 frames"))
+		return;
+
+	static const char *sNames[][4] = {
+		{ "all, std::vector<timer_t>, 1k", "all, stopwatch_pool_t, 1k", "batch, std::vector<timer_t>, 1k", "batch, stopwatch_pool_t, 1k" },
+		{ "all, std::vector<timer_t>, 16k", "all, stopwatch_pool_t, 16k", "batch, std::vector<timer_t>, 16k", "batch, stopwatch_pool_t, 16k" },
+		{ "all, std::vector<timer_t>, 64k", "all, stopwatch_pool_t, 64k", "batch, std::vector<timer_t>, 64k", "batch, stopwatch_pool_t, 64k" },
+	};
+
+	u32 const counts[] = { 1024, 16 * 1024, 64 * 1024 };
+	for (u32 c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+	{
+		u32 const count = counts[c];
+		u64 const ops = (u64)sNumFrames * count;
+
+		tick_t t = x_GetTime();
+		f64 r = sFramesTimers(count);
+		runner.add(sNames[c][0], 1, ops, x_GetTime() - t, (u64)r);
+
+		t = x_GetTime();
+		r = sFramesPool(allocator, count);
+		runner.add(sNames[c][1], 1, ops, x_GetTime() - t, (u64)r);
+
+		std::vector<u32> indices;
+		u32 rnd = 0x9E3779B9;
+		for (u32 i = 0; i < count; ++i)
+		{
+			rnd ^= rnd << 13;
+			rnd ^= rnd >> 17;
+			rnd ^= rnd << 5;
+			if ((rnd & 3) == 0)
+				indices.push_back(i);
+		}
+		u64 const batch_ops = (u64)sNumFrames * indices.size();
+
+		t = x_GetTime();
+		r = sBatchTimers(count, indices);
+		runner.add(sNames[c][2], 1, batch_ops, x_GetTime() - t, (u64)r);
+
+		t = x_GetTime();
+		r = sBatchPool(allocator, count, indices);
+		runner.add(sNames[c][3], 1, batch_ops, x_GetTime() - t, (u64)r);
+	}
+}
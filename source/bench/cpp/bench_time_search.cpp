@@ -0,0 +1,172 @@
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_time_search.h"
+
+#include "bench_harness.h"
+
+#include <algorithm>
+
+using namespace xcore;
+
+namespace
+{
+	inline u32 sNextRandom(u32 &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	const u32 sNumValues = 4 * 1024 * 1024; // 32 MB, more than the caches
+	const u32 sNumKeys = 64 * 1024;
+
+	// Events every ~1 us with jitter
+	void sFillEven(tick_t *values)
+	{
+		u32 rnd = 0x9E3779B9;
+		tick_t t = 0;
+		for (u32 i = 0; i < sNumValues; ++i)
+		{
+			t += 500 + (sNextRandom(rnd) % 1000);
+			values[i] = t;
+		}
+	}
+
+	// Bursts of events separated by long idle gaps of varying length
+	void sFillClustered(tick_t *values)
+	{
+		u32 rnd = 0x9E3779B9;
+		tick_t t = 0;
+		for (u32 i = 0; i < sNumValues; ++i)
+		{
+			if ((sNextRandom(rnd) & 1023) == 0)
+				t += (tick_t)(sNextRandom(rnd) % 1000) * 1000000000;
+			t += sNextRandom(rnd) % 100;
+			values[i] = t;
+		}
+	}
+
+	void sRandomKeys(const tick_t *values, tick_t *keys)
+	{
+		u32 rnd = 0x12345678;
+		for (u32 i = 0; i < sNumKeys; ++i)
+			keys[i] = values[sNextRandom(rnd) % sNumValues] + 1;
+	}
+
+	// The harness keeps the names, they have to outlive the runner
+	const char *sEvenNames[] = {
+		"even, random, std::lower_bound",
+		"even, random, x_LowerBound",
+		"even, random, x_InterpolationSearch",
+		"even, sorted batch, std::lower_bound",
+		"even, sorted batch, x_LowerBoundBatch",
+		"even, cursor, std::lower_bound",
+		"even, cursor, x_GallopSearch",
+	};
+
+	const char *sClusteredNames[] = {
+		"clustered, random, std::lower_bound",
+		"clustered, random, x_LowerBound",
+		"clustered, random, x_InterpolationSearch",
+		"clustered, sorted batch, std::lower_bound",
+		"clustered, sorted batch, x_LowerBoundBatch",
+		"clustered, cursor, std::lower_bound",
+		"clustered, cursor, x_GallopSearch",
+	};
+
+	void sPattern(bench_runner_t &runner, const char **names, const tick_t *values, tick_t *keys, u32 *indices)
+	{
+		sRandomKeys(values, keys);
+
+		// One operation is one lookup
+		runner.run(names[0], [&](u32, u64 n) {
+			u64 checksum = 0;
+			for (u64 i = 0; i < n; ++i)
+				checksum += (u64)(std::lower_bound(values, values + sNumValues, keys[i & (sNumKeys - 1)]) - values);
+			return checksum;
+		});
+
+		runner.run(names[1], [&](u32, u64 n) {
+			u64 checksum = 0;
+			for (u64 i = 0; i < n; ++i)
+				checksum += x_LowerBound(values, sNumValues, keys[i & (sNumKeys - 1)]);
+			return checksum;
+		});
+
+		runner.run(names[2], [&](u32, u64 n) {
+			u64 checksum = 0;
+			for (u64 i = 0; i < n; ++i)
+				checksum += x_InterpolationSearch(values, sNumValues, keys[i & (sNumKeys - 1)]);
+			return checksum;
+		});
+
+		// A sorted batch, one operation is one key
+		std::sort(keys, keys + sNumKeys);
+		runner.run(names[3], [&](u32, u64 n) {
+			u64 checksum = 0;
+			while (n > 0)
+			{
+				u32 const count = n < sNumKeys ? (u32)n : sNumKeys;
+				for (u32 k = 0; k < count; ++k)
+					indices[k] = (u32)(std::lower_bound(values, values + sNumValues, keys[k]) - values);
+				checksum += indices[count - 1];
+				n -= count;
+			}
+			return checksum;
+		});
+
+		runner.run(names[4], [&](u32, u64 n) {
+			u64 checksum = 0;
+			while (n > 0)
+			{
+				u32 const count = n < sNumKeys ? (u32)n : sNumKeys;
+				x_LowerBoundBatch(values, sNumValues, keys, count, indices);
+				checksum += indices[count - 1];
+				n -= count;
+			}
+			return checksum;
+		});
+
+		// A cursor that follows the time, every step moves a few events forward
+		runner.run(names[5], [&](u32, u64 n) {
+			u64 checksum = 0;
+			u32 step = 0;
+			for (u64 i = 0; i < n; ++i, step = step + 7 < sNumValues ? step + 7 : 0)
+				checksum += (u64)(std::lower_bound(values, values + sNumValues, values[step] + 1) - values);
+			return checksum;
+		});
+
+		runner.run(names[6], [&](u32, u64 n) {
+			u64 checksum = 0;
+			u32 step = 0;
+			u32 cursor = 0;
+			for (u64 i = 0; i < n; ++i, step = step + 7 < sNumValues ? step + 7 : 0)
+			{
+				cursor = x_GallopSearch(values, sNumValues, values[step] + 1, cursor);
+				checksum += cursor;
+			}
+			return checksum;
+		});
+	}
+}
+
+void gBenchTimeSearch(alloc_t *allocator, bench_runner_t &runner)
+{
+	if (!runner.group("x_time_search.h"))
+		return;
+
+	tick_t *values = (tick_t *)allocator->allocate(sNumValues * (u32)sizeof(tick_t), 64);
+	tick_t *keys = (tick_t *)allocator->allocate(sNumKeys * (u32)sizeof(tick_t), 64);
+	u32 *indices = (u32 *)allocator->allocate(sNumKeys * (u32)sizeof(u32), 64);
+
+	sFillEven(values);
+	sPattern(runner, sEvenNames, values, keys, indices);
+	sFillClustered(values);
+	sPattern(runner, sClusteredNames, values, keys, indices);
+
+	allocator->deallocate(indices);
+	allocator->deallocate(keys);
+	allocator->deallocate(values);
+}
@@ -0,0 +1,124 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_asof_join.h"
+#include "xtime/x_time_search.h"
+
+#include <string.h>
+#include <thread>
+
+namespace xcore
+{
+	namespace xasofjoin
+	{
+		static const u32	sMaxThreads = 64;
+
+		struct partition_t
+		{
+			u32		mFirst;
+			u32		mLast;
+			u32		mCount;
+		};
+
+		// Merges left rows [first, last), 'j' is a position in the right column that is not
+		// beyond the first match. Returns the number of pairs written to 'out'.
+		static u32			sMerge(const datetime_t* left, u32 first, u32 last, const datetime_t* right, u32 num_right, u32 j, u64 tolerance, bool keep, asof_pair_t* out)
+		{
+			u32 n = 0;
+			for (u32 i = first; i < last; ++i)
+			{
+				u64 const key = left[i].ticks();
+
+				// The right column is sorted, so the number of the next 8 rows at or before
+				// the key is where the match is. Counting them has no unpredictable branch,
+				// only a run of more than 8 rows gallops.
+				if (j + 8 <= num_right)
+				{
+					u32 c = 0;
+					for (u32 k = 0; k < 8; ++k)
+						c += right[j + k].ticks() <= key ? 1 : 0;
+					j += c;
+					if (c == 8 && j < num_right && right[j].ticks() <= key)
+						j = x_GallopSearch(right, num_right, datetime_t(key + 1), j);
+				}
+				else
+				{
+					while (j < num_right && right[j].ticks() <= key)
+						++j;
+				}
+
+				if (j > 0 && key - right[j - 1].ticks() <= tolerance)
+				{
+					out[n].mLeft = i;
+					out[n].mRight = j - 1;
+					++n;
+				}
+				else if (keep)
+				{
+					out[n].mLeft = i;
+					out[n].mRight = asof_pair_t::NO_MATCH;
+					++n;
+				}
+			}
+			return n;
+		}
+	}
+
+	asof_options_t::asof_options_t()
+		: mTolerance(timespan_t::sMaxValue)
+		, mKeepUnmatched(false)
+		, mNumThreads(1)
+		, mMinRowsPerThread(256 * 1024)
+	{
+	}
+
+	u32		x_AsOfJoin(const datetime_t* left, u32 num_left, const datetime_t* right, u32 num_right, asof_pair_t* out_pairs, const asof_options_t& options)
+	{
+		u64 const tolerance = options.mTolerance.ticks();
+		bool const keep = options.mKeepUnmatched;
+
+		u32 threads = options.mNumThreads;
+		if (threads == 0)
+			threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+		u32 const min_rows = options.mMinRowsPerThread > 0 ? options.mMinRowsPerThread : 1;
+		if (threads > num_left / min_rows)
+			threads = num_left / min_rows;
+		if (threads > xasofjoin::sMaxThreads)
+			threads = xasofjoin::sMaxThreads;
+
+		if (threads <= 1)
+			return xasofjoin::sMerge(left, 0, num_left, right, num_right, 0, tolerance, keep, out_pairs);
+
+		// Every partition writes its pairs at the position of its first left row
+		xasofjoin::partition_t partitions[xasofjoin::sMaxThreads];
+		std::thread workers[xasofjoin::sMaxThreads];
+		for (u32 p = 0; p < threads; ++p)
+		{
+			xasofjoin::partition_t& partition = partitions[p];
+			partition.mFirst = (u32)(((u64)num_left * p) / threads);
+			partition.mLast = (u32)(((u64)num_left * (p + 1)) / threads);
+			partition.mCount = 0;
+			if (p == 0)
+				continue;
+			workers[p] = std::thread([=, &partition]() {
+				u32 const start = x_InterpolationSearch(right, num_right, left[partition.mFirst]);
+				partition.mCount = xasofjoin::sMerge(left, partition.mFirst, partition.mLast, right, num_right, start, tolerance, keep, out_pairs + partition.mFirst);
+			});
+		}
+		partitions[0].mCount = xasofjoin::sMerge(left, 0, partitions[0].mLast, right, num_right, 0, tolerance, keep, out_pairs);
+		for (u32 p = 1; p < threads; ++p)
+			workers[p].join();
+
+		// Without the unmatched rows the partitions have gaps between them
+		u32 n = partitions[0].mCount;
+		for (u32 p = 1; p < threads; ++p)
+		{
+			if (n != partitions[p].mFirst)
+				memmove(out_pairs + n, out_pairs + partitions[p].mFirst, partitions[p].mCount * sizeof(asof_pair_t));
+			n += partitions[p].mCount;
+		}
+		return n;
+	}
+};
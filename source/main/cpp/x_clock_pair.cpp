@@ -0,0 +1,114 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_clock_pair.h"
+
+namespace xcore
+{
+	void		x_SampleClockPair(clock_pair_t& pair, u32 attempts)
+	{
+		if (attempts == 0)
+			attempts = 1;
+
+		for (u32 i = 0; i < attempts; ++i)
+		{
+			tick_t const before = x_GetTime();
+			u64 const dt = datetime_t::sNowUtc().ticks();
+			tick_t const after = x_GetTime();
+
+			tick_t const half = (after - before) / 2;
+			if (i == 0 || half < pair.mUncertainty)
+			{
+				pair.mTicks = before + half;
+				pair.mDateTime = dt;
+				pair.mUncertainty = half;
+			}
+		}
+	}
+
+	/**
+	 * tick_datetime_map_t
+	 */
+	tick_datetime_map_t::tick_datetime_map_t()
+		: mInterval(0)
+		, mAttempts(8)
+		, mNumAnchors(0)
+		, mNominalRate(1.0)
+		, mMaxDrift(0.0)
+		, mRate(1.0)
+		, mLastError(0)
+	{
+		mAnchor.mTicks = 0;
+		mAnchor.mDateTime = 0;
+		mAnchor.mUncertainty = 0;
+	}
+
+	void		tick_datetime_map_t::init(tick_t reanchor_interval, u32 max_drift_ppm, u32 attempts)
+	{
+		mInterval = reanchor_interval;
+		mAttempts = attempts;
+		mNominalRate = (f64)timespan_t::sTicksPerSecond / (f64)x_GetTicksPerSecond();
+		mMaxDrift = mNominalRate * (f64)max_drift_ppm / 1000000.0;
+		mRate = mNominalRate;
+		mNumAnchors = 0;
+		mLastError = 0;
+		anchor();
+	}
+
+	bool		tick_datetime_map_t::update()
+	{
+		return update(x_GetTime());
+	}
+
+	bool		tick_datetime_map_t::update(tick_t now)
+	{
+		if (mNumAnchors > 0 && (now - mAnchor.mTicks) < mInterval)
+			return false;
+		anchor();
+		return true;
+	}
+
+	void		tick_datetime_map_t::anchor()
+	{
+		clock_pair_t pair;
+		x_SampleClockPair(pair, mAttempts);
+		anchor(pair);
+	}
+
+	void		tick_datetime_map_t::anchor(const clock_pair_t& pair)
+	{
+		if (mNumAnchors > 0 && pair.mTicks > mAnchor.mTicks)
+		{
+			mLastError = (s64)toDateTimeTicks(pair.mTicks) - (s64)pair.mDateTime;
+
+			// The rate over the last interval, a wall clock step is not a rate
+			f64 rate = ((f64)((s64)pair.mDateTime - (s64)mAnchor.mDateTime)) / (f64)(pair.mTicks - mAnchor.mTicks);
+			if (rate < mNominalRate - mMaxDrift)
+				rate = mNominalRate - mMaxDrift;
+			else if (rate > mNominalRate + mMaxDrift)
+				rate = mNominalRate + mMaxDrift;
+			mRate = rate;
+		}
+		mAnchor = pair;
+		mNumAnchors++;
+	}
+
+	u64			tick_datetime_map_t::toDateTimeTicks(tick_t ticks) const
+	{
+		s64 const delta = (s64)((f64)(ticks - mAnchor.mTicks) * mRate);
+		return (u64)((s64)mAnchor.mDateTime + delta);
+	}
+
+	datetime_t	tick_datetime_map_t::toDateTime(tick_t ticks) const
+	{
+		return datetime_t(toDateTimeTicks(ticks));
+	}
+
+	tick_t		tick_datetime_map_t::toTicks(const datetime_t& dt) const
+	{
+		s64 const delta = (s64)dt.ticks() - (s64)mAnchor.mDateTime;
+		return mAnchor.mTicks + (tick_t)((f64)delta / mRate);
+	}
+};
@@ -0,0 +1,151 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timer.h"
+#include "xtime/x_cpu_timer.h"
+
+#include "xtime/private/x_cpu_time_source.h"
+
+namespace xcore
+{
+	// Nanoseconds to x_GetTicksPerSecond() units, split to avoid overflow
+	static tick_t	sNsToTicks(s64 inNs)
+	{
+		s64 const tps = x_GetTicksPerSecond();
+		if (tps == 1000000000)
+			return inNs;
+		return (inNs / 1000000000) * tps + ((inNs % 1000000000) * tps) / 1000000000;
+	}
+
+	tick_t		x_GetThreadCpuTime()
+	{
+		return sNsToTicks(x_GetThreadCpuTimeNs());
+	}
+
+	tick_t		x_GetProcessCpuTime()
+	{
+		return sNsToTicks(x_GetProcessCpuTimeNs());
+	}
+
+	/**
+	 * cpu_timer_t
+	 */
+	cpu_timer_t::cpu_timer_t(EClock clock)
+		: mClock(clock)
+		, mStartTime(0)
+		, mTotalTime(0)
+		, mIsRunning(false)
+		, mNumTrips(0)
+	{
+	}
+
+	s64			cpu_timer_t::now() const
+	{
+		return mClock == THREAD ? x_GetThreadCpuTimeNs() : x_GetProcessCpuTimeNs();
+	}
+
+	void		cpu_timer_t::start()
+	{
+		if (mIsRunning)
+			return;
+
+		mStartTime = now();
+		mIsRunning = true;
+		mNumTrips++;
+	}
+
+	void		cpu_timer_t::reset()
+	{
+		mIsRunning = false;
+		mStartTime = 0;
+		mTotalTime = 0;
+		mNumTrips = 0;
+	}
+
+	tick_t		cpu_timer_t::stop()
+	{
+		if (mIsRunning)
+		{
+			mTotalTime += now() - mStartTime;
+			mIsRunning = false;
+		}
+		return sNsToTicks(mTotalTime);
+	}
+
+	tick_t		cpu_timer_t::read() const
+	{
+		if (mIsRunning)
+			return sNsToTicks(mTotalTime + (now() - mStartTime));
+		return sNsToTicks(mTotalTime);
+	}
+
+	tick_t		cpu_timer_t::trip()
+	{
+		if (!mIsRunning)
+			return 0;
+
+		s64 const current = now();
+		s64 const ns = mTotalTime + (current - mStartTime);
+		mTotalTime = 0;
+		mStartTime = current;
+		mNumTrips++;
+		return sNsToTicks(ns);
+	}
+
+	/**
+	 * cpu_usage_timer_t
+	 */
+	cpu_usage_timer_t::cpu_usage_timer_t()
+		: mThread(cpu_timer_t::THREAD)
+		, mProcess(cpu_timer_t::PROCESS)
+	{
+	}
+
+	void		cpu_usage_timer_t::sFill(cpu_usage_t& usage, tick_t wall, tick_t thread, tick_t process)
+	{
+		usage.mWall = wall;
+		usage.mThreadCpu = thread;
+		usage.mProcessCpu = process;
+		usage.mThreadUtilization = wall > 0 ? (f64)thread / (f64)wall : 0.0;
+		usage.mProcessUtilization = wall > 0 ? (f64)process / (f64)wall : 0.0;
+	}
+
+	void		cpu_usage_timer_t::start()
+	{
+		// The wall interval encloses the process interval, which encloses the thread interval
+		mWall.start();
+		mProcess.start();
+		mThread.start();
+	}
+
+	void		cpu_usage_timer_t::reset()
+	{
+		mWall.reset();
+		mThread.reset();
+		mProcess.reset();
+	}
+
+	void		cpu_usage_timer_t::stop(cpu_usage_t& usage)
+	{
+		tick_t const thread = mThread.stop();
+		tick_t const process = mProcess.stop();
+		tick_t const wall = mWall.stop();
+		sFill(usage, wall, thread, process);
+	}
+
+	void		cpu_usage_timer_t::read(cpu_usage_t& usage) const
+	{
+		tick_t const thread = mThread.read();
+		tick_t const process = mProcess.read();
+		tick_t const wall = mWall.read();
+		sFill(usage, wall, thread, process);
+	}
+
+	void		cpu_usage_timer_t::trip(cpu_usage_t& usage)
+	{
+		tick_t const thread = mThread.trip();
+		tick_t const process = mProcess.trip();
+		tick_t const wall = mWall.trip();
+		sFill(usage, wall, thread, process);
+	}
+};
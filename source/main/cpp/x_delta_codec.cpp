@@ -0,0 +1,400 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_delta_codec.h"
+
+#include "xtime/private/x_time_bits.h"
+
+namespace xcore
+{
+	namespace xdeltacodec
+	{
+		// Payload bits for a prefix of 0 .. 5 one bits, the prefix of 1 to 4 ones
+		// is terminated by a zero bit, the prefix of 5 ones is not.
+		static const u32	sPayload[6] = { 0, 8, 14, 20, 32, 64 };
+		static const u32	sHeader[6] = { 1, 2, 3, 4, 5, 5 };
+
+		// Indexed with the first 5 bits of a code: the header bits in the high byte and the
+		// header plus payload bits in the low byte (1, 10, 17, 24 or 37 bits), 0 for the
+		// 64 bit delta of delta.
+		static const u16	sCodes[32] =
+		{
+			0x101, 0x101, 0x101, 0x101, 0x101, 0x101, 0x101, 0x101,
+			0x101, 0x101, 0x101, 0x101, 0x101, 0x101, 0x101, 0x101,
+			0x20a, 0x20a, 0x20a, 0x20a, 0x20a, 0x20a, 0x20a, 0x20a,
+			0x311, 0x311, 0x311, 0x311, 0x418, 0x418, 0x525, 0x000,
+		};
+
+		static inline u64	sZigZag(s64 v)
+		{
+			return ((u64)v << 1) ^ (u64)(v >> 63);
+		}
+
+		static inline s64	sUnZigZag(u64 v)
+		{
+			return (s64)(v >> 1) ^ -(s64)(v & 1);
+		}
+
+		static inline u32	sBucket(u64 zigzag)
+		{
+			if (zigzag == 0)
+				return 0;
+			if (zigzag < (X_CONSTANT_64(1) << 8))
+				return 1;
+			if (zigzag < (X_CONSTANT_64(1) << 14))
+				return 2;
+			if (zigzag < (X_CONSTANT_64(1) << 20))
+				return 3;
+			if (zigzag < (X_CONSTANT_64(1) << 32))
+				return 4;
+			return 5;
+		}
+
+		// The prefix bits of a bucket, right aligned
+		static inline u64	sPrefix(u32 bucket)
+		{
+			return bucket == 5 ? 0x1f : (((u64)1 << bucket) - 1) << 1;
+		}
+	}
+
+	/**
+	 * delta_encoder_t
+	 */
+	delta_encoder_t::delta_encoder_t()
+		: mBuffer(NULL)
+		, mCapacity(0)
+		, mSize(0)
+		, mPending(0)
+		, mNumPending(0)
+		, mNumValues(0)
+		, mLast(0)
+		, mLastDelta(0)
+		, mFinished(false)
+	{
+	}
+
+	void		delta_encoder_t::init(u8* buffer, u32 capacity)
+	{
+		mBuffer = buffer;
+		mCapacity = capacity;
+		mSize = 0;
+		mPending = 0;
+		mNumPending = 0;
+		mNumValues = 0;
+		mLast = 0;
+		mLastDelta = 0;
+		mFinished = false;
+	}
+
+	bool		delta_encoder_t::write(tick_t value)
+	{
+		ASSERTS(!mFinished, "delta_encoder_t: write after finish");
+
+		u64 code;
+		u32 code_bits;
+		u64 payload;
+		u32 payload_bits;
+		tick_t delta = 0;
+		if (mNumValues == 0)
+		{
+			code = 0;
+			code_bits = 0;
+			payload = (u64)value;
+			payload_bits = 64;
+		}
+		else
+		{
+			// Wrapping arithmetic, any sequence of 64 bit values round-trips
+			delta = (tick_t)((u64)value - (u64)mLast);
+			u64 const zigzag = xdeltacodec::sZigZag((tick_t)((u64)delta - (u64)mLastDelta));
+			u32 const bucket = xdeltacodec::sBucket(zigzag);
+			code = xdeltacodec::sPrefix(bucket);
+			code_bits = xdeltacodec::sHeader[bucket];
+			payload = zigzag;
+			payload_bits = xdeltacodec::sPayload[bucket];
+		}
+
+		// Room for this value and for the last partial byte
+		u64 const bits = (u64)mNumPending + code_bits + payload_bits;
+		if ((u64)mSize + ((bits + 7) >> 3) > (u64)mCapacity)
+			return false;
+
+		// At most 7 bits are pending, 32 more always fit in the accumulator
+		u64 parts[3];
+		u32 sizes[3];
+		u32 num_parts = 0;
+		if (code_bits > 0)
+		{
+			parts[num_parts] = code;
+			sizes[num_parts++] = code_bits;
+		}
+		if (payload_bits > 32)
+		{
+			parts[num_parts] = payload >> 32;
+			sizes[num_parts++] = payload_bits - 32;
+			parts[num_parts] = payload & 0xffffffff;
+			sizes[num_parts++] = 32;
+		}
+		else if (payload_bits > 0)
+		{
+			parts[num_parts] = payload;
+			sizes[num_parts++] = payload_bits;
+		}
+
+		for (u32 p = 0; p < num_parts; ++p)
+		{
+			mPending = (mPending << sizes[p]) | parts[p];
+			mNumPending += sizes[p];
+			while (mNumPending >= 8)
+			{
+				mNumPending -= 8;
+				mBuffer[mSize++] = (u8)(mPending >> mNumPending);
+			}
+			mPending &= ((u64)1 << mNumPending) - 1;
+		}
+
+		mLast = value;
+		mLastDelta = delta;
+		mNumValues++;
+		return true;
+	}
+
+	u32			delta_encoder_t::write(const tick_t* values, u32 count)
+	{
+		u32 i = 0;
+		while (i < count && write(values[i]))
+			++i;
+		return i;
+	}
+
+	u32			delta_encoder_t::finish()
+	{
+		if (!mFinished && mNumPending > 0)
+		{
+			mBuffer[mSize++] = (u8)(mPending << (8 - mNumPending));
+			mPending = 0;
+			mNumPending = 0;
+		}
+		mFinished = true;
+		return mSize;
+	}
+
+	/**
+	 * delta_decoder_t
+	 */
+	delta_decoder_t::delta_decoder_t()
+		: mBuffer(NULL)
+		, mSize(0)
+		, mPosition(0)
+		, mRemaining(0)
+		, mNumRead(0)
+		, mLast(0)
+		, mLastDelta(0)
+	{
+	}
+
+	void		delta_decoder_t::init(const u8* buffer, u32 size, u32 count)
+	{
+		mBuffer = buffer;
+		mSize = size;
+		mPosition = 0;
+		mRemaining = count;
+		mNumRead = 0;
+		mLast = 0;
+		mLastDelta = 0;
+	}
+
+	// The 64 bits at the current position, left aligned. Near the end of the
+	// buffer the missing bytes read as zero.
+	u64			delta_decoder_t::peek(u32& avail) const
+	{
+		u32 const byte = (u32)(mPosition >> 3);
+		u32 const shift = (u32)(mPosition & 7);
+		if ((u64)byte + 8 <= (u64)mSize)
+		{
+			avail = 64 - shift;
+			return xtime_load_be64(mBuffer + byte) << shift;
+		}
+		u64 w = 0;
+		u32 const n = byte < mSize ? mSize - byte : 0;
+		for (u32 i = 0; i < n; ++i)
+			w |= (u64)mBuffer[byte + i] << (56 - 8 * i);
+		avail = n * 8 > shift ? n * 8 - shift : 0;
+		return w << shift;
+	}
+
+	u64			delta_decoder_t::readBits(u32 n)
+	{
+		u32 avail;
+		u64 const w = peek(avail);
+		ASSERTS(avail >= n, "delta_decoder_t: buffer is too short");
+		mPosition += n;
+		return w >> (64 - n);
+	}
+
+	void		delta_decoder_t::readOne()
+	{
+		if (mNumRead == 0)
+		{
+			u64 const hi = readBits(32);
+			mLast = (tick_t)((hi << 32) | readBits(32));
+			mLastDelta = 0;
+			return;
+		}
+
+		u32 avail;
+		u64 const w = peek(avail);
+		u32 const ones = ~w == 0 ? 64 : (u32)xtime_clz64(~w);
+		u32 const bucket = ones >= 5 ? 5 : ones;
+		u64 zigzag;
+		if (bucket == 5)
+		{
+			mPosition += 5;
+			u64 const hi = readBits(32);
+			zigzag = (hi << 32) | readBits(32);
+		}
+		else
+		{
+			u32 const header = xdeltacodec::sHeader[bucket];
+			u32 const payload = xdeltacodec::sPayload[bucket];
+			ASSERTS(avail >= header + payload, "delta_decoder_t: buffer is too short");
+			zigzag = payload == 0 ? 0 : (w << header) >> (64 - payload);
+			mPosition += header + payload;
+		}
+		mLastDelta = (tick_t)((u64)mLastDelta + (u64)xdeltacodec::sUnZigZag(zigzag));
+		mLast = (tick_t)((u64)mLast + (u64)mLastDelta);
+	}
+
+	bool		delta_decoder_t::read(tick_t& value)
+	{
+		if (mRemaining == 0)
+			return false;
+		readOne();
+		mNumRead++;
+		mRemaining--;
+		value = mLast;
+		return true;
+	}
+
+	bool		delta_decoder_t::read(datetime_t& value)
+	{
+		tick_t t;
+		if (!read(t))
+			return false;
+		value = datetime_t((u64)t);
+		return true;
+	}
+
+	// The state is kept in locals. The bits are read through a left aligned bit
+	// buffer that is refilled without a branch before every value: one unaligned
+	// 64 bit load tops it up to 56 to 63 valid bits, enough for any code except
+	// the 64 bit delta of delta, which is read with a second refill. The refill
+	// keeps the bits below the valid ones, they are the next bits of the stream.
+	// A run of zero bits is a run of values with an unchanged delta.
+	u32			delta_decoder_t::read(tick_t* values, u32 count)
+	{
+		if (count > mRemaining)
+			count = mRemaining;
+
+		u32 i = 0;
+		if (i < count && mNumRead == 0)
+		{
+			readOne();
+			mNumRead++;
+			values[i++] = mLast;
+		}
+
+		u32 const first = i;
+		u64 last = (u64)mLast;
+		u64 delta = (u64)mLastDelta;
+
+		const u8* const end = mBuffer + (mSize >= 8 ? mSize - 8 : 0);
+		const u8* ptr = mBuffer + (mPosition >> 3);
+		u64 bits = 0;
+		u32 avail = 0;
+		bool const fast = mSize >= 8 && ptr <= end;
+		if (fast)
+		{
+			bits = xtime_load_be64(ptr);
+			ptr += 7;
+			avail = 56 - (u32)(mPosition & 7);
+			bits <<= mPosition & 7;
+		}
+
+		while (fast && i < count && ptr <= end)
+		{
+			// The prefix is decoded from the bits before the refill, that keeps the
+			// load out of the dependency chain from one prefix to the next. After a
+			// refill all 64 bits are stream bits and a code uses at most 37 of them,
+			// so the next 5 bit prefix is always there.
+			u64 const prefix = bits;
+			bits |= xtime_load_be64(ptr) >> avail;
+			ptr += (63 - avail) >> 3;
+			avail |= 56;
+
+			if ((s64)prefix >= 0)
+			{
+				// At most 56 so that at least 8 bits are left for the next prefix
+				u32 run = (u32)xtime_clz64(bits | 1);
+				if (run > 56)
+					run = 56;
+				if (run > count - i)
+					run = count - i;
+				for (u32 const stop = i + run; i < stop; ++i)
+				{
+					last += delta;
+					values[i] = (tick_t)last;
+				}
+				bits <<= run;
+				avail -= run;
+				continue;
+			}
+
+			u32 const code = xdeltacodec::sCodes[prefix >> 59];
+			u64 zigzag;
+			if (code != 0)
+			{
+				u32 const header = code >> 8;
+				u32 const used = code & 0xff;
+				zigzag = (bits << header) >> (64 - used + header);
+				bits <<= used;
+				avail -= used;
+			}
+			else
+			{
+				// The 64 bit delta of delta, 5 + 32 bits fit, refill for the low half
+				if (ptr > end)
+					break;
+				zigzag = (bits << 5) >> 32;
+				bits <<= 37;
+				avail -= 37;
+				bits |= xtime_load_be64(ptr) >> avail;
+				ptr += (63 - avail) >> 3;
+				avail |= 56;
+				zigzag = (zigzag << 32) | (bits >> 32);
+				bits <<= 32;
+				avail -= 32;
+			}
+			delta += (u64)xdeltacodec::sUnZigZag(zigzag);
+			last += delta;
+			values[i++] = (tick_t)last;
+		}
+
+		if (fast)
+			mPosition = (u64)(ptr - mBuffer) * 8 - avail;
+		mLast = (tick_t)last;
+		mLastDelta = (tick_t)delta;
+		mNumRead += i - first;
+
+		// The tail and the rare 64 bit delta of delta
+		for (; i < count; ++i)
+		{
+			readOne();
+			mNumRead++;
+			values[i] = mLast;
+		}
+		mRemaining -= count;
+		return count;
+	}
+};
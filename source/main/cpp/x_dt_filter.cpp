@@ -0,0 +1,173 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_frame_rate.h"
+#include "xtime/x_dt_filter.h"
+
+namespace xcore
+{
+	dt_filter_t::dt_filter_t()
+		: mMode(NONE)
+		, mMaxDelta(x_GetTicksPerSecond() / 4)
+		, mFrameRate(NULL)
+		, mEmaWeight(0.1)
+		, mWindow(5)
+		, mNumPeriods(0)
+		, mTolerance(0.1)
+	{
+		reset();
+	}
+
+	void		dt_filter_t::setMode(EMode mode)
+	{
+		mMode = mode;
+		reset();
+	}
+
+	void		dt_filter_t::setEmaWeight(f64 weight)
+	{
+		ASSERT(weight > 0.0 && weight <= 1.0);
+		mEmaWeight = weight;
+	}
+
+	void		dt_filter_t::setMedianWindow(u32 window)
+	{
+		ASSERT(window >= 1 && window <= MAX_WINDOW);
+		mWindow = window;
+		mCount = 0;
+		mHead = 0;
+	}
+
+	void		dt_filter_t::setRefreshRates(const f64* hz, u32 count, f64 tolerance)
+	{
+		ASSERT(count <= MAX_REFRESH_RATES);
+		mNumPeriods = 0;
+		for (u32 i = 0; i < count; ++i)
+		{
+			if (hz[i] > 0.0)
+				mPeriods[mNumPeriods++] = (tick_t)((f64)x_GetTicksPerSecond() / hz[i] + 0.5);
+		}
+		mTolerance = tolerance;
+		mResidual = 0;
+	}
+
+	void		dt_filter_t::reset()
+	{
+		mDelta = 0;
+		mRawDelta = 0;
+		mLastMark = 0;
+		mMarked = false;
+		mNumCapped = 0;
+		mEma = 0.0;
+		mEmaValid = false;
+		mCount = 0;
+		mHead = 0;
+		mResidual = 0;
+	}
+
+	tick_t		dt_filter_t::markFrame(tick_t now)
+	{
+		if (mFrameRate != NULL)
+			mFrameRate->markFrame(now);
+
+		if (!mMarked)
+		{
+			mMarked = true;
+			mLastMark = now;
+			return 0;
+		}
+		tick_t const raw = now - mLastMark;
+		mLastMark = now;
+		return filter(raw);
+	}
+
+	tick_t		dt_filter_t::filter(tick_t raw)
+	{
+		mRawDelta = raw;
+		tick_t delta = raw < 0 ? 0 : raw;
+		if (mMaxDelta > 0 && delta > mMaxDelta)
+		{
+			delta = mMaxDelta;
+			mNumCapped++;
+		}
+
+		switch (mMode)
+		{
+		case EMA:
+			mEma = mEmaValid ? mEma + mEmaWeight * ((f64)delta - mEma) : (f64)delta;
+			mEmaValid = true;
+			delta = (tick_t)(mEma + 0.5);
+			break;
+		case MEDIAN:
+			delta = median(delta);
+			break;
+		case VSYNC:
+			delta = snap(delta);
+			break;
+		default:
+			break;
+		}
+
+		mDelta = delta;
+		return delta;
+	}
+
+	// The window is kept twice, in arrival order (ring) and sorted. The oldest
+	// delta is removed from the sorted array and the new one is inserted.
+	tick_t		dt_filter_t::median(tick_t delta)
+	{
+		if (mCount == mWindow)
+		{
+			tick_t const oldest = mHistory[mHead];
+			u32 i = 0;
+			while (mSorted[i] != oldest)
+				++i;
+			for (; (i + 1) < mCount; ++i)
+				mSorted[i] = mSorted[i + 1];
+			mCount--;
+		}
+		mHistory[mHead] = delta;
+		mHead = (mHead + 1) % mWindow;
+
+		u32 i = mCount;
+		for (; i > 0 && mSorted[i - 1] > delta; --i)
+			mSorted[i] = mSorted[i - 1];
+		mSorted[i] = delta;
+		mCount++;
+
+		if ((mCount & 1) == 1)
+			return mSorted[mCount / 2];
+		return (mSorted[mCount / 2 - 1] + mSorted[mCount / 2]) / 2;
+	}
+
+	tick_t		dt_filter_t::snap(tick_t delta)
+	{
+		tick_t const d = delta + mResidual;
+		tick_t best = d;
+		tick_t best_error = -1;
+		for (u32 p = 0; p < mNumPeriods; ++p)
+		{
+			tick_t const period = mPeriods[p];
+			tick_t const tolerance = (tick_t)(mTolerance * (f64)period);
+			for (s32 m = 1; m <= MAX_MULTIPLE; ++m)
+			{
+				tick_t const candidate = m * period;
+				tick_t const error = d > candidate ? d - candidate : candidate - d;
+				if (error <= tolerance && (best_error < 0 || error < best_error))
+				{
+					best = candidate;
+					best_error = error;
+				}
+			}
+		}
+
+		if (best_error < 0)
+		{
+			// No refresh period fits, pass the delta through together with the carry
+			mResidual = 0;
+			return d < 0 ? 0 : d;
+		}
+		mResidual = d - best;
+		return best;
+	}
+};
@@ -0,0 +1,527 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_event_log.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace xcore
+{
+	/**
+	 * Event log file layout (native endianness)
+	 *
+	 * header_t                             magic, version and clock metadata
+	 * block_t + count * event_record_t     EVENTS block, records of one thread
+	 * block_t + count * char               NAME block, name of a thread
+	 * ...
+	 */
+	namespace xeventlog
+	{
+		static const u32		sMagic = 0x4c564558;		// 'XEVL'
+		static const u32		sVersion = 1;
+
+		enum EBlock
+		{
+			BLOCK_EVENTS = 1,
+			BLOCK_NAME = 2,
+		};
+
+		struct header_t
+		{
+			u32					mMagic;
+			u32					mVersion;
+			s64					mTicksPerSecond;
+			s64					mStartTicks;
+			u64					mStartTime;				///< datetime_t ticks (UTC) at mStartTicks
+		};
+
+		struct block_t
+		{
+			u32					mType;
+			u32					mThread;
+			u32					mCount;
+			u32					mReserved;
+		};
+
+		/**
+		 * The owning thread is the only producer (mHead), the writer thread is the
+		 * only consumer (mTail). The records follow the buffer in the arena.
+		 *
+		 * The name is a seqlock: the owning thread makes mNameSerial odd while it
+		 * writes the name, the writer thread only uses a copy of the name when the
+		 * serial was even and did not change while copying.
+		 */
+		struct alignas(64) buffer_t
+		{
+			std::atomic<u64>	mHead;
+			std::atomic<u64>	mDropped;
+			u32					mIndex;
+			u32					mMask;
+			char				mPad0[64 - 2 * sizeof(std::atomic<u64>) - 2 * sizeof(u32)];
+			std::atomic<u64>	mTail;
+			std::atomic<u32>	mNameSerial;
+			u32					mNameWritten;
+			buffer_t*			mNext;
+			std::atomic<char>	mName[32];
+		};
+
+		struct state_t
+		{
+			alloc_t*				mAllocator;
+			FILE*					mFile;
+			char*					mArena;
+			u64						mArenaSize;
+			u64						mBufferSize;
+			std::atomic<u64>		mArenaUsed;
+			u32						mEventsPerThread;
+			u32						mFlushIntervalMs;
+
+			std::atomic<buffer_t*>	mBuffers;
+			std::atomic<u32>		mNumThreads;
+			std::atomic<u64>		mDropped;			///< Events of threads that did not get a buffer
+			std::atomic<u64>		mWritten;
+			bool					mError;
+
+			std::mutex				mMutex;
+			std::condition_variable	mWakeup;
+			bool					mStop;
+			std::thread				mWriter;
+		};
+
+		static state_t*						sState = NULL;
+		static std::atomic<u32>				sGeneration(1);
+
+		static thread_local buffer_t*		tBuffer = NULL;
+		static thread_local u32				tGeneration = 0;
+
+		static inline event_record_t*	sRecords(buffer_t* buffer)
+		{
+			return (event_record_t*)(buffer + 1);
+		}
+
+		static buffer_t*	sAcquireBuffer()
+		{
+			u32 const generation = sGeneration.load(std::memory_order_acquire);
+			if (tGeneration == generation)
+				return tBuffer;
+
+			tBuffer = NULL;
+			tGeneration = generation;
+			state_t* state = sState;
+			if (state == NULL)
+				return NULL;
+
+			u64 const offset = state->mArenaUsed.fetch_add(state->mBufferSize, std::memory_order_relaxed);
+			if (offset + state->mBufferSize > state->mArenaSize)
+				return NULL;
+
+			buffer_t* buffer = new (state->mArena + offset) buffer_t();
+			buffer->mHead.store(0, std::memory_order_relaxed);
+			buffer->mDropped.store(0, std::memory_order_relaxed);
+			buffer->mIndex = state->mNumThreads.fetch_add(1, std::memory_order_relaxed);
+			buffer->mMask = state->mEventsPerThread - 1;
+			buffer->mTail.store(0, std::memory_order_relaxed);
+			buffer->mNameSerial.store(0, std::memory_order_relaxed);
+			buffer->mNameWritten = 0;
+			buffer->mName[0].store('\0', std::memory_order_relaxed);
+
+			buffer_t* head = state->mBuffers.load(std::memory_order_relaxed);
+			do
+			{
+				buffer->mNext = head;
+			} while (!state->mBuffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+			tBuffer = buffer;
+			return buffer;
+		}
+
+		static void		sWriteBlock(state_t* state, u32 type, u32 thread, const void* data, u32 count, u32 size)
+		{
+			block_t block;
+			block.mType = type;
+			block.mThread = thread;
+			block.mCount = count;
+			block.mReserved = 0;
+			if (fwrite(&block, sizeof(block), 1, state->mFile) != 1 || fwrite(data, size, count, state->mFile) != count)
+				state->mError = true;
+		}
+
+		static void		sDrain(state_t* state)
+		{
+			u64 const mask = state->mEventsPerThread - 1;
+			for (buffer_t* buffer = state->mBuffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->mNext)
+			{
+				// A name that is being written is picked up by the next drain
+				u32 const serial = buffer->mNameSerial.load(std::memory_order_acquire);
+				if (serial != buffer->mNameWritten && (serial & 1) == 0)
+				{
+					char name[sizeof(buffer->mName)];
+					u32 length = 0;
+					for (; length < sizeof(name) - 1; ++length)
+					{
+						name[length] = buffer->mName[length].load(std::memory_order_relaxed);
+						if (name[length] == '\0')
+							break;
+					}
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (buffer->mNameSerial.load(std::memory_order_relaxed) == serial)
+					{
+						sWriteBlock(state, BLOCK_NAME, buffer->mIndex, name, length, 1);
+						buffer->mNameWritten = serial;
+					}
+				}
+
+				u64 const head = buffer->mHead.load(std::memory_order_acquire);
+				u64 tail = buffer->mTail.load(std::memory_order_relaxed);
+				while (tail < head)
+				{
+					// Write the contiguous part of the ring buffer
+					u64 const begin = tail & mask;
+					u64 count = head - tail;
+					if (count > (mask + 1 - begin))
+						count = mask + 1 - begin;
+
+					sWriteBlock(state, BLOCK_EVENTS, buffer->mIndex, &sRecords(buffer)[begin], (u32)count, sizeof(event_record_t));
+					state->mWritten.fetch_add(count, std::memory_order_relaxed);
+					tail += count;
+					buffer->mTail.store(tail, std::memory_order_release);
+				}
+			}
+		}
+
+		static void		sWriterThread(state_t* state)
+		{
+			std::unique_lock<std::mutex> lock(state->mMutex);
+			while (!state->mStop)
+			{
+				lock.unlock();
+				sDrain(state);
+				lock.lock();
+				if (!state->mStop)
+					state->mWakeup.wait_for(lock, std::chrono::milliseconds(state->mFlushIntervalMs));
+			}
+		}
+	}
+
+	/**
+	 *  Summary:
+	 *      Open the event log and start the writer thread. The arena holds 'max_threads'
+	 *      buffers of 'events_per_thread' records, it is allocated up-front. Returns false
+	 *      when the arena does not fit in a single allocation (4 GB).
+	 */
+	bool		x_EventLogOpen(alloc_t* allocator, const char* filename, u32 events_per_thread, u32 max_threads, u32 flush_interval_ms)
+	{
+		ASSERT(allocator != NULL);
+		ASSERTS(xeventlog::sState == NULL, "x_EventLogOpen: the event log is already open");
+		if (xeventlog::sState != NULL)
+			return false;
+
+		// The allocator takes a 32-bit size, check the arena before anything is created
+		u64 capacity = 64;
+		while (capacity < events_per_thread)
+			capacity <<= 1;
+		u64 buffer_size = sizeof(xeventlog::buffer_t) + capacity * sizeof(event_record_t);
+		buffer_size = (buffer_size + 63) & ~(u64)63;
+		u64 const arena_size = buffer_size * (max_threads > 0 ? max_threads : 1);
+		if (arena_size > 0xffffffff)
+			return false;
+
+		FILE* file = fopen(filename, "wb");
+		if (file == NULL)
+			return false;
+
+		xeventlog::header_t header;
+		header.mMagic = xeventlog::sMagic;
+		header.mVersion = xeventlog::sVersion;
+		header.mTicksPerSecond = x_GetTicksPerSecond();
+		header.mStartTicks = x_GetTime();
+		header.mStartTime = datetime_t::sNowUtc().ticks();
+		if (fwrite(&header, sizeof(header), 1, file) != 1)
+		{
+			fclose(file);
+			return false;
+		}
+
+		xeventlog::state_t* state = new (allocator->allocate(sizeof(xeventlog::state_t), sizeof(void*))) xeventlog::state_t();
+		state->mAllocator = allocator;
+		state->mFile = file;
+		state->mEventsPerThread = (u32)capacity;
+		state->mBufferSize = buffer_size;
+		state->mArenaSize = arena_size;
+		state->mArena = (char*)allocator->allocate((u32)state->mArenaSize, 64);
+		state->mArenaUsed.store(0, std::memory_order_relaxed);
+		state->mFlushIntervalMs = flush_interval_ms > 0 ? flush_interval_ms : 1;
+		state->mBuffers.store(NULL, std::memory_order_relaxed);
+		state->mNumThreads.store(0, std::memory_order_relaxed);
+		state->mDropped.store(0, std::memory_order_relaxed);
+		state->mWritten.store(0, std::memory_order_relaxed);
+		state->mError = false;
+		state->mStop = false;
+
+		xeventlog::sState = state;
+		xeventlog::sGeneration.fetch_add(1, std::memory_order_release);
+		state->mWriter = std::thread(xeventlog::sWriterThread, state);
+		return true;
+	}
+
+	/**
+	 *  Summary:
+	 *      Stop the writer thread, write all remaining events and close the file.
+	 *      No thread should write events while the log is closed.
+	 */
+	bool		x_EventLogClose()
+	{
+		xeventlog::state_t* state = xeventlog::sState;
+		if (state == NULL)
+			return false;
+
+		{
+			std::lock_guard<std::mutex> lock(state->mMutex);
+			state->mStop = true;
+		}
+		state->mWakeup.notify_one();
+		state->mWriter.join();
+
+		xeventlog::sState = NULL;
+		xeventlog::sGeneration.fetch_add(1, std::memory_order_release);
+		xeventlog::sDrain(state);
+
+		bool const ok = !state->mError && fclose(state->mFile) == 0;
+		alloc_t* allocator = state->mAllocator;
+		allocator->deallocate(state->mArena);
+		state->~state_t();
+		allocator->deallocate(state);
+		return ok;
+	}
+
+	bool		x_EventLogIsOpen()
+	{
+		return xeventlog::sState != NULL;
+	}
+
+	bool		x_EventLogWrite(u32 id, u64 payload)
+	{
+		xeventlog::buffer_t* buffer = xeventlog::sAcquireBuffer();
+		if (buffer == NULL)
+		{
+			if (xeventlog::sState != NULL)
+				xeventlog::sState->mDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		u64 const head = buffer->mHead.load(std::memory_order_relaxed);
+		u64 const mask = buffer->mMask;
+		if (head - buffer->mTail.load(std::memory_order_acquire) > mask)
+		{
+			buffer->mDropped.store(buffer->mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		event_record_t& record = xeventlog::sRecords(buffer)[head & mask];
+		record.mTime = x_GetTime();
+		record.mPayload = payload;
+		record.mId = id;
+		record.mThread = buffer->mIndex;
+		buffer->mHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 *  Summary:
+	 *      Name the calling thread in the log, this should be done once when the
+	 *      thread starts.
+	 */
+	void		x_EventLogSetThreadName(const char* name)
+	{
+		xeventlog::buffer_t* buffer = xeventlog::sAcquireBuffer();
+		if (buffer == NULL)
+			return;
+
+		u32 const serial = buffer->mNameSerial.load(std::memory_order_relaxed);
+		buffer->mNameSerial.store(serial + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		u32 i = 0;
+		for (; name[i] != '\0' && i < sizeof(buffer->mName) - 1; ++i)
+			buffer->mName[i].store(name[i], std::memory_order_relaxed);
+		buffer->mName[i].store('\0', std::memory_order_relaxed);
+		buffer->mNameSerial.store(serial + 2, std::memory_order_release);
+	}
+
+	/**
+	 *  Summary:
+	 *      The number of events written to the file so far, this is updated by the
+	 *      writer thread.
+	 */
+	u64			x_EventLogGetNumWritten()
+	{
+		xeventlog::state_t* state = xeventlog::sState;
+		if (state == NULL)
+			return 0;
+		return state->mWritten.load(std::memory_order_relaxed);
+	}
+
+	u64			x_EventLogGetNumDropped()
+	{
+		xeventlog::state_t* state = xeventlog::sState;
+		if (state == NULL)
+			return 0;
+		u64 dropped = state->mDropped.load(std::memory_order_relaxed);
+		for (xeventlog::buffer_t* buffer = state->mBuffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->mNext)
+			dropped += buffer->mDropped.load(std::memory_order_relaxed);
+		return dropped;
+	}
+
+	/**
+	 * event_log_reader_t
+	 */
+	event_log_reader_t::event_log_reader_t()
+		: mFile(NULL)
+		, mAllocator(NULL)
+		, mTicksPerSecond(1)
+		, mStartTicks(0)
+		, mStartTime(0)
+		, mRemaining(0)
+		, mNames(NULL)
+		, mMaxNames(0)
+	{
+	}
+
+	event_log_reader_t::~event_log_reader_t()
+	{
+		ASSERTS(mFile == NULL, "event_log_reader_t: close() was not called");
+	}
+
+	bool		event_log_reader_t::open(const char* filename, alloc_t* allocator)
+	{
+		ASSERT(mFile == NULL);
+		FILE* file = fopen(filename, "rb");
+		if (file == NULL)
+			return false;
+
+		xeventlog::header_t header;
+		if (fread(&header, sizeof(header), 1, file) != 1 || header.mMagic != xeventlog::sMagic || header.mVersion != xeventlog::sVersion || header.mTicksPerSecond <= 0)
+		{
+			fclose(file);
+			return false;
+		}
+
+		mFile = file;
+		mAllocator = allocator;
+		mTicksPerSecond = header.mTicksPerSecond;
+		mStartTicks = header.mStartTicks;
+		mStartTime = header.mStartTime;
+		mRemaining = 0;
+		return true;
+	}
+
+	void		event_log_reader_t::close()
+	{
+		if (mFile == NULL)
+			return;
+		fclose((FILE*)mFile);
+		if (mNames != NULL)
+			mAllocator->deallocate(mNames);
+		mFile = NULL;
+		mNames = NULL;
+		mMaxNames = 0;
+		mAllocator = NULL;
+	}
+
+	// Move to the next EVENTS block, NAME blocks on the way are recorded
+	bool		event_log_reader_t::readBlock()
+	{
+		FILE* file = (FILE*)mFile;
+		xeventlog::block_t block;
+		while (fread(&block, sizeof(block), 1, file) == 1)
+		{
+			if (block.mType == xeventlog::BLOCK_EVENTS)
+			{
+				mRemaining = block.mCount;
+				if (mRemaining > 0)
+					return true;
+			}
+			else if (block.mType == xeventlog::BLOCK_NAME)
+			{
+				char name[NAME_LENGTH];
+				u32 const length = block.mCount < NAME_LENGTH ? block.mCount : NAME_LENGTH - 1;
+				if (fread(name, 1, length, file) != length)
+					return false;
+				if (block.mCount > length && fseek(file, block.mCount - length, SEEK_CUR) != 0)
+					return false;
+				name[length] = '\0';
+				setThreadName(block.mThread, name);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return false;
+	}
+
+	bool		event_log_reader_t::read(event_record_t& record)
+	{
+		if (mFile == NULL)
+			return false;
+		if (mRemaining == 0 && !readBlock())
+			return false;
+		if (fread(&record, sizeof(record), 1, (FILE*)mFile) != 1)
+			return false;
+		mRemaining--;
+		return true;
+	}
+
+	void		event_log_reader_t::setThreadName(u32 thread, const char* name)
+	{
+		if (thread >= mMaxNames)
+		{
+			u32 const max_names = (thread + 16) & ~15;
+			char* names = (char*)mAllocator->allocate(max_names * NAME_LENGTH, sizeof(void*));
+			for (u32 i = 0; i < max_names * NAME_LENGTH; ++i)
+				names[i] = i < mMaxNames * NAME_LENGTH ? mNames[i] : '\0';
+			if (mNames != NULL)
+				mAllocator->deallocate(mNames);
+			mNames = names;
+			mMaxNames = max_names;
+		}
+
+		char* dst = &mNames[thread * NAME_LENGTH];
+		u32 i = 0;
+		for (; name[i] != '\0' && i < NAME_LENGTH - 1; ++i)
+			dst[i] = name[i];
+		dst[i] = '\0';
+	}
+
+	const char*	event_log_reader_t::getThreadName(u32 thread) const
+	{
+		return thread < mMaxNames ? &mNames[thread * NAME_LENGTH] : "";
+	}
+
+	f64			event_log_reader_t::toSeconds(tick_t ticks) const
+	{
+		return (f64)(ticks - mStartTicks) / (f64)mTicksPerSecond;
+	}
+
+	s64			event_log_reader_t::toMicroseconds(tick_t ticks) const
+	{
+		s64 const t = ticks - mStartTicks;
+		return (t / mTicksPerSecond) * 1000000 + ((t % mTicksPerSecond) * 1000000) / mTicksPerSecond;
+	}
+
+	datetime_t	event_log_reader_t::toDateTime(tick_t ticks) const
+	{
+		// datetime_t ticks are 100 nanosecond units
+		s64 const t = ticks - mStartTicks;
+		s64 const span = (t / mTicksPerSecond) * 10000000 + ((t % mTicksPerSecond) * 10000000) / mTicksPerSecond;
+		return datetime_t((u64)((s64)mStartTime + span));
+	}
+};
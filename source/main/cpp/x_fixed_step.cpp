@@ -0,0 +1,83 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_fixed_step.h"
+
+namespace xcore
+{
+	fixed_step_t::fixed_step_t()
+		: mStepNum(1)
+		, mStepDen(1)
+		, mAccumulator(0)
+		, mMaxSteps(8)
+		, mLastTime(0)
+		, mNumSteps(0)
+		, mNumDropped(0)
+	{
+	}
+
+	void		fixed_step_t::setStepRate(u32 rate)
+	{
+		ASSERT(rate > 0);
+		// Keep the accumulated fraction of a step
+		f64 const alpha = getAlpha();
+		mStepNum = x_GetTicksPerSecond();
+		mStepDen = rate;
+		mAccumulator = (s64)(alpha * (f64)mStepNum);
+	}
+
+	void		fixed_step_t::setStep(tick_t ticks)
+	{
+		ASSERT(ticks > 0);
+		f64 const alpha = getAlpha();
+		mStepNum = ticks;
+		mStepDen = 1;
+		mAccumulator = (s64)(alpha * (f64)mStepNum);
+	}
+
+	f64			fixed_step_t::getStepSec() const
+	{
+		return ((f64)mStepNum / (f64)mStepDen) / (f64)x_GetTicksPerSecond();
+	}
+
+	void		fixed_step_t::restart(tick_t now)
+	{
+		mLastTime = now;
+		mAccumulator = 0;
+		mNumSteps = 0;
+		mNumDropped = 0;
+	}
+
+	u32			fixed_step_t::update(tick_t now)
+	{
+		tick_t const elapsed = now - mLastTime;
+		mLastTime = now;
+		return advance(elapsed);
+	}
+
+	u32			fixed_step_t::advance(tick_t elapsed)
+	{
+		if (elapsed <= 0)
+			return 0;
+
+		mAccumulator += elapsed * mStepDen;
+		s64 steps = mAccumulator / mStepNum;
+		mAccumulator -= steps * mStepNum;
+
+		if (steps > (s64)mMaxSteps)
+		{
+			mNumDropped += (u64)(steps - mMaxSteps);
+			steps = mMaxSteps;
+		}
+		mNumSteps += (u64)steps;
+		return (u32)steps;
+	}
+
+	// Split to avoid overflow on long sessions
+	tick_t		fixed_step_t::getTime() const
+	{
+		u64 const den = (u64)mStepDen;
+		u64 const num = (u64)mStepNum;
+		return (tick_t)((mNumSteps / den) * num + ((mNumSteps % den) * num) / den);
+	}
+};
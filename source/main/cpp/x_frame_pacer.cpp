@@ -0,0 +1,92 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_sleep.h"
+#include "xtime/x_frame_rate.h"
+#include "xtime/x_frame_pacer.h"
+
+namespace xcore
+{
+	frame_pacer_t::frame_pacer_t()
+		: mPeriod(0)
+		, mNextDeadline(0)
+		, mFrameRate(NULL)
+		, mNumFrames(0)
+		, mNumMissed(0)
+	{
+	}
+
+	void		frame_pacer_t::setTargetRate(f64 fps)
+	{
+		ASSERTS(fps > 0.0, "frame_pacer_t: the target frame rate should be larger than 0");
+		setTargetPeriod((tick_t)((f64)x_GetTicksPerSecond() / fps));
+	}
+
+	void		frame_pacer_t::setTargetPeriod(tick_t period)
+	{
+		ASSERTS(period > 0, "frame_pacer_t: the target period should be larger than 0");
+		// The old schedule does not apply anymore, the next wait starts a new one
+		if (period != mPeriod)
+			mNextDeadline = 0;
+		mPeriod = period;
+	}
+
+	f64			frame_pacer_t::getTargetRate() const
+	{
+		if (mPeriod <= 0)
+			return 0.0;
+		return (f64)x_GetTicksPerSecond() / (f64)mPeriod;
+	}
+
+	/**
+	 *  Summary:
+	 *      Start a new schedule, the first frame boundary is one period from now.
+	 */
+	void		frame_pacer_t::restart()
+	{
+		mNextDeadline = x_GetTime() + mPeriod;
+	}
+
+	/**
+	 *  Summary:
+	 *      Wait until the next frame boundary. Without a schedule, restart() was not
+	 *      called or the period changed, the boundary is one period from now.
+	 *  Returns:
+	 *      The time at which the pacer returned, this is the start time of the new frame.
+	 */
+	tick_t		frame_pacer_t::waitForNextFrame()
+	{
+		ASSERTS(mPeriod > 0, "frame_pacer_t: no target rate or period set");
+
+		tick_t now = x_GetTime();
+		if (mNextDeadline == 0)
+			mNextDeadline = now + mPeriod;
+
+		if (now > mNextDeadline)
+		{
+			// Overran the frame boundary, skip ahead to the first boundary in the future
+			tick_t const missed = 1 + (now - mNextDeadline) / mPeriod;
+			mNumMissed += (u64)missed;
+			mNextDeadline += missed * mPeriod;
+		}
+		else
+		{
+			x_SleepUntil(mNextDeadline);
+			now = x_GetTime();
+			mJitter.add(x_TicksToUs(now - mNextDeadline));
+			mNextDeadline += mPeriod;
+		}
+
+		mNumFrames++;
+		if (mFrameRate != NULL)
+			mFrameRate->markFrame(now);
+		return now;
+	}
+
+	void		frame_pacer_t::resetStats()
+	{
+		mNumFrames = 0;
+		mNumMissed = 0;
+		mJitter.reset();
+	}
+};
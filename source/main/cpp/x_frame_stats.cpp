@@ -0,0 +1,359 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_frame_stats.h"
+#include "xtime/private/x_time_bits.h"
+
+#include <math.h>
+
+namespace xcore
+{
+	/**
+	 * Log-linear histogram of frame times in microseconds
+	 *
+	 * Values below 128 us have their own bin, above that every power of two is
+	 * split into 64 bins. The largest tracked value is 2^32-1 us (~71 minutes).
+	 */
+	namespace xframestats
+	{
+		static const u32		sSubBits = 6;
+		static const u32		sSubCount = 1 << sSubBits;
+		static const u32		sNumBins = 27 * sSubCount;
+		static const u32		sNumGroups = sNumBins / sSubCount;
+
+		static inline u32		sBinOf(u32 us)
+		{
+			s32 const e = xtime_bitwidth64(us) - (s32)(sSubBits + 1);
+			if (e <= 0)
+				return us;
+			return (u32)e * sSubCount + (us >> e);
+		}
+
+		// The value in the middle of a bin, in microseconds
+		static inline f64		sBinValue(u32 bin)
+		{
+			if (bin < 2 * sSubCount)
+				return (f64)bin;
+			u32 const e = bin / sSubCount - 1;
+			u64 const lo = (u64)(bin - e * sSubCount) << e;
+			return (f64)lo + (f64)(((u64)1 << e) - 1) * 0.5;
+		}
+
+		static inline u32		sTicksToUs(tick_t ticks)
+		{
+			if (ticks <= 0)
+				return 0;
+			u64 const us = ((u64)ticks * 1000000 + (u64)(x_GetTicksPerSecond() / 2)) / (u64)x_GetTicksPerSecond();
+			return us > 0xffffffff ? 0xffffffff : (u32)us;
+		}
+	}
+
+	frame_stats_t::frame_stats_t()
+		: mAllocator(NULL)
+		, mFrames(NULL)
+		, mMinQueue(NULL)
+		, mMaxQueue(NULL)
+		, mBins(NULL)
+		, mGroups(NULL)
+		, mCapacity(0)
+		, mMask(0)
+		, mWindow(0)
+		, mCount(0)
+		, mNextSeq(0)
+		, mMinHead(0), mMinTail(0)
+		, mMaxHead(0), mMaxTail(0)
+		, mSum(0)
+		, mSumSq(0)
+		, mLastMark(0)
+		, mMarked(false)
+	{
+	}
+
+	frame_stats_t::~frame_stats_t()
+	{
+		ASSERTS(mAllocator == NULL, "frame_stats_t: exit() was not called");
+	}
+
+	/**
+	 *  Summary:
+	 *      Allocate the ring buffer, the capacity is rounded up to a power of two.
+	 *      The window is initialized to the full capacity.
+	 */
+	void		frame_stats_t::init(alloc_t* allocator, u32 capacity)
+	{
+		ASSERT(allocator != NULL && capacity > 0);
+		mAllocator = allocator;
+
+		mCapacity = 1;
+		while (mCapacity < capacity)
+			mCapacity <<= 1;
+		mMask = mCapacity - 1;
+
+		mFrames = (u32*)allocator->allocate(mCapacity * sizeof(u32), sizeof(u32));
+		mMinQueue = (u64*)allocator->allocate(mCapacity * sizeof(u64), sizeof(u64));
+		mMaxQueue = (u64*)allocator->allocate(mCapacity * sizeof(u64), sizeof(u64));
+		mBins = (u32*)allocator->allocate(xframestats::sNumBins * sizeof(u32), sizeof(u32));
+		mGroups = (u32*)allocator->allocate(xframestats::sNumGroups * sizeof(u32), sizeof(u32));
+
+		mWindow = mCapacity;
+		reset();
+	}
+
+	void		frame_stats_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		mAllocator->deallocate(mFrames);
+		mAllocator->deallocate(mMinQueue);
+		mAllocator->deallocate(mMaxQueue);
+		mAllocator->deallocate(mBins);
+		mAllocator->deallocate(mGroups);
+		mFrames = NULL;
+		mMinQueue = NULL;
+		mMaxQueue = NULL;
+		mBins = NULL;
+		mGroups = NULL;
+		mAllocator = NULL;
+		mCapacity = 0;
+	}
+
+	void		frame_stats_t::reset()
+	{
+		for (u32 i = 0; i < xframestats::sNumBins; ++i)
+			mBins[i] = 0;
+		for (u32 i = 0; i < xframestats::sNumGroups; ++i)
+			mGroups[i] = 0;
+		mCount = 0;
+		mNextSeq = 0;
+		mMinHead = mMinTail = 0;
+		mMaxHead = mMaxTail = 0;
+		mSum = 0;
+		mSumSq = 0;
+		mMarked = false;
+	}
+
+	/**
+	 *  Summary:
+	 *      Change the number of most recent frames the statistics are computed over.
+	 *      This rebuilds the statistics from the ring buffer, O(window).
+	 */
+	void		frame_stats_t::setWindow(u32 frames)
+	{
+		ASSERTS(frames > 0 && frames <= mCapacity, "frame_stats_t: window does not fit in the capacity");
+		mWindow = frames == 0 ? 1 : (frames > mCapacity ? mCapacity : frames);
+
+		u64 const available = mNextSeq < mCapacity ? mNextSeq : mCapacity;
+		u64 const first = mNextSeq - (available < mWindow ? available : mWindow);
+
+		for (u32 i = 0; i < xframestats::sNumBins; ++i)
+			mBins[i] = 0;
+		for (u32 i = 0; i < xframestats::sNumGroups; ++i)
+			mGroups[i] = 0;
+		mCount = 0;
+		mMinHead = mMinTail = 0;
+		mMaxHead = mMaxTail = 0;
+		mSum = 0;
+		mSumSq = 0;
+
+		for (u64 seq = first; seq < mNextSeq; ++seq)
+			insert(seq);
+	}
+
+	void		frame_stats_t::insert(u64 seq)
+	{
+		u32 const us = at(seq);
+		mSum += us;
+		mSumSq += (u64)us * us;
+		u32 const bin = xframestats::sBinOf(us);
+		mBins[bin]++;
+		mGroups[bin >> xframestats::sSubBits]++;
+		mCount++;
+
+		while (mMinTail > mMinHead && at(mMinQueue[(mMinTail - 1) & mMask]) >= us)
+			mMinTail--;
+		mMinQueue[(mMinTail++) & mMask] = seq;
+
+		while (mMaxTail > mMaxHead && at(mMaxQueue[(mMaxTail - 1) & mMask]) <= us)
+			mMaxTail--;
+		mMaxQueue[(mMaxTail++) & mMask] = seq;
+	}
+
+	void		frame_stats_t::remove(u64 seq)
+	{
+		u32 const us = at(seq);
+		mSum -= us;
+		mSumSq -= (u64)us * us;
+		u32 const bin = xframestats::sBinOf(us);
+		mBins[bin]--;
+		mGroups[bin >> xframestats::sSubBits]--;
+		mCount--;
+
+		if (mMinTail > mMinHead && mMinQueue[mMinHead & mMask] == seq)
+			mMinHead++;
+		if (mMaxTail > mMaxHead && mMaxQueue[mMaxHead & mMask] == seq)
+			mMaxHead++;
+	}
+
+	void		frame_stats_t::addFrame(tick_t duration)
+	{
+		// The frame leaving the window has to be removed before its slot in the
+		// ring buffer is overwritten (when window == capacity).
+		if (mCount == mWindow)
+			remove(mNextSeq - mWindow);
+
+		mFrames[mNextSeq & mMask] = xframestats::sTicksToUs(duration);
+		insert(mNextSeq);
+		mNextSeq++;
+	}
+
+	/**
+	 *  Summary:
+	 *      Add the time since the previous call to markFrame() as a frame, the first
+	 *      call only marks the start of the first frame.
+	 */
+	void		frame_stats_t::markFrame()
+	{
+		tick_t const now = x_GetTime();
+		if (mMarked)
+			addFrame(now - mLastMark);
+		mLastMark = now;
+		mMarked = true;
+	}
+
+	f64			frame_stats_t::getMinMs() const
+	{
+		if (mCount == 0)
+			return 0.0;
+		return (f64)at(mMinQueue[mMinHead & mMask]) / 1000.0;
+	}
+
+	f64			frame_stats_t::getMaxMs() const
+	{
+		if (mCount == 0)
+			return 0.0;
+		return (f64)at(mMaxQueue[mMaxHead & mMask]) / 1000.0;
+	}
+
+	f64			frame_stats_t::getMeanMs() const
+	{
+		if (mCount == 0)
+			return 0.0;
+		return ((f64)mSum / (f64)mCount) / 1000.0;
+	}
+
+	f64			frame_stats_t::getStdDevMs() const
+	{
+		if (mCount < 2)
+			return 0.0;
+		f64 const n = (f64)mCount;
+		f64 const sum = (f64)mSum;
+		f64 variance = ((f64)mSumSq - (sum * sum) / n) / (n - 1.0);
+		if (variance < 0.0)
+			variance = 0.0;
+		return sqrt(variance) / 1000.0;
+	}
+
+	/**
+	 *  Summary:
+	 *      The frame time (ms) below which 'percentile' percent of the frames in the
+	 *      window fall, e.g. 99.0 for the 99th percentile.
+	 */
+	f64			frame_stats_t::getPercentileMs(f64 percentile) const
+	{
+		if (mCount == 0)
+			return 0.0;
+
+		u32 rank = (u32)ceil((percentile / 100.0) * (f64)mCount);
+		if (rank < 1)
+			rank = 1;
+		if (rank > mCount)
+			rank = mCount;
+
+		u32 group = 0;
+		u32 cumulative = 0;
+		while (cumulative + mGroups[group] < rank)
+			cumulative += mGroups[group++];
+
+		u32 bin = group << xframestats::sSubBits;
+		while (cumulative + mBins[bin] < rank)
+			cumulative += mBins[bin++];
+
+		f64 us = xframestats::sBinValue(bin);
+		f64 const lo = (f64)at(mMinQueue[mMinHead & mMask]);
+		f64 const hi = (f64)at(mMaxQueue[mMaxHead & mMask]);
+		if (us < lo)
+			us = lo;
+		if (us > hi)
+			us = hi;
+		return us / 1000.0;
+	}
+
+	/**
+	 *  Summary:
+	 *      The average frame time (ms) of the slowest 'percent' percent of the frames
+	 *      in the window, e.g. 1.0 for the 1% low.
+	 */
+	f64			frame_stats_t::getLowMs(f64 percent) const
+	{
+		if (mCount == 0)
+			return 0.0;
+
+		u32 wanted = (u32)ceil((percent / 100.0) * (f64)mCount);
+		if (wanted < 1)
+			wanted = 1;
+		u32 const total = wanted;
+
+		// The slowest frame is known exactly
+		f64 sum = (f64)at(mMaxQueue[mMaxHead & mMask]);
+		wanted--;
+
+		s32 group = (s32)xframestats::sNumGroups - 1;
+		u32 skip = 1;
+		while (wanted > 0 && group >= 0)
+		{
+			if (mGroups[group] <= skip)
+			{
+				skip -= mGroups[group];
+				group--;
+				continue;
+			}
+			for (s32 bin = ((group + 1) << xframestats::sSubBits) - 1; bin >= (group << xframestats::sSubBits) && wanted > 0; --bin)
+			{
+				u32 count = mBins[bin];
+				if (skip > 0)
+				{
+					u32 const s = count < skip ? count : skip;
+					count -= s;
+					skip -= s;
+				}
+				u32 const take = count < wanted ? count : wanted;
+				sum += (f64)take * xframestats::sBinValue((u32)bin);
+				wanted -= take;
+			}
+			group--;
+		}
+
+		return (sum / (f64)total) / 1000.0;
+	}
+
+	f64			frame_stats_t::getLowFps(f64 percent) const
+	{
+		f64 const ms = getLowMs(percent);
+		return ms > 0.0 ? 1000.0 / ms : 0.0;
+	}
+
+	void		frame_stats_t::getSummary(frame_stats_summary_t& summary) const
+	{
+		summary.mNumFrames = mCount;
+		summary.mMinMs = getMinMs();
+		summary.mMaxMs = getMaxMs();
+		summary.mMeanMs = getMeanMs();
+		summary.mStdDevMs = getStdDevMs();
+		summary.mP50Ms = getPercentileMs(50.0);
+		summary.mP95Ms = getPercentileMs(95.0);
+		summary.mP99Ms = getPercentileMs(99.0);
+		summary.mLow1Ms = getLowMs(1.0);
+		summary.mLow01Ms = getLowMs(0.1);
+	}
+};
@@ -23,9 +23,12 @@ namespace xcore
 
 	void		framerate_t::markFrame()
 	{
-		m_dwNumFrames += 1.0f;
+		markFrame(x_GetTime());
+	}
 
-		tick_t tTime = x_GetTime();
+	void		framerate_t::markFrame(tick_t tTime)
+	{
+		m_dwNumFrames += 1.0f;
 
 		// Only re-compute the FPS (frames per second) once per second
 		if ( (tTime - m_tLastFPSTime) >= x_GetTicksPerSecond() )
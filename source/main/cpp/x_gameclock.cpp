@@ -0,0 +1,123 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_gameclock.h"
+
+namespace xcore
+{
+	gameclock_t::gameclock_t()
+		: mParent(NULL)
+		, mFirstChild(NULL)
+		, mNextSibling(NULL)
+		, mBase(0)
+		, mAnchor(0)
+		, mRate(0.0)
+		, mScale(1.0)
+		, mPaused(false)
+		, mInitialized(false)
+		, mLastTrip(0)
+	{
+	}
+
+	gameclock_t::~gameclock_t()
+	{
+		ASSERTS(!mInitialized, "gameclock_t: exit() was not called");
+	}
+
+	void		gameclock_t::init(gameclock_t* parent)
+	{
+		ASSERTS(!mInitialized, "gameclock_t: already initialized");
+		mParent = parent;
+		mFirstChild = NULL;
+		mNextSibling = NULL;
+		if (parent != NULL)
+		{
+			mNextSibling = parent->mFirstChild;
+			parent->mFirstChild = this;
+		}
+		mScale = 1.0;
+		mPaused = false;
+		mInitialized = true;
+
+		mAnchor = x_GetTime();
+		mBase = 0;
+		mLastTrip = 0;
+		mRate = parent != NULL ? parent->mRate : 1.0;
+	}
+
+	void		gameclock_t::exit()
+	{
+		if (!mInitialized)
+			return;
+		ASSERTS(mFirstChild == NULL, "gameclock_t: exit the children first");
+		if (mParent != NULL)
+		{
+			gameclock_t** link = &mParent->mFirstChild;
+			while (*link != this)
+				link = &(*link)->mNextSibling;
+			*link = mNextSibling;
+		}
+		mParent = NULL;
+		mNextSibling = NULL;
+		mInitialized = false;
+	}
+
+	tick_t		gameclock_t::trip()
+	{
+		tick_t const local = now();
+		tick_t const delta = local - mLastTrip;
+		mLastTrip = local;
+		return delta;
+	}
+
+	void		gameclock_t::set(tick_t local)
+	{
+		tick_t const real = x_GetTime();
+		mBase = local;
+		mAnchor = real;
+		mLastTrip = local;
+	}
+
+	void		gameclock_t::setScale(f64 scale)
+	{
+		ASSERTS(scale >= 0.0, "gameclock_t: the scale can not be negative");
+		if (scale == mScale)
+			return;
+		mScale = scale;
+		update(x_GetTime());
+	}
+
+	void		gameclock_t::pause()
+	{
+		if (mPaused)
+			return;
+		mPaused = true;
+		update(x_GetTime());
+	}
+
+	void		gameclock_t::resume()
+	{
+		if (!mPaused)
+			return;
+		mPaused = false;
+		update(x_GetTime());
+	}
+
+	// Continue the local time from where the current transform has it at 'real'
+	void		gameclock_t::rebase(tick_t real)
+	{
+		mBase = now(real);
+		mAnchor = real;
+	}
+
+	// Every transform in the subtree is re-anchored with its old rate before the
+	// new rate is applied, a child always sees the new rate of its parent.
+	void		gameclock_t::update(tick_t real)
+	{
+		rebase(real);
+		f64 const parent = mParent != NULL ? mParent->mRate : 1.0;
+		mRate = mPaused ? 0.0 : parent * mScale;
+		for (gameclock_t* child = mFirstChild; child != NULL; child = child->mNextSibling)
+			child->update(real);
+	}
+};
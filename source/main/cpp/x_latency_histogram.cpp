@@ -0,0 +1,252 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_latency_histogram.h"
+#include "xtime/private/x_time_bits.h"
+
+#include <atomic>
+#include <math.h>
+#include <new>
+
+namespace xcore
+{
+	/**
+	 * All counters are only written by the thread that records into the histogram,
+	 * a relaxed load followed by a relaxed store is enough (no locked instructions),
+	 * while readers in other threads still get untorn values.
+	 */
+	struct latency_histogram_t::counters_t
+	{
+		std::atomic<u64>		mTotalCount;
+		std::atomic<u64>		mOverflowCount;
+		std::atomic<s64>		mMin;
+		std::atomic<s64>		mMax;
+		std::atomic<u64>		mSum;
+		std::atomic<u64>*		mBuckets;
+	};
+
+	static inline void	sAddRelaxed(std::atomic<u64>& counter, u64 value)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	static const s64	sNoMin = X_CONSTANT_64(0x7fffffffffffffff);
+
+	latency_histogram_t::latency_histogram_t()
+		: mAllocator(NULL)
+		, mCounters(NULL)
+		, mPrecisionBits(0)
+		, mNumBuckets(0)
+		, mMaxValue(0)
+	{
+	}
+
+	latency_histogram_t::~latency_histogram_t()
+	{
+		ASSERTS(mAllocator == NULL, "latency_histogram_t: exit() was not called");
+	}
+
+	/**
+	 *  Summary:
+	 *      Initialize the histogram.
+	 *  Arguments:
+	 *      precision_bits: 1 to 16, number of sub-buckets per power of two is 2^precision_bits
+	 *      max_value:      the largest value that can be recorded without clamping
+	 */
+	void		latency_histogram_t::init(alloc_t* allocator, u32 precision_bits, tick_t max_value)
+	{
+		ASSERT(allocator != NULL);
+		ASSERTS(precision_bits >= 1 && precision_bits <= 16, "latency_histogram_t: precision_bits should be 1 to 16");
+		mAllocator = allocator;
+		mPrecisionBits = precision_bits;
+
+		tick_t const smallest_max = ((tick_t)1 << (precision_bits + 1)) - 1;
+		mMaxValue = max_value < smallest_max ? smallest_max : max_value;
+		mNumBuckets = getBucketIndex(mMaxValue) + 1;
+
+		mCounters = new (allocator->allocate(sizeof(counters_t), 64)) counters_t();
+		mCounters->mBuckets = (std::atomic<u64>*)allocator->allocate(mNumBuckets * (u32)sizeof(std::atomic<u64>), 64);
+		for (u32 i = 0; i < mNumBuckets; ++i)
+			new (&mCounters->mBuckets[i]) std::atomic<u64>();
+		reset();
+	}
+
+	void		latency_histogram_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		mAllocator->deallocate(mCounters->mBuckets);
+		mAllocator->deallocate(mCounters);
+		mCounters = NULL;
+		mAllocator = NULL;
+		mNumBuckets = 0;
+	}
+
+	void		latency_histogram_t::reset()
+	{
+		mCounters->mTotalCount.store(0, std::memory_order_relaxed);
+		mCounters->mOverflowCount.store(0, std::memory_order_relaxed);
+		mCounters->mMin.store(sNoMin, std::memory_order_relaxed);
+		mCounters->mMax.store(0, std::memory_order_relaxed);
+		mCounters->mSum.store(0, std::memory_order_relaxed);
+		for (u32 i = 0; i < mNumBuckets; ++i)
+			mCounters->mBuckets[i].store(0, std::memory_order_relaxed);
+	}
+
+	u32			latency_histogram_t::getBucketIndex(tick_t value) const
+	{
+		u64 const v = value < 0 ? 0 : (u64)value;
+		s32 const e = xtime_bitwidth64(v) - (s32)(mPrecisionBits + 1);
+		if (e <= 0)
+			return (u32)v;
+		return ((u32)e << mPrecisionBits) + (u32)(v >> e);
+	}
+
+	tick_t		latency_histogram_t::getBucketLowest(u32 index) const
+	{
+		u32 const sub_count = 1 << mPrecisionBits;
+		if (index < 2 * sub_count)
+			return (tick_t)index;
+		u32 const e = (index >> mPrecisionBits) - 1;
+		return (tick_t)(index - (e << mPrecisionBits)) << e;
+	}
+
+	tick_t		latency_histogram_t::getBucketHighest(u32 index) const
+	{
+		u32 const sub_count = 1 << mPrecisionBits;
+		if (index < 2 * sub_count)
+			return (tick_t)index;
+		u32 const e = (index >> mPrecisionBits) - 1;
+		return getBucketLowest(index) + (((tick_t)1 << e) - 1);
+	}
+
+	u64			latency_histogram_t::getBucketCount(u32 index) const
+	{
+		return mCounters->mBuckets[index].load(std::memory_order_relaxed);
+	}
+
+	void		latency_histogram_t::record(tick_t value)
+	{
+		recordValues(value, 1);
+	}
+
+	void		latency_histogram_t::recordValues(tick_t value, u64 count)
+	{
+		if (value < 0)
+			value = 0;
+		if (value > mMaxValue)
+		{
+			sAddRelaxed(mCounters->mOverflowCount, count);
+			value = mMaxValue;
+		}
+
+		sAddRelaxed(mCounters->mBuckets[getBucketIndex(value)], count);
+		sAddRelaxed(mCounters->mTotalCount, count);
+		sAddRelaxed(mCounters->mSum, (u64)value * count);
+		if (value < mCounters->mMin.load(std::memory_order_relaxed))
+			mCounters->mMin.store(value, std::memory_order_relaxed);
+		if (value > mCounters->mMax.load(std::memory_order_relaxed))
+			mCounters->mMax.store(value, std::memory_order_relaxed);
+	}
+
+	/**
+	 *  Summary:
+	 *      Copy the counters into 'out', which must have been initialized with the same
+	 *      precision and maximum value. Can be called from any thread.
+	 */
+	void		latency_histogram_t::snapshot(latency_histogram_t& out) const
+	{
+		ASSERTS(out.mPrecisionBits == mPrecisionBits && out.mNumBuckets == mNumBuckets, "latency_histogram_t: snapshot into a histogram with a different layout");
+		for (u32 i = 0; i < mNumBuckets; ++i)
+			out.mCounters->mBuckets[i].store(mCounters->mBuckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		out.mCounters->mTotalCount.store(mCounters->mTotalCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		out.mCounters->mOverflowCount.store(mCounters->mOverflowCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		out.mCounters->mSum.store(mCounters->mSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		out.mCounters->mMin.store(mCounters->mMin.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		out.mCounters->mMax.store(mCounters->mMax.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	/**
+	 *  Summary:
+	 *      Add the counters of 'other' to this histogram, both must have the same layout.
+	 *      The calling thread must be the (only) writer of this histogram.
+	 */
+	void		latency_histogram_t::merge(const latency_histogram_t& other)
+	{
+		ASSERTS(other.mPrecisionBits == mPrecisionBits && other.mNumBuckets == mNumBuckets, "latency_histogram_t: merging histograms with a different layout");
+		for (u32 i = 0; i < mNumBuckets; ++i)
+			sAddRelaxed(mCounters->mBuckets[i], other.mCounters->mBuckets[i].load(std::memory_order_relaxed));
+		sAddRelaxed(mCounters->mTotalCount, other.mCounters->mTotalCount.load(std::memory_order_relaxed));
+		sAddRelaxed(mCounters->mOverflowCount, other.mCounters->mOverflowCount.load(std::memory_order_relaxed));
+		sAddRelaxed(mCounters->mSum, other.mCounters->mSum.load(std::memory_order_relaxed));
+
+		s64 const omin = other.mCounters->mMin.load(std::memory_order_relaxed);
+		if (omin < mCounters->mMin.load(std::memory_order_relaxed))
+			mCounters->mMin.store(omin, std::memory_order_relaxed);
+		s64 const omax = other.mCounters->mMax.load(std::memory_order_relaxed);
+		if (omax > mCounters->mMax.load(std::memory_order_relaxed))
+			mCounters->mMax.store(omax, std::memory_order_relaxed);
+	}
+
+	u64			latency_histogram_t::getTotalCount() const
+	{
+		return mCounters->mTotalCount.load(std::memory_order_relaxed);
+	}
+
+	u64			latency_histogram_t::getOverflowCount() const
+	{
+		return mCounters->mOverflowCount.load(std::memory_order_relaxed);
+	}
+
+	tick_t		latency_histogram_t::getMin() const
+	{
+		s64 const min = mCounters->mMin.load(std::memory_order_relaxed);
+		return min == sNoMin ? 0 : min;
+	}
+
+	tick_t		latency_histogram_t::getMax() const
+	{
+		return mCounters->mMax.load(std::memory_order_relaxed);
+	}
+
+	f64			latency_histogram_t::getMean() const
+	{
+		u64 const count = getTotalCount();
+		if (count == 0)
+			return 0.0;
+		return (f64)mCounters->mSum.load(std::memory_order_relaxed) / (f64)count;
+	}
+
+	/**
+	 *  Summary:
+	 *      The value below which 'percentile' percent of the recorded values fall. Like
+	 *      HdrHistogram this returns the highest value that is equivalent to the bucket
+	 *      it falls in, so it never under-reports a latency.
+	 */
+	tick_t		latency_histogram_t::getValueAtPercentile(f64 percentile) const
+	{
+		u64 const total = getTotalCount();
+		if (total == 0)
+			return 0;
+
+		if (percentile > 100.0)
+			percentile = 100.0;
+		u64 rank = (u64)ceil((percentile / 100.0) * (f64)total);
+		if (rank < 1)
+			rank = 1;
+
+		u64 cumulative = 0;
+		for (u32 i = 0; i < mNumBuckets; ++i)
+		{
+			cumulative += mCounters->mBuckets[i].load(std::memory_order_relaxed);
+			if (cumulative >= rank)
+			{
+				tick_t const value = getBucketHighest(i);
+				tick_t const max = getMax();
+				return value < max ? value : max;
+			}
+		}
+		return getMax();
+	}
+};
@@ -0,0 +1,89 @@
+#include "xbase/x_target.h"
+#ifdef TARGET_MAC
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "xbase/x_debug.h"
+
+#include "xtime/private/x_mapped_file.h"
+
+namespace xcore
+{
+	static inline int	sDescriptor(mapped_file_t& file)
+	{
+		return (int)((uptr)file.mFile - 1);
+	}
+
+	bool			x_MappedFileOpen(mapped_file_t& file, const char* filename, bool writable)
+	{
+		ASSERT(file.mFile == NULL);
+		int const fd = ::open(filename, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+		if (fd < 0)
+			return false;
+		file.mFile = (void*)((uptr)fd + 1);
+		file.mMapping = NULL;
+		file.mBase = NULL;
+		file.mMappedSize = 0;
+		file.mWritable = writable;
+		return true;
+	}
+
+	void			x_MappedFileClose(mapped_file_t& file)
+	{
+		if (file.mFile == NULL)
+			return;
+		x_MappedFileMap(file, 0);
+		::close(sDescriptor(file));
+		file.mFile = NULL;
+	}
+
+	bool			x_MappedFileGetSize(mapped_file_t& file, u64& outSize)
+	{
+		struct stat st;
+		if (fstat(sDescriptor(file), &st) != 0)
+			return false;
+		outSize = (u64)st.st_size;
+		return true;
+	}
+
+	bool			x_MappedFileResize(mapped_file_t& file, u64 size)
+	{
+		ASSERT(file.mWritable && file.mBase == NULL);
+		return ftruncate(sDescriptor(file), (off_t)size) == 0;
+	}
+
+	bool			x_MappedFileMap(mapped_file_t& file, u64 size)
+	{
+		if (file.mBase != NULL)
+		{
+			munmap(file.mBase, (size_t)file.mMappedSize);
+			file.mBase = NULL;
+			file.mMappedSize = 0;
+		}
+		if (size == 0)
+			return true;
+
+		int const prot = file.mWritable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+		void* base = mmap(NULL, (size_t)size, prot, MAP_SHARED, sDescriptor(file), 0);
+		if (base == MAP_FAILED)
+			return false;
+		file.mBase = (u8*)base;
+		file.mMappedSize = size;
+		return true;
+	}
+
+	bool			x_MappedFileFlush(mapped_file_t& file, u64 offset, u64 size)
+	{
+		if (file.mBase == NULL || size == 0)
+			return true;
+		// msync needs a page aligned address
+		u64 const page = (u64)sysconf(_SC_PAGESIZE);
+		u64 const begin = offset & ~(page - 1);
+		return msync(file.mBase + begin, (size_t)(offset + size - begin), MS_SYNC) == 0;
+	}
+};
+
+#endif /// TARGET_MAC
@@ -0,0 +1,102 @@
+#include "xbase/x_target.h"
+#ifdef TARGET_PC
+
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOMB
+#define NOKANJI
+
+#include <windows.h>
+
+#include "xbase/x_debug.h"
+
+#include "xtime/private/x_mapped_file.h"
+
+namespace xcore
+{
+	bool			x_MappedFileOpen(mapped_file_t& file, const char* filename, bool writable)
+	{
+		ASSERT(file.mFile == NULL);
+		DWORD const access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+		// Readers share with a writer that appends, a writer only with readers
+		DWORD const share = writable ? FILE_SHARE_READ : (FILE_SHARE_READ | FILE_SHARE_WRITE);
+		HANDLE handle = CreateFileA(filename, access, share, NULL, writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (handle == INVALID_HANDLE_VALUE)
+			return false;
+		file.mFile = handle;
+		file.mMapping = NULL;
+		file.mBase = NULL;
+		file.mMappedSize = 0;
+		file.mWritable = writable;
+		return true;
+	}
+
+	void			x_MappedFileClose(mapped_file_t& file)
+	{
+		if (file.mFile == NULL)
+			return;
+		x_MappedFileMap(file, 0);
+		CloseHandle((HANDLE)file.mFile);
+		file.mFile = NULL;
+	}
+
+	bool			x_MappedFileGetSize(mapped_file_t& file, u64& outSize)
+	{
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx((HANDLE)file.mFile, &size))
+			return false;
+		outSize = (u64)size.QuadPart;
+		return true;
+	}
+
+	bool			x_MappedFileResize(mapped_file_t& file, u64 size)
+	{
+		ASSERT(file.mWritable && file.mBase == NULL);
+		LARGE_INTEGER position;
+		position.QuadPart = (LONGLONG)size;
+		if (!SetFilePointerEx((HANDLE)file.mFile, position, NULL, FILE_BEGIN))
+			return false;
+		return SetEndOfFile((HANDLE)file.mFile) != FALSE;
+	}
+
+	bool			x_MappedFileMap(mapped_file_t& file, u64 size)
+	{
+		if (file.mBase != NULL)
+		{
+			UnmapViewOfFile(file.mBase);
+			CloseHandle((HANDLE)file.mMapping);
+			file.mBase = NULL;
+			file.mMapping = NULL;
+			file.mMappedSize = 0;
+		}
+		if (size == 0)
+			return true;
+
+		// The size of a mapping may not exceed the file size, the file is never extended here
+		HANDLE mapping = CreateFileMappingA((HANDLE)file.mFile, NULL, file.mWritable ? PAGE_READWRITE : PAGE_READONLY,
+			(DWORD)(size >> 32), (DWORD)(size & 0xffffffff), NULL);
+		if (mapping == NULL)
+			return false;
+		void* base = MapViewOfFile(mapping, file.mWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)size);
+		if (base == NULL)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+		file.mMapping = mapping;
+		file.mBase = (u8*)base;
+		file.mMappedSize = size;
+		return true;
+	}
+
+	bool			x_MappedFileFlush(mapped_file_t& file, u64 offset, u64 size)
+	{
+		if (file.mBase == NULL || size == 0)
+			return true;
+		if (!FlushViewOfFile(file.mBase + offset, (SIZE_T)size))
+			return false;
+		return FlushFileBuffers((HANDLE)file.mFile) != FALSE;
+	}
+};
+
+#endif // TARGET_PC
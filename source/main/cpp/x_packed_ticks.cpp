@@ -0,0 +1,343 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_packed_ticks.h"
+
+#include "xtime/private/x_time_bits.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XTIME_PACKED_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace xcore
+{
+	namespace xpackedticks
+	{
+		typedef void (*unpack_fn)(const u32* in, tick_t base, tick_t* out);
+
+		// Value 4*j+lane is in lane 'lane' at bit j*B, word k of a lane is at in[4*k+lane]
+		template <u32 B>
+		static void			sUnpack(const u32* in, tick_t base, tick_t* out)
+		{
+#ifdef XTIME_PACKED_SSE2
+			__m128i const mask = _mm_set1_epi32(B == 32 ? -1 : (s32)((1u << B) - 1));
+			__m128i const zero = _mm_setzero_si128();
+			__m128i const vbase = _mm_set1_epi64x(base);
+			__m128i cur = _mm_loadu_si128((const __m128i*)in);
+			u32 word = 0;
+			u32 shift = 0;
+			for (u32 j = 0; j < 32; ++j)
+			{
+				__m128i v = _mm_srl_epi32(cur, _mm_cvtsi32_si128((s32)shift));
+				shift += B;
+				if (shift >= 32)
+				{
+					shift -= 32;
+					if (++word < B)
+					{
+						cur = _mm_loadu_si128((const __m128i*)(in + 4 * word));
+						if (shift > 0)
+							v = _mm_or_si128(v, _mm_sll_epi32(cur, _mm_cvtsi32_si128((s32)(B - shift))));
+					}
+				}
+				v = _mm_and_si128(v, mask);
+				_mm_storeu_si128((__m128i*)(out + 4 * j), _mm_add_epi64(_mm_unpacklo_epi32(v, zero), vbase));
+				_mm_storeu_si128((__m128i*)(out + 4 * j + 2), _mm_add_epi64(_mm_unpackhi_epi32(v, zero), vbase));
+			}
+#else
+			u32 const mask = B == 32 ? 0xffffffff : ((1u << B) - 1);
+			for (u32 lane = 0; lane < 4; ++lane)
+			{
+				u32 bit = 0;
+				for (u32 j = 0; j < 32; ++j, bit += B)
+				{
+					u32 const word = bit >> 5;
+					u32 const shift = bit & 31;
+					u32 v = in[4 * word + lane] >> shift;
+					if (shift + B > 32)
+						v |= in[4 * (word + 1) + lane] << (32 - shift);
+					out[4 * j + lane] = (tick_t)((u64)base + (v & mask));
+				}
+			}
+#endif
+		}
+
+		static void			sUnpack0(const u32* /*in*/, tick_t base, tick_t* out)
+		{
+			for (u32 i = 0; i < packed_ticks_t::BLOCK_SIZE; ++i)
+				out[i] = base;
+		}
+
+		static void			sUnpack64(const u32* in, tick_t base, tick_t* out)
+		{
+			const u64* offsets = (const u64*)in;
+			for (u32 i = 0; i < packed_ticks_t::BLOCK_SIZE; ++i)
+				out[i] = (tick_t)((u64)base + offsets[i]);
+		}
+
+		static const unpack_fn	sUnpackers[33] =
+		{
+			sUnpack0,      sUnpack<1>,  sUnpack<2>,  sUnpack<3>,  sUnpack<4>,  sUnpack<5>,  sUnpack<6>,  sUnpack<7>,
+			sUnpack<8>,    sUnpack<9>,  sUnpack<10>, sUnpack<11>, sUnpack<12>, sUnpack<13>, sUnpack<14>, sUnpack<15>,
+			sUnpack<16>,   sUnpack<17>, sUnpack<18>, sUnpack<19>, sUnpack<20>, sUnpack<21>, sUnpack<22>, sUnpack<23>,
+			sUnpack<24>,   sUnpack<25>, sUnpack<26>, sUnpack<27>, sUnpack<28>, sUnpack<29>, sUnpack<30>, sUnpack<31>,
+			sUnpack<32>,
+		};
+
+		static void			sPack(const tick_t* values, tick_t base, u32 bits, u32* out)
+		{
+			if (bits == 64)
+			{
+				u64* offsets = (u64*)out;
+				for (u32 i = 0; i < packed_ticks_t::BLOCK_SIZE; ++i)
+					offsets[i] = (u64)values[i] - (u64)base;
+				return;
+			}
+
+			for (u32 i = 0; i < 4 * bits; ++i)
+				out[i] = 0;
+			for (u32 lane = 0; lane < 4 && bits > 0; ++lane)
+			{
+				u32 bit = 0;
+				for (u32 j = 0; j < 32; ++j, bit += bits)
+				{
+					u32 const v = (u32)((u64)values[4 * j + lane] - (u64)base);
+					u32 const word = bit >> 5;
+					u32 const shift = bit & 31;
+					out[4 * word + lane] |= v << shift;
+					if (shift + bits > 32)
+						out[4 * (word + 1) + lane] |= v >> (32 - shift);
+				}
+			}
+		}
+
+		// Number of u32 words of a block with offsets of 'bits' bits
+		static inline u32	sWords(u32 bits)
+		{
+			return bits == 64 ? 2 * packed_ticks_t::BLOCK_SIZE : 4 * bits;
+		}
+	}
+
+	packed_ticks_t::packed_ticks_t()
+		: mAllocator(NULL)
+		, mBlocks(NULL)
+		, mNumBlocks(0)
+		, mMaxBlocks(0)
+		, mData(NULL)
+		, mDataSize(0)
+		, mDataCapacity(0)
+		, mPending(NULL)
+		, mNumPending(0)
+		, mPendingMin(0)
+		, mPendingMax(0)
+	{
+	}
+
+	packed_ticks_t::~packed_ticks_t()
+	{
+		ASSERTS(mAllocator == NULL, "packed_ticks_t: exit() was not called");
+	}
+
+	void			packed_ticks_t::init(alloc_t* allocator, u32 initial_blocks)
+	{
+		ASSERT(allocator != NULL);
+		mAllocator = allocator;
+		mMaxBlocks = initial_blocks > 0 ? initial_blocks : 1;
+		mBlocks = (block_t*)allocator->allocate(mMaxBlocks * (u32)sizeof(block_t), 8);
+		mDataCapacity = xpackedticks::sWords(24) * mMaxBlocks; // Room for 24 bit offsets
+		mData = (u32*)allocator->allocate(mDataCapacity * (u32)sizeof(u32), 16);
+		mPending = (tick_t*)allocator->allocate(BLOCK_SIZE * (u32)sizeof(tick_t), 16);
+		clear();
+	}
+
+	void			packed_ticks_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		mAllocator->deallocate(mBlocks);
+		mAllocator->deallocate(mData);
+		mAllocator->deallocate(mPending);
+		mBlocks = NULL;
+		mData = NULL;
+		mPending = NULL;
+		mMaxBlocks = 0;
+		mDataCapacity = 0;
+		mAllocator = NULL;
+		clear();
+	}
+
+	void			packed_ticks_t::clear()
+	{
+		mNumBlocks = 0;
+		mDataSize = 0;
+		mNumPending = 0;
+		mPendingMin = 0;
+		mPendingMax = 0;
+	}
+
+	void			packed_ticks_t::append(tick_t value)
+	{
+		if (mNumPending == 0 || value < mPendingMin)
+			mPendingMin = value;
+		if (mNumPending == 0 || value > mPendingMax)
+			mPendingMax = value;
+		mPending[mNumPending++] = value;
+		if (mNumPending == BLOCK_SIZE)
+			flush();
+	}
+
+	void			packed_ticks_t::append(const tick_t* values, u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+			append(values[i]);
+	}
+
+	void			packed_ticks_t::flush()
+	{
+		u64 const range = (u64)mPendingMax - (u64)mPendingMin;
+		u32 bits = (u32)xtime_bitwidth64(range);
+		if (bits > 32)
+			bits = 64;
+		u32 const words = xpackedticks::sWords(bits);
+
+		if (mNumBlocks == mMaxBlocks)
+		{
+			u32 const max_blocks = mMaxBlocks * 2;
+			block_t* blocks = (block_t*)mAllocator->allocate(max_blocks * (u32)sizeof(block_t), 8);
+			for (u32 i = 0; i < mNumBlocks; ++i)
+				blocks[i] = mBlocks[i];
+			mAllocator->deallocate(mBlocks);
+			mBlocks = blocks;
+			mMaxBlocks = max_blocks;
+		}
+		if (mDataSize + words > mDataCapacity)
+		{
+			u32 capacity = mDataCapacity * 2;
+			while (mDataSize + words > capacity)
+				capacity *= 2;
+			u32* data = (u32*)mAllocator->allocate(capacity * (u32)sizeof(u32), 16);
+			for (u32 i = 0; i < mDataSize; ++i)
+				data[i] = mData[i];
+			mAllocator->deallocate(mData);
+			mData = data;
+			mDataCapacity = capacity;
+		}
+
+		block_t& block = mBlocks[mNumBlocks++];
+		block.mMin = mPendingMin;
+		block.mMax = mPendingMax;
+		block.mOffset = mDataSize;
+		block.mBits = bits;
+		xpackedticks::sPack(mPending, mPendingMin, bits, mData + mDataSize);
+		mDataSize += words;
+
+		mNumPending = 0;
+	}
+
+	u32				packed_ticks_t::getNumBytes() const
+	{
+		return mNumBlocks * (u32)sizeof(block_t) + mDataSize * (u32)sizeof(u32) + mNumPending * (u32)sizeof(tick_t);
+	}
+
+	tick_t			packed_ticks_t::get(u32 index) const
+	{
+		ASSERT(index < getNumValues());
+		u32 const b = index / BLOCK_SIZE;
+		u32 const i = index % BLOCK_SIZE;
+		if (b == mNumBlocks)
+			return mPending[i];
+
+		block_t const& block = mBlocks[b];
+		const u32* data = mData + block.mOffset;
+		if (block.mBits == 64)
+			return (tick_t)((u64)block.mMin + ((const u64*)data)[i]);
+		if (block.mBits == 0)
+			return block.mMin;
+
+		u32 const lane = i & 3;
+		u32 const bit = (i >> 2) * block.mBits;
+		u32 const word = bit >> 5;
+		u32 const shift = bit & 31;
+		u64 v = data[4 * word + lane] >> shift;
+		if (shift + block.mBits > 32)
+			v |= (u64)data[4 * (word + 1) + lane] << (32 - shift);
+		v &= ((u64)1 << block.mBits) - 1;
+		return (tick_t)((u64)block.mMin + v);
+	}
+
+	u32				packed_ticks_t::decode(u32 block, tick_t* out) const
+	{
+		ASSERT(block < getNumBlocks());
+		if (block == mNumBlocks)
+		{
+			for (u32 i = 0; i < mNumPending; ++i)
+				out[i] = mPending[i];
+			return mNumPending;
+		}
+
+		block_t const& b = mBlocks[block];
+		if (b.mBits == 64)
+			xpackedticks::sUnpack64(mData + b.mOffset, b.mMin, out);
+		else
+			xpackedticks::sUnpackers[b.mBits](mData + b.mOffset, b.mMin, out);
+		return BLOCK_SIZE;
+	}
+
+	u64				packed_ticks_t::count(tick_t from, tick_t until) const
+	{
+		u64 n = 0;
+		tick_t values[BLOCK_SIZE];
+		u32 const num_blocks = getNumBlocks();
+		for (u32 b = 0; b < num_blocks; ++b)
+		{
+			tick_t const lo = getBlockMin(b);
+			tick_t const hi = getBlockMax(b);
+			if (hi < from || lo >= until)
+				continue;
+			if (lo >= from && hi < until)
+			{
+				n += getBlockSize(b);
+				continue;
+			}
+
+			u32 const size = decode(b, values);
+			for (u32 i = 0; i < size; ++i)
+				n += (values[i] >= from && values[i] < until) ? 1 : 0;
+		}
+		return n;
+	}
+
+	u32				packed_ticks_t::select(tick_t from, tick_t until, u32 first_index, u32* out_indices, u32 max_count) const
+	{
+		u32 n = 0;
+		tick_t values[BLOCK_SIZE];
+		u32 const num_blocks = getNumBlocks();
+		for (u32 b = first_index / BLOCK_SIZE; b < num_blocks && n < max_count; ++b)
+		{
+			tick_t const lo = getBlockMin(b);
+			tick_t const hi = getBlockMax(b);
+			if (hi < from || lo >= until)
+				continue;
+
+			u32 const base = b * BLOCK_SIZE;
+			u32 const begin = first_index > base ? first_index - base : 0;
+			u32 const size = getBlockSize(b);
+			if (lo >= from && hi < until)
+			{
+				for (u32 i = begin; i < size && n < max_count; ++i)
+					out_indices[n++] = base + i;
+				continue;
+			}
+
+			decode(b, values);
+			for (u32 i = begin; i < size && n < max_count; ++i)
+			{
+				if (values[i] >= from && values[i] < until)
+					out_indices[n++] = base + i;
+			}
+		}
+		return n;
+	}
+};
@@ -0,0 +1,504 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_profile.h"
+
+#include "xtime/private/x_time_bits.h"
+
+#include <atomic>
+#include <new>
+
+namespace xcore
+{
+	/**
+	 * Per thread event buffers
+	 *
+	 * The owning thread is the only producer (mHead), x_ProfileFlush is the only
+	 * consumer (mTail). Buffers are kept in a lock-free singly linked list and are
+	 * only released by x_ProfileExit.
+	 *
+	 * The name is a seqlock: the owning thread makes mNameSerial odd while it
+	 * writes the name, a reader copies the name and retries when the serial was
+	 * odd or changed while copying.
+	 */
+	namespace xprofile
+	{
+		static const u32		sMaxZones = 4096;
+
+		struct alignas(64) buffer_t
+		{
+			std::atomic<u64>	mHead;
+			u32					mDepth;			///< Number of open zones, only touched by the owner
+			char				mPad0[64 - sizeof(std::atomic<u64>) - sizeof(u32)];
+			std::atomic<u64>	mTail;
+			std::atomic<u64>	mDropped;
+			profile_event_t*	mEvents;
+			u32					mMask;
+			u32					mIndex;
+			buffer_t*			mNext;
+			std::atomic<u32>	mNameSerial;
+			std::atomic<char>	mName[32];
+		};
+
+		static alloc_t*						sAllocator = NULL;
+		static u32							sEventsPerThread = 0;
+		static std::atomic<buffer_t*>		sBuffers(NULL);
+		static std::atomic<u32>				sNumThreads(0);
+		static std::atomic<u32>				sGeneration(1);
+
+		static const profile_zone_t*		sZones[sMaxZones];
+		static std::atomic<u32>				sNumZones(0);
+
+		static thread_local buffer_t*		tBuffer = NULL;
+		static thread_local u32				tGeneration = 0;
+
+		static buffer_t*	sAcquireBuffer()
+		{
+			u32 const generation = sGeneration.load(std::memory_order_acquire);
+			if (tGeneration == generation)
+				return tBuffer;
+
+			tBuffer = NULL;
+			tGeneration = generation;
+			if (sAllocator == NULL)
+				return NULL;
+
+			buffer_t* buffer = new (sAllocator->allocate(sizeof(buffer_t), 64)) buffer_t();
+			buffer->mHead.store(0, std::memory_order_relaxed);
+			buffer->mDepth = 0;
+			buffer->mTail.store(0, std::memory_order_relaxed);
+			buffer->mDropped.store(0, std::memory_order_relaxed);
+			buffer->mEvents = (profile_event_t*)sAllocator->allocate(sEventsPerThread * (u32)sizeof(profile_event_t), 64);
+			buffer->mMask = sEventsPerThread - 1;
+			buffer->mIndex = sNumThreads.fetch_add(1, std::memory_order_relaxed);
+			buffer->mNameSerial.store(0, std::memory_order_relaxed);
+			buffer->mName[0].store('\0', std::memory_order_relaxed);
+
+			buffer_t* head = sBuffers.load(std::memory_order_relaxed);
+			do
+			{
+				buffer->mNext = head;
+			} while (!sBuffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+			tBuffer = buffer;
+			return buffer;
+		}
+
+		static buffer_t*	sFindBuffer(u32 thread)
+		{
+			for (buffer_t* buffer = sBuffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->mNext)
+			{
+				if (buffer->mIndex == thread)
+					return buffer;
+			}
+			return NULL;
+		}
+
+		static inline void	sWrite(buffer_t* buffer, u64 head, u32 zone, u32 kind)
+		{
+			profile_event_t& e = buffer->mEvents[head & buffer->mMask];
+			e.mTime = x_GetTime();
+			e.mZone = zone;
+			e.mKind = kind;
+			buffer->mHead.store(head + 1, std::memory_order_release);
+		}
+	}
+
+	profile_zone_t::profile_zone_t(const char* name, const char* file, s32 line)
+		: mName(name)
+		, mFile(file)
+		, mLine(line)
+	{
+		mId = xprofile::sNumZones.fetch_add(1, std::memory_order_relaxed);
+		ASSERTS(mId < xprofile::sMaxZones, "profile_zone_t: too many profile zones");
+		if (mId < xprofile::sMaxZones)
+			xprofile::sZones[mId] = this;
+	}
+
+	/**
+	 *  Summary:
+	 *      Enable profiling, every thread that records a zone gets a ring buffer of
+	 *      'events_per_thread' events (rounded up to a power of two).
+	 */
+	void		x_ProfileInit(alloc_t* allocator, u32 events_per_thread)
+	{
+		ASSERT(allocator != NULL);
+		u32 capacity = 64;
+		while (capacity < events_per_thread)
+			capacity <<= 1;
+
+		xprofile::sEventsPerThread = capacity;
+		xprofile::sAllocator = allocator;
+		xprofile::sGeneration.fetch_add(1, std::memory_order_release);
+	}
+
+	/**
+	 *  Summary:
+	 *      Disable profiling and release all thread buffers, no thread should be
+	 *      inside a zone when this is called.
+	 */
+	void		x_ProfileExit()
+	{
+		alloc_t* allocator = xprofile::sAllocator;
+		xprofile::sAllocator = NULL;
+		xprofile::sGeneration.fetch_add(1, std::memory_order_release);
+		if (allocator == NULL)
+			return;
+
+		xprofile::buffer_t* buffer = xprofile::sBuffers.exchange(NULL, std::memory_order_acq_rel);
+		while (buffer != NULL)
+		{
+			xprofile::buffer_t* next = buffer->mNext;
+			allocator->deallocate(buffer->mEvents);
+			buffer->~buffer_t();
+			allocator->deallocate(buffer);
+			buffer = next;
+		}
+		xprofile::sNumThreads.store(0, std::memory_order_relaxed);
+	}
+
+	bool		x_ProfileBegin(u32 zone)
+	{
+		xprofile::buffer_t* buffer = xprofile::sAcquireBuffer();
+		if (buffer == NULL)
+			return false;
+
+		// Keep room for the end events of this zone and all zones that are open
+		u64 const head = buffer->mHead.load(std::memory_order_relaxed);
+		u64 const used = head - buffer->mTail.load(std::memory_order_acquire);
+		if ((u64)buffer->mMask + 1 - used < (u64)buffer->mDepth + 2)
+		{
+			buffer->mDropped.store(buffer->mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		xprofile::sWrite(buffer, head, zone, profile_event_t::BEGIN);
+		buffer->mDepth++;
+		return true;
+	}
+
+	void		x_ProfileEnd(u32 zone)
+	{
+		xprofile::buffer_t* buffer = xprofile::sAcquireBuffer();
+		if (buffer == NULL || buffer->mDepth == 0)
+			return;
+
+		buffer->mDepth--;
+		xprofile::sWrite(buffer, buffer->mHead.load(std::memory_order_relaxed), zone, profile_event_t::END);
+	}
+
+	void		x_ProfileSetThreadName(const char* name)
+	{
+		xprofile::buffer_t* buffer = xprofile::sAcquireBuffer();
+		if (buffer == NULL)
+			return;
+
+		u32 const serial = buffer->mNameSerial.load(std::memory_order_relaxed);
+		buffer->mNameSerial.store(serial + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		u32 i = 0;
+		for (; name[i] != '\0' && i < sizeof(buffer->mName) - 1; ++i)
+			buffer->mName[i].store(name[i], std::memory_order_relaxed);
+		buffer->mName[i].store('\0', std::memory_order_relaxed);
+		buffer->mNameSerial.store(serial + 2, std::memory_order_release);
+	}
+
+	u32			x_ProfileGetNumThreads()
+	{
+		return xprofile::sNumThreads.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 *  Summary:
+	 *      Copy the name of a thread into 'name' (truncated to 'size' characters including
+	 *      the terminator), returns false when the thread has no name. The owning thread
+	 *      may rename itself while this copies, the copy is retried until it is consistent.
+	 */
+	bool		x_ProfileGetThreadName(u32 thread, char* name, u32 size)
+	{
+		ASSERT(name != NULL && size > 0);
+		name[0] = '\0';
+		xprofile::buffer_t* buffer = xprofile::sFindBuffer(thread);
+		if (buffer == NULL)
+			return false;
+
+		u32 const max_length = size < (u32)sizeof(buffer->mName) ? size - 1 : (u32)sizeof(buffer->mName) - 1;
+		while (true)
+		{
+			u32 const serial = buffer->mNameSerial.load(std::memory_order_acquire);
+			if ((serial & 1) != 0)
+			{
+				xtime_cpu_pause();
+				continue;
+			}
+
+			u32 length = 0;
+			for (; length < max_length; ++length)
+			{
+				name[length] = buffer->mName[length].load(std::memory_order_relaxed);
+				if (name[length] == '\0')
+					break;
+			}
+			name[length] = '\0';
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (buffer->mNameSerial.load(std::memory_order_relaxed) == serial)
+				return length > 0;
+		}
+	}
+
+	u64			x_ProfileGetNumDropped(u32 thread)
+	{
+		xprofile::buffer_t* buffer = xprofile::sFindBuffer(thread);
+		return buffer != NULL ? buffer->mDropped.load(std::memory_order_relaxed) : 0;
+	}
+
+	u32			x_ProfileGetNumZones()
+	{
+		u32 const n = xprofile::sNumZones.load(std::memory_order_relaxed);
+		return n < xprofile::sMaxZones ? n : xprofile::sMaxZones;
+	}
+
+	const profile_zone_t*	x_ProfileGetZone(u32 zone)
+	{
+		if (zone >= x_ProfileGetNumZones())
+			return NULL;
+		return xprofile::sZones[zone];
+	}
+
+	/**
+	 *  Summary:
+	 *      Drain the event buffers of all threads into 'sink', the sink receives the
+	 *      events of a thread in order but possibly split over multiple calls.
+	 *      Only one thread at a time should call this.
+	 */
+	void		x_ProfileFlush(profile_sink_t* sink)
+	{
+		for (xprofile::buffer_t* buffer = xprofile::sBuffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->mNext)
+		{
+			u64 const head = buffer->mHead.load(std::memory_order_acquire);
+			u64 tail = buffer->mTail.load(std::memory_order_relaxed);
+			while (tail < head)
+			{
+				// Hand out the contiguous part of the ring buffer
+				u32 const begin = (u32)(tail & buffer->mMask);
+				u64 count = head - tail;
+				if (count > (u64)(buffer->mMask + 1 - begin))
+					count = (u64)(buffer->mMask + 1 - begin);
+
+				sink->onProfileEvents(buffer->mIndex, &buffer->mEvents[begin], (u32)count);
+				tail += count;
+				buffer->mTail.store(tail, std::memory_order_release);
+			}
+		}
+	}
+
+	/**
+	 * profile_aggregator_t
+	 */
+	profile_aggregator_t::profile_aggregator_t()
+		: mAllocator(NULL)
+		, mNodes(NULL)
+		, mNumNodes(0)
+		, mMaxNodes(0)
+		, mThreads(NULL)
+		, mMaxThreads(0)
+		, mNumDropped(0)
+	{
+	}
+
+	profile_aggregator_t::~profile_aggregator_t()
+	{
+		ASSERTS(mAllocator == NULL, "profile_aggregator_t: exit() was not called");
+	}
+
+	void		profile_aggregator_t::init(alloc_t* allocator)
+	{
+		mAllocator = allocator;
+		mMaxNodes = 256;
+		mNodes = (profile_node_t*)allocator->allocate(mMaxNodes * (u32)sizeof(profile_node_t), sizeof(void*));
+		reset();
+	}
+
+	void		profile_aggregator_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		for (u32 i = 0; i < mMaxThreads; ++i)
+		{
+			if (mThreads[i] != NULL)
+				mAllocator->deallocate(mThreads[i]);
+		}
+		if (mThreads != NULL)
+			mAllocator->deallocate(mThreads);
+		mAllocator->deallocate(mNodes);
+		mThreads = NULL;
+		mMaxThreads = 0;
+		mNodes = NULL;
+		mNumNodes = 0;
+		mMaxNodes = 0;
+		mAllocator = NULL;
+	}
+
+	void		profile_aggregator_t::reset()
+	{
+		profile_node_t& root = mNodes[0];
+		root.mZone = NONE;
+		root.mParent = NONE;
+		root.mFirstChild = NONE;
+		root.mNextSibling = NONE;
+		root.mDepth = 0;
+		root.mCalls = 0;
+		root.mInclusive = 0;
+		root.mExclusive = 0;
+		mNumNodes = 1;
+		mNumDropped = 0;
+
+		for (u32 i = 0; i < mMaxThreads; ++i)
+		{
+			if (mThreads[i] != NULL)
+			{
+				mThreads[i]->mDepth = 0;
+				mThreads[i]->mOverflow = 0;
+			}
+		}
+	}
+
+	profile_aggregator_t::thread_t*	profile_aggregator_t::thread(u32 index)
+	{
+		if (index >= mMaxThreads)
+		{
+			u32 const max_threads = (index + 16) & ~15;
+			thread_t** threads = (thread_t**)mAllocator->allocate(max_threads * (u32)sizeof(thread_t*), sizeof(void*));
+			for (u32 i = 0; i < max_threads; ++i)
+				threads[i] = i < mMaxThreads ? mThreads[i] : NULL;
+			if (mThreads != NULL)
+				mAllocator->deallocate(mThreads);
+			mThreads = threads;
+			mMaxThreads = max_threads;
+		}
+		if (mThreads[index] == NULL)
+		{
+			mThreads[index] = (thread_t*)mAllocator->allocate(sizeof(thread_t), sizeof(void*));
+			mThreads[index]->mDepth = 0;
+			mThreads[index]->mOverflow = 0;
+		}
+		return mThreads[index];
+	}
+
+	u32			profile_aggregator_t::child(u32 parent, u32 zone)
+	{
+		for (u32 c = mNodes[parent].mFirstChild; c != NONE; c = mNodes[c].mNextSibling)
+		{
+			if (mNodes[c].mZone == zone)
+				return c;
+		}
+
+		if (mNumNodes == mMaxNodes)
+		{
+			profile_node_t* nodes = (profile_node_t*)mAllocator->allocate(2 * mMaxNodes * (u32)sizeof(profile_node_t), sizeof(void*));
+			for (u32 i = 0; i < mNumNodes; ++i)
+				nodes[i] = mNodes[i];
+			mAllocator->deallocate(mNodes);
+			mNodes = nodes;
+			mMaxNodes *= 2;
+		}
+
+		u32 const index = mNumNodes++;
+		profile_node_t& node = mNodes[index];
+		node.mZone = zone;
+		node.mParent = parent;
+		node.mFirstChild = NONE;
+		node.mNextSibling = mNodes[parent].mFirstChild;
+		node.mDepth = mNodes[parent].mDepth + 1;
+		node.mCalls = 0;
+		node.mInclusive = 0;
+		node.mExclusive = 0;
+		mNodes[parent].mFirstChild = index;
+		return index;
+	}
+
+	void		profile_aggregator_t::onProfileEvents(u32 index, const profile_event_t* events, u32 count)
+	{
+		thread_t* t = thread(index);
+		for (u32 i = 0; i < count; ++i)
+		{
+			profile_event_t const& e = events[i];
+			if (e.mKind == profile_event_t::BEGIN)
+			{
+				// Zones beyond the stack are dropped, their END must not pop a frame
+				if (t->mDepth == MAX_DEPTH)
+				{
+					t->mOverflow++;
+					mNumDropped++;
+					continue;
+				}
+				u32 const parent = t->mDepth == 0 ? 0 : t->mStack[t->mDepth - 1].mNode;
+				frame_t& frame = t->mStack[t->mDepth++];
+				frame.mNode = child(parent, e.mZone);
+				frame.mBegin = e.mTime;
+				frame.mChildren = 0;
+			}
+			else if (t->mOverflow > 0)
+			{
+				t->mOverflow--;
+			}
+			else if (t->mDepth > 0)
+			{
+				frame_t const& frame = t->mStack[--t->mDepth];
+				tick_t const duration = e.mTime - frame.mBegin;
+				profile_node_t& node = mNodes[frame.mNode];
+				node.mCalls++;
+				node.mInclusive += duration;
+				node.mExclusive += duration - frame.mChildren;
+				if (t->mDepth > 0)
+					t->mStack[t->mDepth - 1].mChildren += duration;
+			}
+		}
+	}
+
+	u64			profile_aggregator_t::getZoneCalls(u32 zone) const
+	{
+		u64 calls = 0;
+		for (u32 i = 1; i < mNumNodes; ++i)
+		{
+			if (mNodes[i].mZone == zone)
+				calls += mNodes[i].mCalls;
+		}
+		return calls;
+	}
+
+	/**
+	 *  Summary:
+	 *      The inclusive time of a zone over all call paths, recursive calls of the zone
+	 *      are only counted once.
+	 */
+	tick_t		profile_aggregator_t::getZoneInclusive(u32 zone) const
+	{
+		tick_t inclusive = 0;
+		for (u32 i = 1; i < mNumNodes; ++i)
+		{
+			if (mNodes[i].mZone != zone)
+				continue;
+			bool nested = false;
+			for (u32 p = mNodes[i].mParent; p != 0 && p != NONE; p = mNodes[p].mParent)
+				nested = nested || (mNodes[p].mZone == zone);
+			if (!nested)
+				inclusive += mNodes[i].mInclusive;
+		}
+		return inclusive;
+	}
+
+	tick_t		profile_aggregator_t::getZoneExclusive(u32 zone) const
+	{
+		tick_t exclusive = 0;
+		for (u32 i = 1; i < mNumNodes; ++i)
+		{
+			if (mNodes[i].mZone == zone)
+				exclusive += mNodes[i].mExclusive;
+		}
+		return exclusive;
+	}
+};
@@ -0,0 +1,391 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_record_file.h"
+
+#include "xtime/private/x_mapped_file.h"
+
+#include <string.h>
+
+namespace xcore
+{
+	namespace xrecordfile
+	{
+		static const u32	sMagic = 0x46525458; // 'XTRF'
+		static const u32	sVersion = 1;
+		static const u64	sMinFileSize = 64 * 1024;
+
+		struct header_t
+		{
+			u32		mMagic;
+			u32		mVersion;
+			u32		mRecordSize;
+			u32		mStride;
+			u32		mBlockSize;
+			u32		mChecksum;		// Of the fields above
+			u64		mNumCommitted;	// Written last by commit(), records beyond it do not exist
+			u8		mReserved[32];
+		};
+
+		static u32			sChecksum(const header_t& header)
+		{
+			// FNV-1a
+			const u8* bytes = (const u8*)&header;
+			u32 hash = 2166136261u;
+			for (u32 i = 0; i < 5 * sizeof(u32); ++i)
+				hash = (hash ^ bytes[i]) * 16777619u;
+			return hash;
+		}
+
+		static inline header_t*	sHeader(const mapped_file_t& file)
+		{
+			return (header_t*)file.mBase;
+		}
+	}
+
+	record_file_t::record_file_t()
+		: mAllocator(NULL)
+		, mRecordSize(0)
+		, mStride(0)
+		, mBlockSize(0)
+		, mNumRecords(0)
+		, mNumCommitted(0)
+		, mLastKey(0)
+		, mIndex(NULL)
+		, mIndexSize(0)
+		, mIndexCapacity(0)
+		, mError(false)
+	{
+	}
+
+	record_file_t::~record_file_t()
+	{
+		ASSERTS(mFile.mFile == NULL, "record_file_t: close() was not called");
+	}
+
+	bool			record_file_t::open(const char* filename, alloc_t* allocator, u32 record_size, u32 block_size)
+	{
+		ASSERT(block_size > 0);
+		if (!openFile(filename, allocator, true))
+			return false;
+
+		u64 size;
+		if (!x_MappedFileGetSize(mFile, size))
+		{
+			abandon();
+			return false;
+		}
+
+		if (size == 0)
+		{
+			mRecordSize = record_size;
+			mStride = (u32)((sizeof(u64) + record_size + 7) & ~7);
+			mBlockSize = block_size;
+			if (!remap(xrecordfile::sMinFileSize))
+			{
+				abandon();
+				return false;
+			}
+
+			xrecordfile::header_t* header = xrecordfile::sHeader(mFile);
+			memset(header, 0, sizeof(xrecordfile::header_t));
+			header->mMagic = xrecordfile::sMagic;
+			header->mVersion = xrecordfile::sVersion;
+			header->mRecordSize = mRecordSize;
+			header->mStride = mStride;
+			header->mBlockSize = mBlockSize;
+			header->mChecksum = xrecordfile::sChecksum(*header);
+			header->mNumCommitted = 0;
+			if (!x_MappedFileFlush(mFile, 0, sizeof(xrecordfile::header_t)))
+			{
+				abandon();
+				return false;
+			}
+			return true;
+		}
+
+		if (!readHeader(size) || mRecordSize != record_size)
+		{
+			abandon();
+			return false;
+		}
+		return true;
+	}
+
+	bool			record_file_t::openReadOnly(const char* filename, alloc_t* allocator)
+	{
+		if (!openFile(filename, allocator, false))
+			return false;
+
+		u64 size;
+		if (!x_MappedFileGetSize(mFile, size) || !readHeader(size))
+		{
+			abandon();
+			return false;
+		}
+		return true;
+	}
+
+	bool			record_file_t::openFile(const char* filename, alloc_t* allocator, bool writable)
+	{
+		ASSERT(mFile.mFile == NULL);
+		ASSERT(allocator != NULL);
+		if (!x_MappedFileOpen(mFile, filename, writable))
+			return false;
+
+		mAllocator = allocator;
+		mRecordSize = 0;
+		mStride = 0;
+		mBlockSize = 0;
+		mNumRecords = 0;
+		mNumCommitted = 0;
+		mLastKey = 0;
+		mIndexSize = 0;
+		mError = false;
+		return true;
+	}
+
+	bool			record_file_t::readHeader(u64 file_size)
+	{
+		if (file_size < sizeof(xrecordfile::header_t))
+			return false;
+		if (mFile.mBase == NULL || file_size != mFile.mMappedSize)
+		{
+			if (!x_MappedFileMap(mFile, file_size))
+				return false;
+		}
+
+		xrecordfile::header_t const* header = xrecordfile::sHeader(mFile);
+		if (mStride == 0)
+		{
+			if (header->mMagic != xrecordfile::sMagic || header->mVersion != xrecordfile::sVersion)
+				return false;
+			if (header->mChecksum != xrecordfile::sChecksum(*header) || header->mBlockSize == 0)
+				return false;
+			if (header->mStride < sizeof(u64) + header->mRecordSize || (header->mStride & 7) != 0)
+				return false;
+			mRecordSize = header->mRecordSize;
+			mStride = header->mStride;
+			mBlockSize = header->mBlockSize;
+		}
+
+		// A file that was cut short keeps its whole records
+		u64 count = header->mNumCommitted;
+		u64 const available = (file_size - sizeof(xrecordfile::header_t)) / mStride;
+		if (count > available)
+		{
+			count = available;
+			if (mFile.mWritable)
+			{
+				xrecordfile::sHeader(mFile)->mNumCommitted = count;
+				x_MappedFileFlush(mFile, 0, sizeof(xrecordfile::header_t));
+			}
+		}
+
+		mNumRecords = count;
+		mNumCommitted = count;
+		mLastKey = count > 0 ? keyAt(count - 1) : 0;
+		extendIndex();
+		return true;
+	}
+
+	bool			record_file_t::close()
+	{
+		if (mFile.mFile == NULL)
+			return false;
+
+		if (mFile.mWritable && mStride != 0)
+		{
+			commit();
+			// Give back the room that was reserved for appending, a file that is still mapped
+			// by a reader can not be truncated on some platforms, that is not an error.
+			x_MappedFileMap(mFile, 0);
+			x_MappedFileResize(mFile, sizeof(xrecordfile::header_t) + mNumCommitted * mStride);
+		}
+		x_MappedFileClose(mFile);
+
+		if (mIndex != NULL)
+			mAllocator->deallocate(mIndex);
+		mIndex = NULL;
+		mIndexSize = 0;
+		mIndexCapacity = 0;
+		mAllocator = NULL;
+		mNumRecords = 0;
+		mNumCommitted = 0;
+
+		bool const ok = !mError;
+		mError = false;
+		return ok;
+	}
+
+	// Closes a file that failed to open without committing or truncating it
+	void			record_file_t::abandon()
+	{
+		mStride = 0;
+		close();
+	}
+
+	bool			record_file_t::remap(u64 size)
+	{
+		if (!x_MappedFileMap(mFile, 0) || !x_MappedFileResize(mFile, size) || !x_MappedFileMap(mFile, size))
+		{
+			mError = true;
+			return false;
+		}
+		return true;
+	}
+
+	void			record_file_t::extendIndex()
+	{
+		u64 const needed = (mNumRecords + mBlockSize - 1) / mBlockSize;
+		if (needed > mIndexCapacity)
+		{
+			u64 capacity = mIndexCapacity > 0 ? mIndexCapacity * 2 : 64;
+			while (capacity < needed)
+				capacity *= 2;
+			u64* index = (u64*)mAllocator->allocate((u32)(capacity * sizeof(u64)), sizeof(u64));
+			for (u64 i = 0; i < mIndexSize; ++i)
+				index[i] = mIndex[i];
+			if (mIndex != NULL)
+				mAllocator->deallocate(mIndex);
+			mIndex = index;
+			mIndexCapacity = capacity;
+		}
+		for (; mIndexSize < needed; ++mIndexSize)
+			mIndex[mIndexSize] = keyAt(mIndexSize * mBlockSize);
+	}
+
+	u8*				record_file_t::recordAt(u64 index) const
+	{
+		return mFile.mBase + sizeof(xrecordfile::header_t) + index * mStride;
+	}
+
+	bool			record_file_t::append(const datetime_t& key, const void* record)
+	{
+		if (!mFile.mWritable || mStride == 0)
+			return false;
+		u64 const ticks = (u64)key.ticks();
+		if (mNumRecords > 0 && ticks < mLastKey)
+			return false;
+
+		u64 const end = sizeof(xrecordfile::header_t) + (mNumRecords + 1) * mStride;
+		if (end > mFile.mMappedSize)
+		{
+			u64 size = mFile.mMappedSize * 2;
+			while (size < end)
+				size *= 2;
+			if (!remap(size))
+				return false;
+		}
+
+		u8* dst = recordAt(mNumRecords);
+		*(u64*)dst = ticks;
+		memcpy(dst + sizeof(u64), record, mRecordSize);
+		memset(dst + sizeof(u64) + mRecordSize, 0, mStride - sizeof(u64) - mRecordSize);
+
+		mNumRecords++;
+		mLastKey = ticks;
+		extendIndex();
+		return true;
+	}
+
+	bool			record_file_t::commit()
+	{
+		if (!mFile.mWritable || mNumCommitted == mNumRecords)
+			return !mError;
+
+		// The records first, then the count that makes them part of the file
+		u64 const offset = sizeof(xrecordfile::header_t) + mNumCommitted * mStride;
+		if (!x_MappedFileFlush(mFile, offset, (mNumRecords - mNumCommitted) * mStride))
+		{
+			mError = true;
+			return false;
+		}
+		xrecordfile::sHeader(mFile)->mNumCommitted = mNumRecords;
+		if (!x_MappedFileFlush(mFile, 0, sizeof(xrecordfile::header_t)))
+		{
+			mError = true;
+			return false;
+		}
+		mNumCommitted = mNumRecords;
+		return true;
+	}
+
+	bool			record_file_t::refresh()
+	{
+		if (mFile.mFile == NULL)
+			return false;
+		if (mFile.mWritable)
+			return true;
+
+		u64 size;
+		if (!x_MappedFileGetSize(mFile, size) || !readHeader(size))
+		{
+			mError = true;
+			return false;
+		}
+		return true;
+	}
+
+	datetime_t		record_file_t::getKey(u64 index) const
+	{
+		ASSERT(index < mNumRecords);
+		return datetime_t(keyAt(index));
+	}
+
+	const void*		record_file_t::getRecord(u64 index) const
+	{
+		ASSERT(index < mNumRecords);
+		return recordAt(index) + sizeof(u64);
+	}
+
+	u64				record_file_t::lowerBound(const datetime_t& key) const
+	{
+		u64 const ticks = (u64)key.ticks();
+
+		// The first block that starts at or after the key, the answer is in the block before it
+		u64 lo = 0;
+		u64 hi = mIndexSize;
+		while (lo < hi)
+		{
+			u64 const mid = lo + (hi - lo) / 2;
+			if (mIndex[mid] < ticks)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo == 0)
+			return 0;
+
+		u64 first = (lo - 1) * mBlockSize;
+		u64 last = lo * mBlockSize;
+		if (last > mNumRecords)
+			last = mNumRecords;
+		while (first < last)
+		{
+			u64 const mid = first + (last - first) / 2;
+			if (keyAt(mid) < ticks)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+		return first;
+	}
+
+	record_range_t	record_file_t::find(const datetime_t& from, const datetime_t& until) const
+	{
+		u64 const first = lowerBound(from);
+		u64 const end = until.ticks() > from.ticks() ? lowerBound(until) : first;
+		return getRange(first, end - first);
+	}
+
+	record_range_t	record_file_t::getRange(u64 first, u64 count) const
+	{
+		ASSERT(first + count <= mNumRecords);
+		if (count == 0)
+			return record_range_t(NULL, first, 0, mStride);
+		return record_range_t(recordAt(first), first, count, mStride);
+	}
+};
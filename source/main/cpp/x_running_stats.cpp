@@ -0,0 +1,13 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_running_stats.h"
+
+#include <math.h>
+
+namespace xcore
+{
+	f64		running_stats_t::stddev() const
+	{
+		return sqrt(variance());
+	}
+};
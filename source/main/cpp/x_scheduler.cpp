@@ -0,0 +1,488 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_sleep.h"
+#include "xtime/x_scheduler.h"
+#include "xtime/x_radix_heap.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace xcore
+{
+	/**
+	 * job_t
+	 */
+	job_t::job_t()
+		: mDeadline(0)
+		, mPeriod(0)
+		, mMode(ONE_SHOT)
+		, mCancelled(false)
+		, mState(IDLE)
+		, mWorker(0)
+		, mNumRuns(0)
+		, mMaxLateness(0)
+		, mTotalLateness(0)
+	{
+	}
+
+	f64			job_t::getAverageLatenessUs() const
+	{
+		u64 const runs = getNumRuns();
+		if (runs == 0)
+			return 0.0;
+		return x_TicksToUs(getTotalLateness()) / (f64)runs;
+	}
+
+	void		job_t::resetStats()
+	{
+		ASSERTS(isIdle(), "job_t: resetStats() while the job is scheduled");
+		mNumRuns.store(0, std::memory_order_relaxed);
+		mMaxLateness.store(0, std::memory_order_relaxed);
+		mTotalLateness.store(0, std::memory_order_relaxed);
+	}
+
+	/**
+	 * scheduler_t
+	 *
+	 * Every worker sits on its own cache-line, the queue is protected by a small
+	 * spin-lock. The earliest deadline in the queue is mirrored in an atomic so
+	 * that thieves can check for due work without touching the lock.
+	 *
+	 * A job moves from IDLE to RUNNING when it is scheduled, to QUEUED when it is
+	 * pushed and back to RUNNING when it is popped, these transitions are done
+	 * with the lock of the queue held. The worker that executed the job makes it
+	 * IDLE again when it is not rescheduled.
+	 *
+	 * A worker without due work waits on a condition variable until the earliest
+	 * deadline of all queues, minus the spin tail of x_SleepUntil. A push of an
+	 * earlier deadline or a stop request wakes the waiting workers. The waiters
+	 * publish themselves before they look at the deadlines and push() publishes
+	 * the deadline before it looks at the waiters, with a full fence on both
+	 * sides at least one of them sees the other.
+	 */
+	static const tick_t		sNoDeadline = X_CONSTANT_64(0x7fffffffffffffff);
+
+	// A wait on a deadline is split up in waits of at most this long, so that a time
+	// source that does not follow the wall clock is still followed.
+	static const s64		sMaxWaitUs = 10 * 1000;
+
+	struct alignas(64) scheduler_t::worker_t
+	{
+		std::atomic<bool>		mLock;
+		std::atomic<tick_t>		mNextDeadline;
+		std::atomic<u64>		mNumExecuted;
+		std::atomic<u64>		mNumStolen;
+		radix_heap_t<job_t*>	mQueue;
+
+		worker_t() : mLock(false), mNextDeadline(sNoDeadline), mNumExecuted(0), mNumStolen(0) {}
+
+		void		lock()
+		{
+			while (mLock.exchange(true, std::memory_order_acquire))
+			{
+				while (mLock.load(std::memory_order_relaxed))
+					std::this_thread::yield();
+			}
+		}
+
+		bool		tryLock()
+		{
+			return !mLock.load(std::memory_order_relaxed) && !mLock.exchange(true, std::memory_order_acquire);
+		}
+
+		void		unlock()
+		{
+			mLock.store(false, std::memory_order_release);
+		}
+
+		// Must be called with the lock held
+		void		publishNextDeadline()
+		{
+			u64 key;
+			mNextDeadline.store(mQueue.top(key) ? (tick_t)key : sNoDeadline, std::memory_order_relaxed);
+		}
+	};
+
+	struct scheduler_t::state_t
+	{
+		std::atomic<bool>		mStop;
+		worker_t*				mWorkers;
+
+		std::mutex				mMutex;
+		std::condition_variable	mWakeup;
+		u64						mSignal;				///< Incremented under mMutex on every wake-up
+		std::atomic<u32>		mNumWaiting;
+		std::atomic<tick_t>		mWaitDeadline;			///< The latest deadline that a waiting worker waits for
+
+		state_t() : mStop(false), mWorkers(NULL), mSignal(0), mNumWaiting(0), mWaitDeadline(sNoDeadline) {}
+
+		void		wakeup()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mSignal++;
+			}
+			mWakeup.notify_all();
+		}
+	};
+
+	scheduler_t::scheduler_t()
+		: mAllocator(NULL)
+		, mState(NULL)
+		, mNumWorkers(0)
+	{
+	}
+
+	scheduler_t::~scheduler_t()
+	{
+		ASSERTS(mState == NULL, "scheduler_t: exit() was not called");
+	}
+
+	void		scheduler_t::init(alloc_t* allocator, u32 num_workers)
+	{
+		ASSERT(allocator != NULL && num_workers > 0);
+		mAllocator = allocator;
+		mNumWorkers = num_workers;
+
+		void* mem = allocator->allocate(sizeof(state_t), sizeof(void*));
+		mState = new (mem) state_t();
+
+		mem = allocator->allocate(num_workers * (u32)sizeof(worker_t), 64);
+		mState->mWorkers = (worker_t*)mem;
+		for (u32 i = 0; i < num_workers; ++i)
+		{
+			worker_t* worker = new (&mState->mWorkers[i]) worker_t();
+			worker->mQueue.init(allocator);
+		}
+	}
+
+	void		scheduler_t::exit()
+	{
+		if (mState == NULL)
+			return;
+
+		for (u32 i = 0; i < mNumWorkers; ++i)
+		{
+			// Jobs that are still queued are released
+			u64 key;
+			job_t* job;
+			while (mState->mWorkers[i].mQueue.pop(key, job))
+				job->mState.store(job_t::IDLE, std::memory_order_release);
+			mState->mWorkers[i].mQueue.exit();
+			mState->mWorkers[i].~worker_t();
+		}
+		mAllocator->deallocate(mState->mWorkers);
+		mState->~state_t();
+		mAllocator->deallocate(mState);
+
+		mState = NULL;
+		mAllocator = NULL;
+		mNumWorkers = 0;
+	}
+
+	void		scheduler_t::push(u32 worker_index, job_t* job)
+	{
+		ASSERT(worker_index < mNumWorkers);
+		worker_t& worker = mState->mWorkers[worker_index];
+
+		worker.lock();
+		// The queue is monotone, a deadline before the last popped one is due anyway
+		u64 key = (u64)(job->mDeadline < 0 ? 0 : job->mDeadline);
+		if (key < worker.mQueue.lastKey())
+			key = worker.mQueue.lastKey();
+		worker.mQueue.push(key, job);
+		job->mWorker.store(worker_index, std::memory_order_relaxed);
+		job->mState.store(job_t::QUEUED, std::memory_order_release);
+		worker.publishNextDeadline();
+		worker.unlock();
+
+		// Wake the waiting workers when one of them would sleep past this deadline
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (mState->mNumWaiting.load(std::memory_order_relaxed) > 0 && (tick_t)key < mState->mWaitDeadline.load(std::memory_order_relaxed))
+			mState->wakeup();
+	}
+
+	// Takes ownership of an idle job, a job that is queued or executing can not be scheduled
+	bool		scheduler_t::acquire(job_t* job)
+	{
+		u32 state = job_t::IDLE;
+		if (!job->mState.compare_exchange_strong(state, job_t::RUNNING, std::memory_order_acquire))
+			return false;
+		job->mCancelled.store(false, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool		scheduler_t::scheduleAt(job_t* job, tick_t deadline, u32 worker)
+	{
+		if (!acquire(job))
+			return false;
+		job->mDeadline = deadline;
+		job->mPeriod = 0;
+		job->mMode = job_t::ONE_SHOT;
+		push(worker, job);
+		return true;
+	}
+
+	bool		scheduler_t::scheduleIn(job_t* job, tick_t delay, u32 worker)
+	{
+		return scheduleAt(job, x_GetTime() + delay, worker);
+	}
+
+	bool		scheduler_t::schedulePeriodic(job_t* job, tick_t first_deadline, tick_t period, job_t::EMode mode, u32 worker)
+	{
+		ASSERTS(period > 0, "scheduler_t: a periodic job needs a period larger than 0");
+		if (!acquire(job))
+			return false;
+		job->mDeadline = first_deadline;
+		job->mPeriod = period;
+		job->mMode = mode;
+		push(worker, job);
+		return true;
+	}
+
+	/**
+	 *  Summary:
+	 *      Cancel a job and wait until the scheduler has released it, a queued job is
+	 *      removed from its queue (a linear search), an executing job is waited for.
+	 *      Must not be called from the execute() of the job itself, use job_t::cancel().
+	 */
+	void		scheduler_t::cancel(job_t* job)
+	{
+		job->mCancelled.store(true, std::memory_order_release);
+		while (true)
+		{
+			u32 const state = job->mState.load(std::memory_order_acquire);
+			if (state == job_t::IDLE)
+				return;
+
+			if (state == job_t::QUEUED)
+			{
+				// The job may move to another queue until the lock is taken, check again
+				u32 const index = job->mWorker.load(std::memory_order_relaxed);
+				worker_t& worker = mState->mWorkers[index];
+				worker.lock();
+				bool const removed = job->mState.load(std::memory_order_relaxed) == job_t::QUEUED
+					&& job->mWorker.load(std::memory_order_relaxed) == index
+					&& worker.mQueue.remove(job);
+				if (removed)
+				{
+					worker.publishNextDeadline();
+					job->mState.store(job_t::IDLE, std::memory_order_release);
+				}
+				worker.unlock();
+				if (removed)
+					return;
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	// Must be called with the lock of 'worker' held
+	job_t*		scheduler_t::popDue(worker_t& worker, tick_t now)
+	{
+		u64 key;
+		if (!worker.mQueue.top(key) || (tick_t)key > now)
+			return NULL;
+
+		job_t* job;
+		worker.mQueue.pop(key, job);
+		job->mState.store(job_t::RUNNING, std::memory_order_relaxed);
+		worker.publishNextDeadline();
+		return job;
+	}
+
+	job_t*		scheduler_t::steal(u32 thief, tick_t now)
+	{
+		for (u32 i = 1; i < mNumWorkers; ++i)
+		{
+			worker_t& victim = mState->mWorkers[(thief + i) % mNumWorkers];
+			if (victim.mNextDeadline.load(std::memory_order_relaxed) > now)
+				continue;
+			if (!victim.tryLock())
+				continue;
+			job_t* job = popDue(victim, now);
+			victim.unlock();
+			if (job != NULL)
+			{
+				mState->mWorkers[thief].mNumStolen.fetch_add(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+		return NULL;
+	}
+
+	void		scheduler_t::execute(u32 worker, job_t* job, tick_t now)
+	{
+		if (job->isCancelled())
+		{
+			job->mState.store(job_t::IDLE, std::memory_order_release);
+			return;
+		}
+
+		// Only the executing worker writes the statistics, no read-modify-write is needed
+		tick_t const lateness = now > job->mDeadline ? (now - job->mDeadline) : 0;
+		job->mNumRuns.store(job->mNumRuns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		job->mTotalLateness.store(job->mTotalLateness.load(std::memory_order_relaxed) + lateness, std::memory_order_relaxed);
+		if (lateness > job->mMaxLateness.load(std::memory_order_relaxed))
+			job->mMaxLateness.store(lateness, std::memory_order_relaxed);
+
+		job->execute(now);
+		mState->mWorkers[worker].mNumExecuted.fetch_add(1, std::memory_order_relaxed);
+
+		if (job->isCancelled())
+		{
+			job->mState.store(job_t::IDLE, std::memory_order_release);
+			return;
+		}
+
+		switch (job->mMode)
+		{
+		case job_t::FIXED_RATE:
+			job->mDeadline += job->mPeriod;
+			push(worker, job);
+			break;
+		case job_t::FIXED_DELAY:
+			job->mDeadline = x_GetTime() + job->mPeriod;
+			push(worker, job);
+			break;
+		case job_t::ONE_SHOT:
+			job->mState.store(job_t::IDLE, std::memory_order_release);
+			break;
+		}
+	}
+
+	/**
+	 *  Summary:
+	 *      Execute all jobs that are due for this worker, when the worker has no due
+	 *      jobs of its own it tries to steal one due job from another worker.
+	 *
+	 *  Returns:
+	 *      The number of jobs that were executed.
+	 */
+	u32			scheduler_t::runDue(u32 worker_index)
+	{
+		ASSERT(worker_index < mNumWorkers);
+		worker_t& worker = mState->mWorkers[worker_index];
+
+		// Only jobs that are due at the start of this call are executed, this bounds
+		// the loop when a fixed-rate job is catching up.
+		tick_t const now = x_GetTime();
+		u32 executed = 0;
+		while (true)
+		{
+			job_t* job = NULL;
+			if (worker.mNextDeadline.load(std::memory_order_relaxed) <= now)
+			{
+				worker.lock();
+				job = popDue(worker, now);
+				worker.unlock();
+			}
+			if (job == NULL)
+				job = steal(worker_index, now);
+			if (job == NULL)
+				break;
+
+			execute(worker_index, job, x_GetTime());
+			executed++;
+		}
+		return executed;
+	}
+
+	// A worker can steal from every other worker, so it can see all the queues
+	tick_t		scheduler_t::getNextDeadline() const
+	{
+		tick_t deadline = sNoDeadline;
+		for (u32 i = 0; i < mNumWorkers; ++i)
+		{
+			tick_t const next = mState->mWorkers[i].mNextDeadline.load(std::memory_order_relaxed);
+			if (next < deadline)
+				deadline = next;
+		}
+		return deadline;
+	}
+
+	/**
+	 *  Summary:
+	 *      Block until the earliest deadline in the queues, until a job with an earlier
+	 *      deadline is pushed or until a stop is requested. Within the spin tail of the
+	 *      deadline the worker only yields.
+	 */
+	void		scheduler_t::waitForWork()
+	{
+		state_t& state = *mState;
+
+		tick_t const deadline = getNextDeadline();
+		tick_t const now = x_GetTime();
+		if (deadline <= now)
+			return;
+
+		sleep_stats_t stats;
+		x_GetSleepStats(stats);
+		if ((deadline - now) <= stats.mSpinTail)
+		{
+			std::this_thread::yield();
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(state.mMutex);
+		if (state.mNumWaiting.fetch_add(1, std::memory_order_relaxed) == 0 || deadline > state.mWaitDeadline.load(std::memory_order_relaxed))
+			state.mWaitDeadline.store(deadline, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		// Anything pushed before we registered as waiting is visible now
+		u64 const signal = state.mSignal;
+		if (!isStopRequested() && getNextDeadline() >= deadline)
+		{
+			auto const woken = [&state, signal]() { return state.mSignal != signal; };
+			if (deadline == sNoDeadline)
+			{
+				state.mWakeup.wait(lock, woken);
+			}
+			else
+			{
+				s64 us = (s64)x_TicksToUs((deadline - now) - stats.mSpinTail);
+				if (us > sMaxWaitUs)
+					us = sMaxWaitUs;
+				state.mWakeup.wait_for(lock, std::chrono::microseconds(us), woken);
+			}
+		}
+
+		state.mNumWaiting.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void		scheduler_t::run(u32 worker)
+	{
+		while (!isStopRequested())
+		{
+			if (runDue(worker) == 0)
+				waitForWork();
+		}
+	}
+
+	void		scheduler_t::requestStop()
+	{
+		mState->mStop.store(true, std::memory_order_release);
+		mState->wakeup();
+	}
+
+	bool		scheduler_t::isStopRequested() const
+	{
+		return mState->mStop.load(std::memory_order_acquire);
+	}
+
+	u64			scheduler_t::getNumExecuted(u32 worker) const
+	{
+		return mState->mWorkers[worker].mNumExecuted.load(std::memory_order_relaxed);
+	}
+
+	u64			scheduler_t::getNumStolen(u32 worker) const
+	{
+		return mState->mWorkers[worker].mNumStolen.load(std::memory_order_relaxed);
+	}
+};
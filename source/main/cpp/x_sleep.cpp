@@ -0,0 +1,151 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_sleep.h"
+
+#include "xtime/private/x_sleep_source.h"
+#include "xtime/private/x_time_source.h"
+#include "xtime/private/x_time_bits.h"
+
+#include <atomic>
+
+namespace xcore
+{
+	/**
+	 * Sleep calibration and statistics
+	 *
+	 * The kernel wake-up latency is tracked as an exponential moving average of the
+	 * latency and of its absolute deviation (both in 1/16th of a tick to keep some
+	 * precision). The spin tail is the average latency plus 4 times the deviation.
+	 * The state is shared by all threads, relaxed atomics are sufficient since it
+	 * only steers a heuristic.
+	 */
+	namespace xsleep
+	{
+		static const s64				sFixedShift = 4;
+		static const s64				sEmaShift = 3;			// alpha = 1/8
+
+		static std::atomic<s64>			sWakeLatency(-1);		// in fixed point, -1 = not calibrated yet
+		static std::atomic<s64>			sWakeDeviation(0);		// in fixed point
+
+		static std::atomic<u64>			sNumSleeps(0);
+		static std::atomic<u64>			sNumKernelSleeps(0);
+		static std::atomic<s64>			sTotalOvershoot(0);
+		static std::atomic<s64>			sMaxOvershoot(0);
+
+		// Before calibration we assume a wake-up latency of 1 ms
+		static tick_t	sGetSpinTail()
+		{
+			s64 const latency = sWakeLatency.load(std::memory_order_relaxed);
+			if (latency < 0)
+				return x_GetTicksPerSecond() / 1000;
+			s64 const deviation = sWakeDeviation.load(std::memory_order_relaxed);
+			return (latency + 4 * deviation) >> sFixedShift;
+		}
+
+		static void		sRecordWakeLatency(tick_t inLatency)
+		{
+			s64 const sample = (inLatency < 0 ? 0 : inLatency) << sFixedShift;
+			s64 latency = sWakeLatency.load(std::memory_order_relaxed);
+			if (latency < 0)
+			{
+				sWakeLatency.store(sample, std::memory_order_relaxed);
+				return;
+			}
+			s64 const diff = sample - latency;
+			s64 const absdiff = diff < 0 ? -diff : diff;
+			s64 deviation = sWakeDeviation.load(std::memory_order_relaxed);
+			latency += diff >> sEmaShift;
+			deviation += (absdiff - deviation) >> sEmaShift;
+			sWakeLatency.store(latency, std::memory_order_relaxed);
+			sWakeDeviation.store(deviation, std::memory_order_relaxed);
+		}
+
+		static void		sRecordOvershoot(tick_t inOvershoot, bool inKernelSleep)
+		{
+			sNumSleeps.fetch_add(1, std::memory_order_relaxed);
+			if (inKernelSleep)
+				sNumKernelSleeps.fetch_add(1, std::memory_order_relaxed);
+			sTotalOvershoot.fetch_add(inOvershoot, std::memory_order_relaxed);
+			s64 max = sMaxOvershoot.load(std::memory_order_relaxed);
+			while (inOvershoot > max && !sMaxOvershoot.compare_exchange_weak(max, inOvershoot, std::memory_order_relaxed))
+			{
+			}
+		}
+	}
+
+	void	x_SleepUntil(tick_t inDeadline)
+	{
+		tick_t now = x_GetTime();
+		if (now >= inDeadline)
+			return;
+
+		// A virtual time source moves its time instead of waiting
+		if (x_TimeSourceSleepUntil(inDeadline))
+			return;
+
+		bool kernel_sleep = false;
+		tick_t const tail = xsleep::sGetSpinTail();
+		if ((inDeadline - now) > tail)
+		{
+			tick_t const request = (inDeadline - now) - tail;
+			x_KernelSleep(request);
+			tick_t const wake = x_GetTime();
+			xsleep::sRecordWakeLatency((wake - now) - request);
+			kernel_sleep = true;
+			now = wake;
+		}
+
+		while (now < inDeadline)
+		{
+			xtime_cpu_pause();
+			now = x_GetTime();
+		}
+
+		xsleep::sRecordOvershoot(now - inDeadline, kernel_sleep);
+	}
+
+	void	x_SleepForTicks(tick_t inTicks)
+	{
+		if (inTicks <= 0)
+			return;
+		x_SleepUntil(x_GetTime() + inTicks);
+	}
+
+	void	x_SleepFor(const timespan_t& inDuration)
+	{
+		// timespan_t ticks are 100 nanosecond units
+		s64 const span = (s64)inDuration.ticks();
+		if (span <= 0)
+			return;
+		s64 const tps = x_GetTicksPerSecond();
+		s64 const perSecond = (s64)timespan_t::sTicksPerSecond;
+		tick_t const ticks = (span / perSecond) * tps + ((span % perSecond) * tps) / perSecond;
+		x_SleepForTicks(ticks);
+	}
+
+	void	x_GetSleepStats(sleep_stats_t& outStats)
+	{
+		s64 const latency = xsleep::sWakeLatency.load(std::memory_order_relaxed);
+		outStats.mNumSleeps = xsleep::sNumSleeps.load(std::memory_order_relaxed);
+		outStats.mNumKernelSleeps = xsleep::sNumKernelSleeps.load(std::memory_order_relaxed);
+		outStats.mTotalOvershoot = xsleep::sTotalOvershoot.load(std::memory_order_relaxed);
+		outStats.mMaxOvershoot = xsleep::sMaxOvershoot.load(std::memory_order_relaxed);
+		outStats.mWakeLatency = latency < 0 ? 0 : (latency >> xsleep::sFixedShift);
+		outStats.mWakeDeviation = xsleep::sWakeDeviation.load(std::memory_order_relaxed) >> xsleep::sFixedShift;
+		outStats.mSpinTail = xsleep::sGetSpinTail();
+	}
+
+	/**
+	 *  Summary:
+	 *      Reset the overshoot statistics, the calibration of the spin tail is kept.
+	 */
+	void	x_ResetSleepStats()
+	{
+		xsleep::sNumSleeps.store(0, std::memory_order_relaxed);
+		xsleep::sNumKernelSleeps.store(0, std::memory_order_relaxed);
+		xsleep::sTotalOvershoot.store(0, std::memory_order_relaxed);
+		xsleep::sMaxOvershoot.store(0, std::memory_order_relaxed);
+	}
+};
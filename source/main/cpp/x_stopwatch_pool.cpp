@@ -0,0 +1,203 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_stopwatch_pool.h"
+
+namespace xcore
+{
+	/**
+	 * The range loops avoid branches, the running flag is turned into an all-ones
+	 * or all-zeros mask so that the loops can be vectorized.
+	 */
+	stopwatch_pool_t::stopwatch_pool_t()
+		: mAllocator(NULL)
+		, mCapacity(0)
+		, mStart(NULL)
+		, mTotal(NULL)
+		, mRunning(NULL)
+	{
+	}
+
+	stopwatch_pool_t::~stopwatch_pool_t()
+	{
+		ASSERTS(mAllocator == NULL, "stopwatch_pool_t: exit() was not called");
+	}
+
+	void		stopwatch_pool_t::init(alloc_t* allocator, u32 capacity)
+	{
+		ASSERT(allocator != NULL);
+		mAllocator = allocator;
+		mCapacity = capacity;
+		mStart = (tick_t*)allocator->allocate((capacity > 0 ? capacity : 1) * (u32)sizeof(tick_t), 64);
+		mTotal = (tick_t*)allocator->allocate((capacity > 0 ? capacity : 1) * (u32)sizeof(tick_t), 64);
+		mRunning = (u8*)allocator->allocate(capacity > 0 ? capacity : 1, 64);
+		resetAll();
+	}
+
+	void		stopwatch_pool_t::exit()
+	{
+		if (mAllocator == NULL)
+			return;
+		mAllocator->deallocate(mStart);
+		mAllocator->deallocate(mTotal);
+		mAllocator->deallocate(mRunning);
+		mStart = NULL;
+		mTotal = NULL;
+		mRunning = NULL;
+		mCapacity = 0;
+		mAllocator = NULL;
+	}
+
+	void		stopwatch_pool_t::start(u32 index)
+	{
+		ASSERT(index < mCapacity);
+		if (mRunning[index] != 0)
+			return;
+		mStart[index] = x_GetTime();
+		mRunning[index] = 1;
+	}
+
+	tick_t		stopwatch_pool_t::stop(u32 index)
+	{
+		ASSERT(index < mCapacity);
+		if (mRunning[index] != 0)
+		{
+			mTotal[index] += x_GetTime() - mStart[index];
+			mRunning[index] = 0;
+		}
+		return mTotal[index];
+	}
+
+	void		stopwatch_pool_t::reset(u32 index)
+	{
+		ASSERT(index < mCapacity);
+		mStart[index] = 0;
+		mTotal[index] = 0;
+		mRunning[index] = 0;
+	}
+
+	tick_t		stopwatch_pool_t::read(u32 index) const
+	{
+		ASSERT(index < mCapacity);
+		if (mRunning[index] != 0)
+			return mTotal[index] + (x_GetTime() - mStart[index]);
+		return mTotal[index];
+	}
+
+	void		stopwatch_pool_t::startBatch(const u32* indices, u32 count)
+	{
+		tick_t const now = x_GetTime();
+		for (u32 i = 0; i < count; ++i)
+		{
+			u32 const index = indices[i];
+			ASSERT(index < mCapacity);
+			if (mRunning[index] == 0)
+			{
+				mStart[index] = now;
+				mRunning[index] = 1;
+			}
+		}
+	}
+
+	void		stopwatch_pool_t::stopBatch(const u32* indices, u32 count)
+	{
+		tick_t const now = x_GetTime();
+		for (u32 i = 0; i < count; ++i)
+		{
+			u32 const index = indices[i];
+			ASSERT(index < mCapacity);
+			if (mRunning[index] != 0)
+			{
+				mTotal[index] += now - mStart[index];
+				mRunning[index] = 0;
+			}
+		}
+	}
+
+	void		stopwatch_pool_t::startRange(u32 first, u32 count)
+	{
+		ASSERT(first + count <= mCapacity);
+		tick_t const now = x_GetTime();
+		tick_t* start = mStart + first;
+		u8* running = mRunning + first;
+		for (u32 i = 0; i < count; ++i)
+		{
+			tick_t const mask = -(tick_t)running[i];
+			start[i] = (start[i] & mask) | (now & ~mask);
+			running[i] = 1;
+		}
+	}
+
+	void		stopwatch_pool_t::stopRange(u32 first, u32 count)
+	{
+		ASSERT(first + count <= mCapacity);
+		tick_t const now = x_GetTime();
+		tick_t const* start = mStart + first;
+		tick_t* total = mTotal + first;
+		u8* running = mRunning + first;
+		for (u32 i = 0; i < count; ++i)
+		{
+			tick_t const mask = -(tick_t)running[i];
+			total[i] += (now - start[i]) & mask;
+			running[i] = 0;
+		}
+	}
+
+	void		stopwatch_pool_t::resetRange(u32 first, u32 count)
+	{
+		ASSERT(first + count <= mCapacity);
+		for (u32 i = first; i < first + count; ++i)
+		{
+			mStart[i] = 0;
+			mTotal[i] = 0;
+			mRunning[i] = 0;
+		}
+	}
+
+	void		stopwatch_pool_t::add(u32 first, u32 count, const tick_t* ticks)
+	{
+		ASSERT(first + count <= mCapacity);
+		tick_t* total = mTotal + first;
+		for (u32 i = 0; i < count; ++i)
+			total[i] += ticks[i];
+	}
+
+	void		stopwatch_pool_t::read(u32 first, u32 count, tick_t* out) const
+	{
+		ASSERT(first + count <= mCapacity);
+		tick_t const now = x_GetTime();
+		tick_t const* start = mStart + first;
+		tick_t const* total = mTotal + first;
+		u8 const* running = mRunning + first;
+		for (u32 i = 0; i < count; ++i)
+		{
+			tick_t const mask = -(tick_t)running[i];
+			out[i] = total[i] + ((now - start[i]) & mask);
+		}
+	}
+
+	void		stopwatch_pool_t::readMs(u32 first, u32 count, f64* out) const
+	{
+		readScaled(first, count, out, 1000.0 / (f64)x_GetTicksPerSecond());
+	}
+
+	void		stopwatch_pool_t::readUs(u32 first, u32 count, f64* out) const
+	{
+		readScaled(first, count, out, 1000000.0 / (f64)x_GetTicksPerSecond());
+	}
+
+	void		stopwatch_pool_t::readScaled(u32 first, u32 count, f64* out, f64 scale) const
+	{
+		ASSERT(first + count <= mCapacity);
+		tick_t const now = x_GetTime();
+		tick_t const* start = mStart + first;
+		tick_t const* total = mTotal + first;
+		u8 const* running = mRunning + first;
+		for (u32 i = 0; i < count; ++i)
+		{
+			tick_t const mask = -(tick_t)running[i];
+			out[i] = (f64)(total[i] + ((now - start[i]) & mask)) * scale;
+		}
+	}
+};
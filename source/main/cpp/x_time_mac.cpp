@@ -11,21 +11,26 @@
 
 #include "xtime/private/x_time_source.h"
 #include "xtime/private/x_datetime_source.h"
+#include "xtime/private/x_sleep_source.h"
+#include "xtime/private/x_cpu_time_source.h"
 
 namespace xcore
 {
 	class xdatetime_source_mac : public datetime_source_t
 	{
 	public:
+		// With the sub-second part, datetime_t ticks are 100 nanosecond units
 		virtual u64			getSystemTimeUtc()
 		{
-			time_t curTime;
-			time( &curTime );
+			timespec now;
+			clock_gettime(CLOCK_REALTIME, &now);
+			time_t curTime = now.tv_sec;
 
-			tm		gmTime = (*gmtime( &curTime ));
+			tm		gmTime;
+			gmtime_r(&curTime, &gmTime);
 
 			datetime_t dt(gmTime.tm_year + 1900, gmTime.tm_mon + 1, gmTime.tm_mday, gmTime.tm_hour, gmTime.tm_min, gmTime.tm_sec);
-			return (u64)dt.ticks();
+			return (u64)dt.ticks() + (u64)(now.tv_nsec / 100);
 		}
 
 		virtual u64			getSystemTimeLocal()
@@ -132,18 +137,27 @@ namespace xcore
 
 	/**
 	 * Time source for Mac OS
+	 *
+	 * Ticks are nanoseconds of CLOCK_MONOTONIC, clock() can not be used since it
+	 * measures the CPU time of the process.
 	 */
+	static inline s64	sClockNs(clockid_t inClock)
+	{
+		timespec ts;
+		clock_gettime(inClock, &ts);
+		return (s64)ts.tv_sec * 1000000000 + (s64)ts.tv_nsec;
+	}
+
 	class xtime_source_mac : public time_source_t
 	{
-		f64				mFreqPerSec;
+		s64				mFreqPerSec;
 		tick_t			mBaseTimeTick;
-		tick_t			mLastTicks;
 
 	public:
 		void			init()
 		{
-			mFreqPerSec  = CLOCKS_PER_SEC;
-			mBaseTimeTick = clock();
+			mFreqPerSec  = 1000000000;
+			mBaseTimeTick = sClockNs(CLOCK_MONOTONIC);
 		}
 
 		/**
@@ -166,7 +180,7 @@ namespace xcore
 		virtual tick_t	getTimeInTicks()
 		{
 			ASSERT(mBaseTimeTick);
-			s64 ticks = clock();
+			s64 ticks = sClockNs(CLOCK_MONOTONIC);
 			ticks -= mBaseTimeTick;
 			return ticks;
 		}
@@ -176,6 +190,30 @@ namespace xcore
 			return mFreqPerSec;
 		}
 	};
+
+	void	x_KernelSleep(s64 inTicks)
+	{
+		s64 const tps = x_GetTicksPerSecond();
+		s64 const ns = ((inTicks % tps) * 1000000000) / tps;
+
+		timespec request;
+		request.tv_sec = (time_t)(inTicks / tps);
+		request.tv_nsec = (long)ns;
+
+		timespec remaining;
+		while (nanosleep(&request, &remaining) != 0)
+			request = remaining;
+	}
+
+	s64		x_GetThreadCpuTimeNs()
+	{
+		return sClockNs(CLOCK_THREAD_CPUTIME_ID);
+	}
+
+	s64		x_GetProcessCpuTimeNs()
+	{
+		return sClockNs(CLOCK_PROCESS_CPUTIME_ID);
+	}
 };
 
 namespace xtime
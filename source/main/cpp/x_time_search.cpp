@@ -0,0 +1,183 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_time_search.h"
+
+#include "xtime/private/x_time_bits.h"
+
+namespace xcore
+{
+	namespace xtimesearch
+	{
+		// Keys as unsigned numbers in the same order, so differences never overflow
+		static inline u64	sKey(const tick_t& value)
+		{
+			return (u64)value ^ X_CONSTANT_64(0x8000000000000000);
+		}
+
+		static inline u64	sKey(const datetime_t& value)
+		{
+			return value.ticks();
+		}
+
+		// Lower bound in [lo, hi), the result is in [lo, hi]
+		template <typename T>
+		static inline u32	sBinary(const T* values, u32 lo, u32 hi, u64 key)
+		{
+			const T* base = values + lo;
+			u32 n = hi - lo;
+			while (n > 1)
+			{
+				// Both candidates for the next probe, the branch free loop can not speculate
+				u32 const half = n >> 1;
+				xtime_prefetch(base + (half >> 1));
+				xtime_prefetch(base + half + (half >> 1));
+				base = sKey(base[half]) < key ? base + half : base;
+				n -= half;
+			}
+			return (u32)(base - values) + ((n == 1 && sKey(*base) < key) ? 1 : 0);
+		}
+
+		// values[from] < key, gallops up in (from, hi) and narrows [lo, hi] to at most 'max_steps' doublings.
+		// Returns false when the answer is further away.
+		template <typename T>
+		static inline bool	sGallopUp(const T* values, u32 from, u32& lo, u32& hi, u64 key, u32 max_steps)
+		{
+			lo = from + 1;
+			u64 step = 1;
+			for (u32 s = 0; s < max_steps; ++s, step <<= 1)
+			{
+				u64 const probe = (u64)from + step;
+				if (probe >= hi)
+					return true;
+				if (sKey(values[probe]) >= key)
+				{
+					hi = (u32)probe;
+					return true;
+				}
+				lo = (u32)probe + 1;
+			}
+			return false;
+		}
+
+		// values[from] >= key, gallops down in [lo, from) and narrows [lo, hi]
+		template <typename T>
+		static inline bool	sGallopDown(const T* values, u32 from, u32& lo, u32& hi, u64 key, u32 max_steps)
+		{
+			hi = from;
+			u32 step = 1;
+			for (u32 s = 0; s < max_steps; ++s, step <<= 1)
+			{
+				if (step > from - lo)
+					return true;
+				u32 const probe = from - step;
+				if (sKey(values[probe]) < key)
+				{
+					lo = probe + 1;
+					return true;
+				}
+				hi = probe;
+			}
+			return false;
+		}
+
+		template <typename T>
+		static u32			sInterpolation(const T* values, u32 lo, u32 hi, u64 key)
+		{
+			for (u32 round = 0; round < 3 && hi - lo > 32; ++round)
+			{
+				u64 const first = sKey(values[lo]);
+				if (key <= first)
+					return lo;
+				u64 const last = sKey(values[hi - 1]);
+				if (key > last)
+					return hi;
+
+				// first < key <= last, so the estimate is in [lo, hi - 1]
+				f64 const fraction = (f64)(key - first) / (f64)(last - first);
+				u32 const p = lo + (u32)(fraction * (f64)(hi - 1 - lo));
+				if (sKey(values[p]) < key)
+					sGallopUp(values, p, lo, hi, key, 32);
+				else
+					sGallopDown(values, p, lo, hi, key, 32);
+			}
+			return sBinary(values, lo, hi, key);
+		}
+
+		template <typename T>
+		static u32			sGallop(const T* values, u32 count, u64 key, u32 hint, u32 max_steps)
+		{
+			if (count == 0)
+				return 0;
+			if (hint >= count)
+				hint = count - 1;
+
+			u32 lo = 0;
+			u32 hi = count;
+			if (sKey(values[hint]) < key)
+			{
+				if (!sGallopUp(values, hint, lo, hi, key, max_steps))
+					return sInterpolation(values, lo, hi, key);
+			}
+			else
+			{
+				if (!sGallopDown(values, hint, lo, hi, key, max_steps))
+					return sInterpolation(values, lo, hi, key);
+			}
+			return sBinary(values, lo, hi, key);
+		}
+
+		template <typename T>
+		static void			sBatch(const T* values, u32 count, const T* keys, u32 num_keys, u32* out_indices)
+		{
+			// Nearby keys gallop from the previous result, far away keys interpolate
+			u32 hint = 0;
+			for (u32 i = 0; i < num_keys; ++i)
+			{
+				hint = sGallop(values, count, sKey(keys[i]), hint, 6);
+				out_indices[i] = hint;
+			}
+		}
+	}
+
+	u32		x_LowerBound(const tick_t* values, u32 count, tick_t key)
+	{
+		return xtimesearch::sBinary(values, 0, count, xtimesearch::sKey(key));
+	}
+
+	u32		x_LowerBound(const datetime_t* values, u32 count, const datetime_t& key)
+	{
+		return xtimesearch::sBinary(values, 0, count, xtimesearch::sKey(key));
+	}
+
+	u32		x_InterpolationSearch(const tick_t* values, u32 count, tick_t key)
+	{
+		return count == 0 ? 0 : xtimesearch::sInterpolation(values, 0, count, xtimesearch::sKey(key));
+	}
+
+	u32		x_InterpolationSearch(const datetime_t* values, u32 count, const datetime_t& key)
+	{
+		return count == 0 ? 0 : xtimesearch::sInterpolation(values, 0, count, xtimesearch::sKey(key));
+	}
+
+	u32		x_GallopSearch(const tick_t* values, u32 count, tick_t key, u32 hint)
+	{
+		return xtimesearch::sGallop(values, count, xtimesearch::sKey(key), hint, 32);
+	}
+
+	u32		x_GallopSearch(const datetime_t* values, u32 count, const datetime_t& key, u32 hint)
+	{
+		return xtimesearch::sGallop(values, count, xtimesearch::sKey(key), hint, 32);
+	}
+
+	void	x_LowerBoundBatch(const tick_t* values, u32 count, const tick_t* keys, u32 num_keys, u32* out_indices)
+	{
+		xtimesearch::sBatch(values, count, keys, num_keys, out_indices);
+	}
+
+	void	x_LowerBoundBatch(const datetime_t* values, u32 count, const datetime_t* keys, u32 num_keys, u32* out_indices)
+	{
+		xtimesearch::sBatch(values, count, keys, num_keys, out_indices);
+	}
+};
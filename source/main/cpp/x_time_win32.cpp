@@ -10,6 +10,9 @@
 #include <mmsystem.h>
 #include <time.h>
 
+// timeBeginPeriod/timeEndPeriod
+#pragma comment(lib, "winmm.lib")
+
 #include "xbase/x_debug.h"
 
 #include "xtime/x_time.h"
@@ -18,25 +21,27 @@
 
 #include "xtime/private/x_time_source.h"
 #include "xtime/private/x_datetime_source.h"
+#include "xtime/private/x_sleep_source.h"
+#include "xtime/private/x_cpu_time_source.h"
 
 namespace xcore
 {
 	class xdatetime_source_win32 : public datetime_source_t
 	{
 	public:
+		// A FILETIME counts 100 nanosecond units since 1601-01-01 (UTC), datetime_t
+		// uses the same unit but counts from 0001-01-01.
 		virtual u64			getSystemTimeUtc()
 		{
-			::time_t rawtime;
-			::time( &rawtime );
-
-			::tm gmTime;
-			gmtime_s(&gmTime, &rawtime);
+			static const u64 sTicksTo1601 = X_CONSTANT_64(504911232000000000);
 
-			datetime_t dt(gmTime.tm_year + 1900, gmTime.tm_mon + 1, gmTime.tm_mday, gmTime.tm_hour, gmTime.tm_min, gmTime.tm_sec);
-			return (u64)dt.ticks();
+			::FILETIME system_time;
+			::GetSystemTimePreciseAsFileTime(&system_time);
+			u64 time = ((u64)system_time.dwHighDateTime << 32) + (u64)system_time.dwLowDateTime;
+			return time + sTicksTo1601;
 		}
 
-		// Time difference between local and UTC
+		// Minutes from local time to UTC, UTC = local + bias
 		virtual s64			getSystemTimeZone()
 		{
 			TIME_ZONE_INFORMATION tzi;
@@ -166,12 +171,57 @@ namespace xcore
 			return (s64)mPCFreqPerSec;
 		}
 	};
+
+	/**
+	 *   Sleep() has a granularity of the system timer period, x_Init requests a
+	 *   period of 1 ms. The milliseconds are rounded down, the spin tail of
+	 *   x_SleepUntil absorbs the rest. A request shorter than 1 ms still sleeps
+	 *   1 ms, Sleep(0) only yields and the spin tail would take the whole wait.
+	 *   The longer wake up is measured as wake latency, so the spin tail grows
+	 *   until such short requests are spun instead.
+	 */
+	void	x_KernelSleep(s64 inTicks)
+	{
+		s64 ms = (inTicks * 1000) / x_GetTicksPerSecond();
+		if (ms < 1)
+			ms = 1;
+		::Sleep((DWORD)ms);
+	}
+
+	/**
+	 *   GetThreadTimes/GetProcessTimes report kernel and user time in 100 nanosecond
+	 *   units, their resolution is the scheduler quantum.
+	 */
+	static inline s64	sFileTimeNs(const FILETIME& inKernel, const FILETIME& inUser)
+	{
+		u64 const kernel = ((u64)inKernel.dwHighDateTime << 32) | inKernel.dwLowDateTime;
+		u64 const user = ((u64)inUser.dwHighDateTime << 32) | inUser.dwLowDateTime;
+		return (s64)(kernel + user) * 100;
+	}
+
+	s64		x_GetThreadCpuTimeNs()
+	{
+		FILETIME creation, exit, kernel, user;
+		if (!::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user))
+			return 0;
+		return sFileTimeNs(kernel, user);
+	}
+
+	s64		x_GetProcessCpuTimeNs()
+	{
+		FILETIME creation, exit, kernel, user;
+		if (!::GetProcessTimes(::GetCurrentProcess(), &creation, &exit, &kernel, &user))
+			return 0;
+		return sFileTimeNs(kernel, user);
+	}
 };
 
 namespace xtime
 {
 	void x_Init(void)
 	{
+		timeBeginPeriod(1);
+
 		static xcore::xtime_source_win32 sTimeSource;
 		sTimeSource.init();
 		xcore::x_SetTimeSource(&sTimeSource);
@@ -184,6 +234,8 @@ namespace xtime
 	{
 		xcore::x_SetTimeSource(NULL);
 		xcore::x_SetDateTimeSource(NULL);
+
+		timeEndPeriod(1);
 	}
 }
 
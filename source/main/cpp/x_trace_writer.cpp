@@ -0,0 +1,283 @@
+#include "xbase/x_debug.h"
+#include "xbase/x_allocator.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_frame_rate.h"
+#include "xtime/x_profile.h"
+#include "xtime/x_trace_writer.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace xcore
+{
+	/**
+	 * Chrome trace-event JSON
+	 *
+	 * {"traceEvents":[
+	 * {"name":"update","ph":"B","ts":12.345,"pid":1,"tid":0},
+	 * {"name":"update","ph":"E","ts":15.000,"pid":1,"tid":0},
+	 * {"name":"fps","ph":"C","ts":16.667,"pid":1,"tid":0,"args":{"value":60}},
+	 * ...
+	 * ],"displayTimeUnit":"ms"}
+	 *
+	 * Timestamps are in microseconds, they are written with 3 decimals so that the
+	 * full nanosecond precision of the tick source is kept.
+	 */
+	trace_writer_t::trace_writer_t()
+		: mFile(NULL)
+		, mAllocator(NULL)
+		, mChunk(NULL)
+		, mChunkSize(0)
+		, mChunkUsed(0)
+		, mEpoch(0)
+		, mNumEvents(0)
+		, mNumBytes(0)
+		, mNumFrames(0)
+		, mError(false)
+	{
+	}
+
+	trace_writer_t::~trace_writer_t()
+	{
+		ASSERTS(mFile == NULL, "trace_writer_t: close() was not called");
+	}
+
+	bool		trace_writer_t::open(const char* filename, alloc_t* allocator, u32 chunk_size)
+	{
+		return open(filename, allocator, chunk_size, x_GetTime());
+	}
+
+	bool		trace_writer_t::open(const char* filename, alloc_t* allocator, u32 chunk_size, tick_t epoch)
+	{
+		ASSERT(mFile == NULL);
+		ASSERT(allocator != NULL);
+
+		FILE* file = fopen(filename, "wb");
+		if (file == NULL)
+			return false;
+
+		// One event never needs more than a few hundred bytes, names are written in pieces
+		mChunkSize = chunk_size < 1024 ? 1024 : chunk_size;
+		mChunkUsed = 0;
+		mAllocator = allocator;
+		mChunk = (char*)mAllocator->allocate(mChunkSize, sizeof(void*));
+		mFile = file;
+		mEpoch = epoch;
+		mNumEvents = 0;
+		mNumBytes = 0;
+		mNumFrames = 0;
+		mError = false;
+
+		append("{\"traceEvents\":[\n");
+		append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"xtime\"}}");
+		return true;
+	}
+
+	bool		trace_writer_t::close()
+	{
+		if (mFile == NULL)
+			return false;
+
+		u32 const num_threads = x_ProfileGetNumThreads();
+		for (u32 i = 0; i < num_threads; ++i)
+		{
+			char name[32];
+			if (!x_ProfileGetThreadName(i, name, sizeof(name)))
+				continue;
+			append(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+			appendNumber(i);
+			append(",\"args\":{\"name\":");
+			appendString(name);
+			append("}}");
+		}
+		append("\n],\"displayTimeUnit\":\"ms\"}\n");
+		flush();
+
+		bool const ok = !mError && fclose((FILE*)mFile) == 0;
+		mAllocator->deallocate(mChunk);
+		mChunk = NULL;
+		mAllocator = NULL;
+		mFile = NULL;
+		return ok;
+	}
+
+	void		trace_writer_t::onProfileEvents(u32 thread, const profile_event_t* events, u32 count)
+	{
+		if (mFile == NULL)
+			return;
+
+		for (u32 i = 0; i < count; ++i)
+		{
+			profile_event_t const& e = events[i];
+			profile_zone_t const* zone = x_ProfileGetZone(e.mZone);
+			beginEvent(zone != NULL ? zone->mName : "?", e.mKind == profile_event_t::BEGIN ? "B" : "E", thread, e.mTime);
+			endEvent();
+		}
+	}
+
+	void		trace_writer_t::writeZone(u32 thread, const char* name, tick_t begin, tick_t end)
+	{
+		if (mFile == NULL)
+			return;
+
+		beginEvent(name, "X", thread, begin);
+		append(",\"dur\":");
+		appendTime(mEpoch + (end - begin));
+		endEvent();
+	}
+
+	void		trace_writer_t::writeCounter(const char* name, tick_t time, f64 value)
+	{
+		// JSON has no nan or inf, a sample without a value leaves a gap in the track
+		if (mFile == NULL || !isfinite(value))
+			return;
+
+		char number[64];
+		snprintf(number, sizeof(number), "%.17g", value);
+		beginEvent(name, "C", 0, time);
+		append(",\"args\":{\"value\":");
+		append(number);
+		append("}");
+		endEvent();
+	}
+
+	void		trace_writer_t::writeFrameMarker(tick_t time, u64 frame)
+	{
+		if (mFile == NULL)
+			return;
+
+		beginEvent("frame", "i", 0, time);
+		append(",\"s\":\"g\",\"args\":{\"frame\":");
+		appendNumber(frame);
+		append("}");
+		endEvent();
+	}
+
+	/**
+	 *  Summary:
+	 *      Mark a frame on the framerate_t and write a frame marker, when the frame
+	 *      rate has been updated it is also written as the "fps" counter.
+	 */
+	void		trace_writer_t::markFrame(framerate_t& framerate)
+	{
+		tick_t const now = x_GetTime();
+		framerate.markFrame(now);
+		writeFrameMarker(now, mNumFrames++);
+
+		f32 fps;
+		if (framerate.getFrameRate(fps))
+			writeCounter("fps", now, fps);
+	}
+
+	void		trace_writer_t::beginEvent(const char* name, const char* phase, u32 thread, tick_t time)
+	{
+		append(",\n{\"name\":");
+		appendString(name);
+		append(",\"ph\":\"");
+		append(phase);
+		append("\",\"ts\":");
+		appendTime(time);
+		append(",\"pid\":1,\"tid\":");
+		appendNumber(thread);
+	}
+
+	void		trace_writer_t::endEvent()
+	{
+		append("}");
+		mNumEvents++;
+	}
+
+	void		trace_writer_t::append(const char* str)
+	{
+		while (*str != '\0')
+		{
+			if (mChunkUsed == mChunkSize)
+				flush();
+			mChunk[mChunkUsed++] = *str++;
+		}
+	}
+
+	void		trace_writer_t::appendString(const char* str)
+	{
+		static const char* sHex = "0123456789abcdef";
+
+		char escaped[7];
+		append("\"");
+		for (; *str != '\0'; ++str)
+		{
+			unsigned char const c = (unsigned char)*str;
+			if (c == '"' || c == '\\')
+			{
+				escaped[0] = '\\';
+				escaped[1] = (char)c;
+				escaped[2] = '\0';
+			}
+			else if (c < 0x20)
+			{
+				escaped[0] = '\\';
+				escaped[1] = 'u';
+				escaped[2] = '0';
+				escaped[3] = '0';
+				escaped[4] = sHex[c >> 4];
+				escaped[5] = sHex[c & 15];
+				escaped[6] = '\0';
+			}
+			else
+			{
+				escaped[0] = (char)c;
+				escaped[1] = '\0';
+			}
+			append(escaped);
+		}
+		append("\"");
+	}
+
+	void		trace_writer_t::appendNumber(u64 value)
+	{
+		char digits[24];
+		s32 i = sizeof(digits) - 1;
+		digits[i] = '\0';
+		do
+		{
+			digits[--i] = (char)('0' + (value % 10));
+			value /= 10;
+		} while (value != 0);
+		append(&digits[i]);
+	}
+
+	// Microseconds since the epoch with 3 decimals, the split avoids overflow of
+	// the multiplication for long captures.
+	void		trace_writer_t::appendTime(tick_t time)
+	{
+		s64 ticks = time - mEpoch;
+		if (ticks < 0)
+		{
+			append("-");
+			ticks = -ticks;
+		}
+		u64 const tps = (u64)x_GetTicksPerSecond();
+		u64 const t = (u64)ticks;
+		u64 const ns = (t / tps) * 1000000000 + ((t % tps) * 1000000000) / tps;
+
+		appendNumber(ns / 1000);
+		char fraction[5];
+		u64 const frac = ns % 1000;
+		fraction[0] = '.';
+		fraction[1] = (char)('0' + (frac / 100));
+		fraction[2] = (char)('0' + ((frac / 10) % 10));
+		fraction[3] = (char)('0' + (frac % 10));
+		fraction[4] = '\0';
+		append(fraction);
+	}
+
+	void		trace_writer_t::flush()
+	{
+		if (mChunkUsed == 0)
+			return;
+		if (fwrite(mChunk, 1, mChunkUsed, (FILE*)mFile) != mChunkUsed)
+			mError = true;
+		mNumBytes += mChunkUsed;
+		mChunkUsed = 0;
+	}
+};
@@ -0,0 +1,114 @@
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_virtual_time.h"
+
+namespace xcore
+{
+	namespace xvirtualtime
+	{
+		static const u64		sTicksTo1601 = X_CONSTANT_64(504911232000000000);
+		static const s64		sTicksPerMinute = X_CONSTANT_64(600000000);
+	}
+
+	virtual_time_t::virtual_time_t(s64 ticks_per_second, const datetime_t& origin)
+		: mTicks(0)
+		, mTicksPerSecond(ticks_per_second)
+		, mOrigin(origin)
+		, mTimeZone(0)
+	{
+		ASSERT(ticks_per_second > 0);
+	}
+
+	void		virtual_time_t::set(tick_t ticks)
+	{
+		mTicks.store(ticks, std::memory_order_release);
+	}
+
+	void		virtual_time_t::advance(tick_t ticks)
+	{
+		ASSERTS(ticks >= 0, "virtual_time_t: time can not go backwards");
+		mTicks.fetch_add(ticks, std::memory_order_acq_rel);
+	}
+
+	void		virtual_time_t::advanceTo(tick_t ticks)
+	{
+		s64 current = mTicks.load(std::memory_order_relaxed);
+		while (current < ticks && !mTicks.compare_exchange_weak(current, ticks, std::memory_order_acq_rel, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void		virtual_time_t::advanceSeconds(f64 seconds)
+	{
+		advance((tick_t)(seconds * (f64)mTicksPerSecond + 0.5));
+	}
+
+	s64			virtual_time_t::getTimeInTicks()
+	{
+		return mTicks.load(std::memory_order_acquire);
+	}
+
+	s64			virtual_time_t::getTicksPerSecond()
+	{
+		return mTicksPerSecond;
+	}
+
+	bool		virtual_time_t::sleepUntil(tick_t deadline)
+	{
+		advanceTo(deadline);
+		return true;
+	}
+
+	// Elapsed ticks to datetime_t ticks (100 nanosecond units), split to avoid overflow
+	u64			virtual_time_t::getSystemTimeUtc()
+	{
+		s64 const ticks = mTicks.load(std::memory_order_acquire);
+		s64 const perSecond = (s64)timespan_t::sTicksPerSecond;
+		s64 const span = (ticks / mTicksPerSecond) * perSecond + ((ticks % mTicksPerSecond) * perSecond) / mTicksPerSecond;
+		return mOrigin.ticks() + (u64)span;
+	}
+
+	u64			virtual_time_t::getSystemTimeLocal()
+	{
+		return getSystemTimeUtc() + (u64)((s64)mTimeZone * xvirtualtime::sTicksPerMinute);
+	}
+
+	// The bias of the datetime source has the opposite sign of the time zone offset
+	s64			virtual_time_t::getSystemTimeZone()
+	{
+		return -(s64)mTimeZone;
+	}
+
+	u64			virtual_time_t::getSystemTimeAsFileTime()
+	{
+		return getSystemTimeUtc() - xvirtualtime::sTicksTo1601;
+	}
+
+	u64			virtual_time_t::getSystemTimeFromFileTime(u64 inFileSystemTime)
+	{
+		return inFileSystemTime + xvirtualtime::sTicksTo1601 + (u64)((s64)mTimeZone * xvirtualtime::sTicksPerMinute);
+	}
+
+	u64			virtual_time_t::getFileTimeFromSystemTime(u64 inSystemTime)
+	{
+		return inSystemTime - xvirtualtime::sTicksTo1601 - (u64)((s64)mTimeZone * xvirtualtime::sTicksPerMinute);
+	}
+
+	/**
+	 * virtual_time_scope_t
+	 */
+	virtual_time_scope_t::virtual_time_scope_t(virtual_time_t& time)
+	{
+		mPreviousTime = x_SetThreadTimeSource(&time);
+		mPreviousDateTime = x_SetThreadDateTimeSource(&time);
+	}
+
+	virtual_time_scope_t::~virtual_time_scope_t()
+	{
+		x_SetThreadTimeSource(mPreviousTime);
+		x_SetThreadDateTimeSource(mPreviousDateTime);
+	}
+};
@@ -0,0 +1,16 @@
+#ifndef __X_TIME_CPU_TIME_SOURCE_H__
+#define __X_TIME_CPU_TIME_SOURCE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace xcore
+{
+    // The platform specific part, CPU time (user + kernel) consumed by the calling thread or the process in nanoseconds
+    extern s64 x_GetThreadCpuTimeNs();
+    extern s64 x_GetProcessCpuTimeNs();
+
+}; // namespace xcore
+
+#endif
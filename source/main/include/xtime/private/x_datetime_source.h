@@ -15,13 +15,18 @@ namespace xcore
         // The platform specific part
         virtual u64 getSystemTimeUtc() = 0;
         virtual u64 getSystemTimeLocal() = 0;
+        ///< Minutes from local time to UTC (UTC = local + bias, the Windows bias), e.g. -60 for UTC+1
         virtual s64 getSystemTimeZone() = 0;
         virtual u64 getSystemTimeAsFileTime() = 0;
         virtual u64 getSystemTimeFromFileTime(u64 inFileSystemTime) = 0;
         virtual u64 getFileTimeFromSystemTime(u64 inSystemTime) = 0;
     };
 
-    extern void x_SetDateTimeSource(datetime_source_t *);
+    ///< Publishes a new source (NULL selects the default), returns the previous one once no thread uses it anymore
+    extern datetime_source_t *x_SetDateTimeSource(datetime_source_t *);
+
+    ///< Overrides the source for the calling thread only (NULL removes the override), returns the previous override
+    extern datetime_source_t *x_SetThreadDateTimeSource(datetime_source_t *);
 
 }; // namespace xcore
 
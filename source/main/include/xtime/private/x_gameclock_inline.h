@@ -0,0 +1,5 @@
+//------------------------------------------------------------------------------
+inline tick_t gameclock_t::now(tick_t real) const
+{
+    return mBase + (tick_t)((f64)(real - mAnchor) * mRate);
+}
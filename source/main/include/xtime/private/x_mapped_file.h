@@ -0,0 +1,38 @@
+#ifndef __X_TIME_MAPPED_FILE_H__
+#define __X_TIME_MAPPED_FILE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace xcore
+{
+    // The platform specific part of record_file_t, a file mapped into memory as a whole.
+    // A file must be unmapped (mapped with a size of 0) before it is resized.
+    struct mapped_file_t
+    {
+        mapped_file_t()
+            : mFile(NULL), mMapping(NULL), mBase(NULL), mMappedSize(0), mWritable(false)
+        {
+        }
+
+        void *mFile;    ///< File descriptor + 1 (posix) or HANDLE (win32)
+        void *mMapping; ///< Mapping object (win32)
+        u8 *mBase;
+        u64 mMappedSize;
+        bool mWritable;
+    };
+
+    ///< A writable file is created when it does not exist
+    extern bool x_MappedFileOpen(mapped_file_t &file, const char *filename, bool writable);
+    extern void x_MappedFileClose(mapped_file_t &file);
+    extern bool x_MappedFileGetSize(mapped_file_t &file, u64 &outSize);
+    extern bool x_MappedFileResize(mapped_file_t &file, u64 size);
+    ///< Maps the first 'size' bytes, a size of 0 unmaps the file
+    extern bool x_MappedFileMap(mapped_file_t &file, u64 size);
+    ///< Writes the mapped range to disk and waits for it
+    extern bool x_MappedFileFlush(mapped_file_t &file, u64 offset, u64 size);
+
+}; // namespace xcore
+
+#endif
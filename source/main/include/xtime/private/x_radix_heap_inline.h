@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+template <typename T>
+inline radix_heap_t<T>::radix_heap_t()
+    : mAllocator(NULL), mInitialCapacity(16), mSize(0), mLastKey(0), mOccupied(0)
+{
+    for (s32 i = 0; i < NUM_BUCKETS; ++i)
+    {
+        mBuckets[i].mEntries = NULL;
+        mBuckets[i].mSize = 0;
+        mBuckets[i].mCapacity = 0;
+        mBuckets[i].mMinKey = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline radix_heap_t<T>::~radix_heap_t()
+{
+    ASSERTS(mAllocator == NULL, "radix_heap_t: exit() was not called");
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline void radix_heap_t<T>::init(alloc_t *allocator, u32 initial_bucket_capacity)
+{
+    ASSERT(allocator != NULL);
+    mAllocator = allocator;
+    mInitialCapacity = initial_bucket_capacity > 0 ? initial_bucket_capacity : 1;
+    clear();
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline void radix_heap_t<T>::exit()
+{
+    for (s32 i = 0; i < NUM_BUCKETS; ++i)
+    {
+        if (mBuckets[i].mEntries != NULL)
+            mAllocator->deallocate(mBuckets[i].mEntries);
+        mBuckets[i].mEntries = NULL;
+        mBuckets[i].mSize = 0;
+        mBuckets[i].mCapacity = 0;
+    }
+    mAllocator = NULL;
+    mSize = 0;
+    mLastKey = 0;
+    mOccupied = 0;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline void radix_heap_t<T>::clear()
+{
+    for (s32 i = 0; i < NUM_BUCKETS; ++i)
+        mBuckets[i].mSize = 0;
+    mSize = 0;
+    mLastKey = 0;
+    mOccupied = 0;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline s32 radix_heap_t<T>::bucketIndex(u64 key) const
+{
+    u64 const diff = key ^ mLastKey;
+    return diff == 0 ? 0 : (64 - xtime_clz64(diff));
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline void radix_heap_t<T>::grow(bucket_t &bucket)
+{
+    u32 const capacity = bucket.mCapacity == 0 ? mInitialCapacity : bucket.mCapacity * 2;
+    entry_t *entries = (entry_t *)mAllocator->allocate(capacity * (u32)sizeof(entry_t), (u32)sizeof(void *));
+    for (u32 i = 0; i < bucket.mSize; ++i)
+        entries[i] = bucket.mEntries[i];
+    if (bucket.mEntries != NULL)
+        mAllocator->deallocate(bucket.mEntries);
+    bucket.mEntries = entries;
+    bucket.mCapacity = capacity;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline void radix_heap_t<T>::append(s32 index, u64 key, const T &value)
+{
+    bucket_t &bucket = mBuckets[index];
+    if (bucket.mSize == bucket.mCapacity)
+        grow(bucket);
+
+    if (bucket.mSize == 0 || key < bucket.mMinKey)
+        bucket.mMinKey = key;
+
+    entry_t &entry = bucket.mEntries[bucket.mSize++];
+    entry.mKey = key;
+    entry.mValue = value;
+
+    if (index > 0)
+        mOccupied |= (u64)1 << (index - 1);
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline void radix_heap_t<T>::push(u64 key, const T &value)
+{
+    ASSERTS(key >= mLastKey, "radix_heap_t: key is smaller than the last popped key");
+    append(bucketIndex(key), key, value);
+    mSize++;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline bool radix_heap_t<T>::pop(u64 &key, T &value)
+{
+    if (mSize == 0)
+        return false;
+
+    bucket_t &first = mBuckets[0];
+    if (first.mSize == 0)
+    {
+        // Redistribute the lowest non-empty bucket around its minimum key, all
+        // of its entries will end up in lower buckets.
+        s32 const index = xtime_ctz64(mOccupied) + 1;
+        bucket_t &bucket = mBuckets[index];
+
+        mLastKey = bucket.mMinKey;
+        mOccupied &= ~((u64)1 << (index - 1));
+
+        u32 const count = bucket.mSize;
+        bucket.mSize = 0;
+        for (u32 i = 0; i < count; ++i)
+        {
+            entry_t const &entry = bucket.mEntries[i];
+            append(bucketIndex(entry.mKey), entry.mKey, entry.mValue);
+        }
+    }
+
+    entry_t const &entry = first.mEntries[--first.mSize];
+    key = entry.mKey;
+    value = entry.mValue;
+    mSize--;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline bool radix_heap_t<T>::pop(tick_t &key, T &value)
+{
+    u64 ukey;
+    if (!pop(ukey, value))
+        return false;
+    key = (tick_t)ukey;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline bool radix_heap_t<T>::top(u64 &key) const
+{
+    if (mSize == 0)
+        return false;
+
+    if (mBuckets[0].mSize > 0)
+        key = mLastKey;
+    else
+        key = mBuckets[xtime_ctz64(mOccupied) + 1].mMinKey;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+inline bool radix_heap_t<T>::remove(const T &value)
+{
+    for (s32 index = 0; index < NUM_BUCKETS; ++index)
+    {
+        bucket_t &bucket = mBuckets[index];
+        for (u32 i = 0; i < bucket.mSize; ++i)
+        {
+            if (!(bucket.mEntries[i].mValue == value))
+                continue;
+
+            bucket.mEntries[i] = bucket.mEntries[--bucket.mSize];
+            mSize--;
+            if (index == 0)
+                return true;
+
+            if (bucket.mSize == 0)
+            {
+                mOccupied &= ~((u64)1 << (index - 1));
+                return true;
+            }
+            bucket.mMinKey = bucket.mEntries[0].mKey;
+            for (u32 j = 1; j < bucket.mSize; ++j)
+            {
+                if (bucket.mEntries[j].mKey < bucket.mMinKey)
+                    bucket.mMinKey = bucket.mEntries[j].mKey;
+            }
+            return true;
+        }
+    }
+    return false;
+}
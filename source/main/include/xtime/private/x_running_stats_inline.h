@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+inline running_stats_t::running_stats_t()
+    : mCount(0), mMean(0.0), mM2(0.0), mMin(0.0), mMax(0.0)
+{
+}
+
+//------------------------------------------------------------------------------
+inline void running_stats_t::reset()
+{
+    mCount = 0;
+    mMean = 0.0;
+    mM2 = 0.0;
+    mMin = 0.0;
+    mMax = 0.0;
+}
+
+//------------------------------------------------------------------------------
+inline void running_stats_t::add(f64 sample)
+{
+    if (mCount == 0)
+    {
+        mMin = sample;
+        mMax = sample;
+    }
+    else
+    {
+        if (sample < mMin)
+            mMin = sample;
+        if (sample > mMax)
+            mMax = sample;
+    }
+
+    mCount++;
+    f64 const delta = sample - mMean;
+    mMean += delta / (f64)mCount;
+    mM2 += delta * (sample - mMean);
+}
+
+//------------------------------------------------------------------------------
+inline void running_stats_t::merge(const running_stats_t &other)
+{
+    if (other.mCount == 0)
+        return;
+    if (mCount == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    u64 const count = mCount + other.mCount;
+    f64 const delta = other.mMean - mMean;
+    mMean += delta * (f64)other.mCount / (f64)count;
+    mM2 += other.mM2 + delta * delta * (f64)mCount * (f64)other.mCount / (f64)count;
+    mCount = count;
+    if (other.mMin < mMin)
+        mMin = other.mMin;
+    if (other.mMax > mMax)
+        mMax = other.mMax;
+}
+
+//------------------------------------------------------------------------------
+inline f64 running_stats_t::variance() const
+{
+    if (mCount < 2)
+        return 0.0;
+    return mM2 / (f64)(mCount - 1);
+}
@@ -0,0 +1,15 @@
+#ifndef __X_TIME_SLEEP_SOURCE_H__
+#define __X_TIME_SLEEP_SOURCE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace xcore
+{
+    // The platform specific part, sleep in the kernel for (at least) the given number of ticks
+    extern void x_KernelSleep(s64 inTicks);
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+inline stopwatch_t::stopwatch_t()
+    : mStartTime(0), mTotalTime(0), mLastLap(0), mIsRunning(false), mLaps(NULL), mLapCapacity(0), mLapHead(0)
+{
+}
+
+//------------------------------------------------------------------------------
+inline void stopwatch_t::start()
+{
+    if (mIsRunning)
+        return;
+
+    mStartTime = x_GetTime();
+    mIsRunning = true;
+}
+
+//------------------------------------------------------------------------------
+inline void stopwatch_t::reset()
+{
+    mIsRunning = false;
+    mStartTime = 0;
+    mTotalTime = 0;
+    mLastLap = 0;
+    mLapHead = 0;
+    mStats.reset();
+}
+
+//------------------------------------------------------------------------------
+inline tick_t stopwatch_t::stop()
+{
+    if (mIsRunning)
+    {
+        mTotalTime += x_GetTime() - mStartTime;
+        mIsRunning = false;
+    }
+    return mTotalTime;
+}
+
+//------------------------------------------------------------------------------
+inline tick_t stopwatch_t::read() const
+{
+    if (mIsRunning)
+        return mTotalTime + (x_GetTime() - mStartTime);
+    return mTotalTime;
+}
+
+//------------------------------------------------------------------------------
+// The time the stopwatch was stopped during a lap does not count
+inline tick_t stopwatch_t::trip()
+{
+    if (!mIsRunning)
+        return 0;
+
+    tick_t const now = x_GetTime();
+    tick_t const lap = mTotalTime + (now - mStartTime);
+    mTotalTime = 0;
+    mStartTime = now;
+
+    mLastLap = lap;
+    mStats.add((f64)lap);
+    if (mLapCapacity > 0)
+    {
+        mLaps[mLapHead % mLapCapacity] = lap;
+        mLapHead++;
+        if (mLapHead == 2 * mLapCapacity)
+            mLapHead = mLapCapacity;
+    }
+    return lap;
+}
+
+//------------------------------------------------------------------------------
+inline void stopwatch_t::setLapBuffer(tick_t *laps, u32 capacity)
+{
+    mLaps = laps;
+    mLapCapacity = laps != NULL ? capacity : 0;
+    mLapHead = 0;
+}
+
+//------------------------------------------------------------------------------
+inline u32 stopwatch_t::getNumStoredLaps() const
+{
+    return mLapHead < mLapCapacity ? mLapHead : mLapCapacity;
+}
+
+//------------------------------------------------------------------------------
+inline tick_t stopwatch_t::getLap(u32 index) const
+{
+    u32 const stored = getNumStoredLaps();
+    if (index >= stored)
+        return 0;
+    return mLaps[(mLapHead - stored + index) % mLapCapacity];
+}
+
+//------------------------------------------------------------------------------
+inline f64 stopwatch_t::getMeanMs() const
+{
+    return mStats.mean() * 1000.0 / (f64)x_GetTicksPerSecond();
+}
+
+//------------------------------------------------------------------------------
+inline f64 stopwatch_t::getStdDevMs() const
+{
+    return mStats.stddev() * 1000.0 / (f64)x_GetTicksPerSecond();
+}
+
+//------------------------------------------------------------------------------
+inline f64 stopwatch_t::getMinMs() const
+{
+    return x_TicksToMs(getMin());
+}
+
+//------------------------------------------------------------------------------
+inline f64 stopwatch_t::getMaxMs() const
+{
+    return x_TicksToMs(getMax());
+}
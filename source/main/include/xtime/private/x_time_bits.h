@@ -0,0 +1,95 @@
+#ifndef __X_TIME_BITS_H__
+#define __X_TIME_BITS_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <string.h>
+
+namespace xcore
+{
+    // Number of leading zero bits, 'value' must not be 0
+    inline s32 xtime_clz64(u64 value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return 63 - (s32)index;
+#else
+        return __builtin_clzll(value);
+#endif
+    }
+
+    // Number of trailing zero bits, 'value' must not be 0
+    inline s32 xtime_ctz64(u64 value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return (s32)index;
+#else
+        return __builtin_ctzll(value);
+#endif
+    }
+
+    // Number of bits needed to represent 'value', 0 for a value of 0
+    inline s32 xtime_bitwidth64(u64 value)
+    {
+        return value == 0 ? 0 : (64 - xtime_clz64(value));
+    }
+
+    inline u64 xtime_bswap64(u64 value)
+    {
+#if defined(_MSC_VER)
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+
+    // Unaligned big-endian load, the first byte ends up in the most significant bits
+    inline u64 xtime_load_be64(const u8 *ptr)
+    {
+        u64 value;
+        memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        return value;
+#else
+        return xtime_bswap64(value);
+#endif
+    }
+
+    // Hint to the cpu that the cache line of 'ptr' will be read soon
+    inline void xtime_prefetch(const void *ptr)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch((const char *)ptr, _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(ptr);
+#endif
+    }
+
+    // Hint to the cpu that we are in a spin-wait loop
+    inline void xtime_cpu_pause()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(_MSC_VER)
+        __yield();
+#elif defined(__i386__) || defined(__x86_64__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+}; // namespace xcore
+
+#endif
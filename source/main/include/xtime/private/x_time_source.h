@@ -14,9 +14,19 @@ namespace xcore
 
         virtual s64 getTimeInTicks() = 0;
         virtual s64 getTicksPerSecond() = 0;
+
+        ///< A source can implement waiting itself (a virtual source advances), return false to wait in real time
+        virtual bool sleepUntil(s64 /*deadline*/) { return false; }
     };
 
-    extern void x_SetTimeSource(time_source_t *);
+    ///< Publishes a new source (NULL selects the default), returns the previous one once no thread uses it anymore
+    extern time_source_t *x_SetTimeSource(time_source_t *);
+
+    ///< Overrides the source for the calling thread only (NULL removes the override), returns the previous override
+    extern time_source_t *x_SetThreadTimeSource(time_source_t *);
+
+    ///< Lets the active source of the calling thread handle a sleep, returns false when it can not
+    extern bool x_TimeSourceSleepUntil(s64 deadline);
 
 }; // namespace xcore
 
@@ -0,0 +1,70 @@
+#ifndef __X_TIME_ASOF_JOIN_H__
+#define __X_TIME_ASOF_JOIN_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_timespan.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      As-of join of two sorted (non-decreasing) datetime_t columns: every left
+     *      row is matched with the latest right row at or before it, e.g. a trade
+     *      with the quote that was valid at the time of the trade. Of right rows
+     *      with the same time the last one is taken. With a tolerance, a right row
+     *      that is older than the tolerance is no match.
+     *
+     *      The join is one linear merge of both columns, the right column is
+     *      skipped with a galloping search where it is much denser than the left.
+     *      The result is a list of index pairs in left order, written to a buffer
+     *      of the caller with room for one pair per left row, nothing is allocated.
+     *
+     *      With more than one thread the left column is split into contiguous
+     *      partitions, each partition finds its start in the right column with a
+     *      search and merges on its own thread. The result is the same as that of
+     *      the single threaded merge.
+     *
+     *  Example:
+     * <CODE>
+     *       asof_options_t options;
+     *       options.mTolerance = timespan_t::sFromSeconds(1);
+     *       u32 n = x_AsOfJoin(trade_times, num_trades, quote_times, num_quotes, pairs, options);
+     *       for (u32 i = 0; i < n; ++i)
+     *           process(trades[pairs[i].mLeft], quotes[pairs[i].mRight]);
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    struct asof_pair_t
+    {
+        enum
+        {
+            NO_MATCH = 0xffffffff,
+        };
+
+        u32 mLeft;
+        u32 mRight; ///< NO_MATCH for an unmatched left row when those are kept
+    };
+
+    struct asof_options_t
+    {
+        asof_options_t();
+
+        timespan_t mTolerance;   ///< Maximum age of the matched right row, timespan_t::sMaxValue for any age
+        bool mKeepUnmatched;     ///< Write unmatched left rows too (a left outer join)
+        u32 mNumThreads;         ///< 1 merges on the calling thread, 0 uses all hardware threads
+        u32 mMinRowsPerThread;   ///< Left rows per thread below which fewer threads are used
+    };
+
+    ///< Returns the number of pairs written to 'out_pairs', which has room for 'num_left' pairs
+    extern u32 x_AsOfJoin(const datetime_t *left, u32 num_left, const datetime_t *right, u32 num_right, asof_pair_t *out_pairs,
+                          const asof_options_t &options = asof_options_t());
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef __X_TIME_CLOCK_PAIR_H__
+#define __X_TIME_CLOCK_PAIR_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A clock_pair_t is a snapshot of the monotonic clock (x_GetTime()) and the
+     *      wall clock (datetime_t::sNowUtc()) at the same moment.
+     *
+     *      The wall clock is read between two reads of the monotonic clock, the tick
+     *      of the pair is the middle of that bracket and the uncertainty is half of
+     *      its width. x_SampleClockPair() takes a number of samples and keeps the one
+     *      with the narrowest bracket.
+     * ------------------------------------------------------------------------------
+     */
+    struct clock_pair_t
+    {
+        tick_t mTicks;
+        u64 mDateTime;       ///< datetime_t ticks (UTC), 100 nanosecond units
+        tick_t mUncertainty; ///< In ticks, +/- around mTicks
+    };
+
+    extern void x_SampleClockPair(clock_pair_t &pair, u32 attempts = 8);
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Converts tick_t to datetime_t (UTC) with a linear map and without a system
+     *      call per conversion.
+     *
+     *      The map is anchored on a clock_pair_t. Its rate is measured between two
+     *      anchors and is clamped to the nominal rate +/- 'max_drift_ppm', so a step
+     *      of the wall clock (NTP, the user changing the time) can not skew it. Call
+     *      update() regularly, it re-anchors the map when the anchor is older than
+     *      the re-anchor interval which bounds the drift of the conversion.
+     *
+     *  Example:
+     * <CODE>
+     *       tick_datetime_map_t map;
+     *       map.init(x_SecondsToTicks(1.0));
+     *       ...
+     *       map.update();   // once per frame
+     *       datetime_t when = map.toDateTime(event.mTime);
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class tick_datetime_map_t
+    {
+    public:
+        tick_datetime_map_t();
+
+        void init(tick_t reanchor_interval, u32 max_drift_ppm = 500, u32 attempts = 8);
+
+        bool update();                        ///< Re-anchors when the interval has passed, returns true when it did
+        bool update(tick_t now);
+        void anchor();                        ///< Re-anchors now
+        void anchor(const clock_pair_t &pair); ///< Re-anchors on a given sample
+
+        datetime_t toDateTime(tick_t ticks) const;
+        u64 toDateTimeTicks(tick_t ticks) const;
+        tick_t toTicks(const datetime_t &dt) const;
+
+        const clock_pair_t &getAnchor() const { return mAnchor; }
+        u32 getNumAnchors() const { return mNumAnchors; }
+        f64 getRate() const { return mRate; }            ///< datetime_t ticks per tick
+        f64 getNominalRate() const { return mNominalRate; }
+        s64 getLastError() const { return mLastError; }  ///< datetime_t ticks, prediction of the old map minus the new sample
+
+    private:
+        clock_pair_t mAnchor;
+        tick_t mInterval;
+        u32 mAttempts;
+        u32 mNumAnchors;
+        f64 mNominalRate;
+        f64 mMaxDrift;
+        f64 mRate;
+        s64 mLastError;
+    };
+
+}; // namespace xcore
+
+#endif
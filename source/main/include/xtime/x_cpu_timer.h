@@ -0,0 +1,124 @@
+#ifndef __X_TIME_CPU_TIMER_H__
+#define __X_TIME_CPU_TIMER_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_timer.h"
+
+namespace xcore
+{
+    ///< CPU time (user + kernel) consumed by the calling thread or by the whole process, in x_GetTicksPerSecond() units
+    extern tick_t x_GetThreadCpuTime();
+    extern tick_t x_GetProcessCpuTime();
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A timer that measures CPU time instead of wall time, with the same interface
+     *      as timer_t. The THREAD clock measures the CPU time of the calling thread, so
+     *      such a timer should be started and stopped on the same thread. The PROCESS
+     *      clock measures the CPU time of all threads of the process together.
+     *
+     *      The results are converted to x_GetTicksPerSecond() units, x_TicksToMs()
+     *      and friends work as for a timer_t. The resolution depends on the platform,
+     *      on Windows it is the length of a scheduler quantum.
+     *
+     *  Example:
+     * <CODE>
+     *       cpu_timer_t cpu(cpu_timer_t::THREAD);
+     *       cpu.start();
+     *       someFunction();
+     *       x_printf("CPU time %f ms", cpu.stopMs());
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class cpu_timer_t
+    {
+    public:
+        enum EClock
+        {
+            THREAD = 0,
+            PROCESS = 1,
+        };
+
+        cpu_timer_t(EClock clock = THREAD);
+
+        void start();
+        void reset();
+
+        tick_t stop();
+        tick_t read() const;
+        tick_t trip();
+
+        bool isRunning() const { return mIsRunning; }
+        s32 getNumTrips() const { return mNumTrips; }
+        EClock getClock() const { return mClock; }
+
+        f64 stopSec() { return x_TicksToSec(stop()); }
+        f64 stopMs() { return x_TicksToMs(stop()); }
+        f64 stopUs() { return x_TicksToUs(stop()); }
+
+        f64 readSec() const { return x_TicksToSec(read()); }
+        f64 readMs() const { return x_TicksToMs(read()); }
+        f64 readUs() const { return x_TicksToUs(read()); }
+
+        f64 tripSec() { return x_TicksToSec(trip()); }
+        f64 tripMs() { return x_TicksToMs(trip()); }
+        f64 tripUs() { return x_TicksToUs(trip()); }
+
+    private:
+        s64 now() const;
+
+        EClock mClock;
+        s64 mStartTime; ///< In nanoseconds
+        s64 mTotalTime; ///< In nanoseconds
+        bool mIsRunning;
+        s32 mNumTrips;
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Wall time, thread CPU time and process CPU time measured over the same
+     *      interval. The utilization is the CPU time divided by the wall time, a
+     *      thread that is CPU-bound has a utilization close to 1.0, a thread that
+     *      waits has a low utilization. The process utilization can be larger than
+     *      1.0 when multiple threads are running.
+     * ------------------------------------------------------------------------------
+     */
+    struct cpu_usage_t
+    {
+        tick_t mWall;
+        tick_t mThreadCpu;
+        tick_t mProcessCpu;
+        f64 mThreadUtilization;
+        f64 mProcessUtilization;
+    };
+
+    class cpu_usage_timer_t
+    {
+    public:
+        cpu_usage_timer_t();
+
+        void start();
+        void reset();
+        void stop(cpu_usage_t &usage);
+        void read(cpu_usage_t &usage) const;
+        void trip(cpu_usage_t &usage);
+
+        bool isRunning() const { return mWall.isRunning(); }
+
+    private:
+        static void sFill(cpu_usage_t &usage, tick_t wall, tick_t thread, tick_t process);
+
+        timer_t mWall;
+        cpu_timer_t mThread;
+        cpu_timer_t mProcess;
+    };
+
+}; // namespace xcore
+
+#endif
@@ -118,7 +118,8 @@ namespace xcore
 		s32 second() const;
 		s32 millisecond() const;
 
-		u64 ticks() const;
+		///< Between sMinValue and sMaxValue, inline for the loops over columns of datetime_t
+		u64 ticks() const { return (u64)__ticks(); }
 
 		datetime_t &add(const timespan_t &value);
 
@@ -0,0 +1,117 @@
+#ifndef __X_TIME_DELTA_CODEC_H__
+#define __X_TIME_DELTA_CODEC_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Compression of timestamp streams (tick_t or datetime_t ticks) with delta
+     *      of delta encoding, as in Facebook's Gorilla.
+     *
+     *      The first value is stored as is (64 bits). For every next value the delta
+     *      to the previous value is computed and the difference with the previous
+     *      delta (the delta of delta) is stored zigzag encoded with a prefix code:
+     *          0                       delta of delta is 0
+     *          10    +  8 bits
+     *          110   + 14 bits
+     *          1110  + 20 bits
+     *          11110 + 32 bits
+     *          11111 + 64 bits
+     *      Evenly spaced timestamps cost 1 bit each, timestamps with a little
+     *      jitter 10 to 17 bits.
+     *
+     *      The bits are written most significant bit first into a buffer owned by
+     *      the caller, nothing is allocated or copied. The number of values is not
+     *      stored, the caller keeps it next to the buffer (getNumValues()).
+     *      read(tick_t*, count) is the fast batch path, it refills a 64 bit buffer
+     *      with one unaligned load per value and looks the code length up from the
+     *      first 5 bits, a run of zero bits is decoded as a run of values.
+     *
+     *  Example:
+     * <CODE>
+     *       u8 buffer[4096];
+     *       delta_encoder_t encoder;
+     *       encoder.init(buffer, sizeof(buffer));
+     *       while (encoder.write(x_GetTime()))
+     *           wait();
+     *       u32 const bytes = encoder.finish();
+     *
+     *       delta_decoder_t decoder;
+     *       decoder.init(buffer, bytes, encoder.getNumValues());
+     *       tick_t t;
+     *       while (decoder.read(t))
+     *           process(t);
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class delta_encoder_t
+    {
+    public:
+        delta_encoder_t();
+
+        void init(u8 *buffer, u32 capacity);
+
+        ///< Returns false (and writes nothing) when the value does not fit anymore
+        bool write(tick_t value);
+        bool write(const datetime_t &value) { return write((tick_t)value.ticks()); }
+        ///< Returns the number of values that were written
+        u32 write(const tick_t *values, u32 count);
+
+        ///< Writes the last partial byte, returns the number of bytes used
+        u32 finish();
+
+        u32 getNumValues() const { return mNumValues; }
+        u32 getNumBytes() const { return mSize + ((mNumPending + 7) >> 3); }
+        u8 *getBuffer() const { return mBuffer; }
+
+    private:
+        u8 *mBuffer;
+        u32 mCapacity;
+        u32 mSize;
+        u64 mPending;     ///< Bits that do not form a whole byte yet, right aligned
+        u32 mNumPending;
+        u32 mNumValues;
+        tick_t mLast;
+        tick_t mLastDelta;
+        bool mFinished;
+    };
+
+    class delta_decoder_t
+    {
+    public:
+        delta_decoder_t();
+
+        void init(const u8 *buffer, u32 size, u32 count);
+
+        bool read(tick_t &value);
+        bool read(datetime_t &value);
+        ///< Returns the number of values that were read, at most 'count'
+        u32 read(tick_t *values, u32 count);
+
+        u32 getNumRemaining() const { return mRemaining; }
+
+    private:
+        u64 peek(u32 &avail) const;
+        u64 readBits(u32 n);
+        void readOne();
+
+        const u8 *mBuffer;
+        u32 mSize;
+        u64 mPosition;    ///< In bits
+        u32 mRemaining;
+        u32 mNumRead;
+        tick_t mLast;
+        tick_t mLastDelta;
+    };
+
+}; // namespace xcore
+
+#endif
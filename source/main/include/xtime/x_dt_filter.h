@@ -0,0 +1,136 @@
+#ifndef __X_TIME_DT_FILTER_H__
+#define __X_TIME_DT_FILTER_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class framerate_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Smooths the frame delta of a game loop and removes the spikes that come
+     *      from the OS or from loading, so that one hiccup does not inject a huge
+     *      delta into a simulation.
+     *
+     *      Every raw delta is first capped at the maximum delta (250 ms by default),
+     *      then one of the filters is applied:
+     *          NONE    the capped delta
+     *          EMA     exponential moving average with a configurable weight
+     *          MEDIAN  median of the last N deltas (N <= MAX_WINDOW)
+     *          VSYNC   snapped to a whole number of refresh periods when it is within
+     *                  the tolerance of one, the snapping error is carried over to the
+     *                  next frame so the filtered time does not drift from real time
+     *
+     *      Every filter is O(1) per frame (the median window is bounded).
+     *
+     *      markFrame(now) takes the time of the frame from the caller, so that a
+     *      framerate_t and a dt_filter_t can share one clock read. When a framerate_t
+     *      is attached markFrame() forwards the time to it.
+     *
+     *  Example:
+     * <CODE>
+     *       framerate_t fps;
+     *       dt_filter_t dt;
+     *       dt.setMode(dt_filter_t::VSYNC);
+     *       dt.setRefreshRate(60.0);
+     *       dt.attach(&fps);
+     *
+     *       while (game_loop)
+     *       {
+     *           simulate(x_TicksToSec(dt.markFrame()));
+     *           render();
+     *       }
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class dt_filter_t
+    {
+    public:
+        enum EMode
+        {
+            NONE = 0,
+            EMA,
+            MEDIAN,
+            VSYNC,
+        };
+
+        enum
+        {
+            MAX_WINDOW = 31,
+            MAX_REFRESH_RATES = 4,
+            MAX_MULTIPLE = 4, ///< VSYNC snaps to 1 .. MAX_MULTIPLE refresh periods
+        };
+
+        dt_filter_t();
+
+        void setMode(EMode mode);
+        EMode getMode() const { return mMode; }
+
+        ///< Deltas above this are capped, 0 disables the cap
+        void setMaxDelta(tick_t max) { mMaxDelta = max; }
+        tick_t getMaxDelta() const { return mMaxDelta; }
+
+        ///< Weight of a new delta for EMA, in (0, 1]
+        void setEmaWeight(f64 weight);
+        ///< Number of deltas for MEDIAN, 1 .. MAX_WINDOW
+        void setMedianWindow(u32 window);
+        ///< The refresh rates VSYNC snaps to and the tolerance as a fraction of the period
+        void setRefreshRate(f64 hz, f64 tolerance = 0.1) { setRefreshRates(&hz, 1, tolerance); }
+        void setRefreshRates(const f64 *hz, u32 count, f64 tolerance = 0.1);
+
+        void attach(framerate_t *framerate) { mFrameRate = framerate; }
+
+        ///< Forgets the history, the next markFrame() starts a new first frame
+        void reset();
+
+        ///< Filter a raw delta, returns the filtered delta
+        tick_t filter(tick_t raw);
+
+        ///< Filter the time since the previous mark, the first call returns 0
+        tick_t markFrame() { return markFrame(x_GetTime()); }
+        tick_t markFrame(tick_t now);
+
+        tick_t getDelta() const { return mDelta; }
+        f64 getDeltaSec() const { return x_TicksToSec(mDelta); }
+        tick_t getRawDelta() const { return mRawDelta; }
+        u64 getNumCapped() const { return mNumCapped; }
+
+    private:
+        tick_t snap(tick_t delta);
+        tick_t median(tick_t delta);
+
+        EMode mMode;
+        tick_t mMaxDelta;
+        framerate_t *mFrameRate;
+
+        tick_t mDelta;
+        tick_t mRawDelta;
+        tick_t mLastMark;
+        bool mMarked;
+        u64 mNumCapped;
+
+        f64 mEmaWeight;
+        f64 mEma;
+        bool mEmaValid;
+
+        u32 mWindow;
+        u32 mCount;
+        u32 mHead;
+        tick_t mHistory[MAX_WINDOW];
+        tick_t mSorted[MAX_WINDOW];
+
+        u32 mNumPeriods;
+        tick_t mPeriods[MAX_REFRESH_RATES];
+        f64 mTolerance;
+        tick_t mResidual;
+    };
+
+}; // namespace xcore
+
+#endif
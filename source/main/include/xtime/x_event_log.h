@@ -0,0 +1,117 @@
+#ifndef __X_TIME_EVENT_LOG_H__
+#define __X_TIME_EVENT_LOG_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A raw event log for the lowest overhead instrumentation.
+     *
+     *      x_EventLogWrite() stores the raw x_GetTime() ticks, an event id and a u64
+     *      payload into a ring buffer that belongs to the calling thread, nothing is
+     *      converted or aggregated. The ring buffers are cache-line aligned and are
+     *      carved out of one arena that is allocated by x_EventLogOpen(), when the
+     *      arena is used up or a ring buffer is full events are dropped (counted).
+     *
+     *      A background thread drains the ring buffers into a binary file. The file
+     *      starts with the clock metadata (ticks per second and a tick/datetime pair
+     *      taken at open), the event_log_reader_t uses this to convert ticks offline.
+     *
+     *  Example:
+     * <CODE>
+     *       x_EventLogOpen(allocator, "events.bin", 64 * 1024);
+     *       ...
+     *       x_EventLogWrite(EVENT_PACKET_RECEIVED, packet_size);
+     *       ...
+     *       x_EventLogClose();
+     *
+     *       event_log_reader_t reader;
+     *       reader.open("events.bin", allocator);
+     *       event_record_t record;
+     *       while (reader.read(record))
+     *           x_printf("%f: %u %u", reader.toSeconds(record.mTime), record.mId, record.mPayload);
+     *       reader.close();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    struct event_record_t
+    {
+        tick_t mTime;
+        u64 mPayload;
+        u32 mId;
+        u32 mThread;
+    };
+
+    ///< 'events_per_thread' is rounded up to a power of two, the arena has room for 'max_threads' buffers
+    extern bool x_EventLogOpen(alloc_t *allocator, const char *filename, u32 events_per_thread, u32 max_threads = 64, u32 flush_interval_ms = 10);
+    extern bool x_EventLogClose();
+    extern bool x_EventLogIsOpen();
+
+    extern bool x_EventLogWrite(u32 id, u64 payload);
+    extern void x_EventLogSetThreadName(const char *name);
+
+    extern u64 x_EventLogGetNumWritten();
+    extern u64 x_EventLogGetNumDropped();
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Reads a file that was written by the event log. Records are returned per
+     *      block, the records of one thread are in time order but records of different
+     *      threads are interleaved in the order in which they were flushed.
+     * ------------------------------------------------------------------------------
+     */
+    class event_log_reader_t
+    {
+    public:
+        event_log_reader_t();
+        ~event_log_reader_t();
+
+        bool open(const char *filename, alloc_t *allocator);
+        void close();
+
+        bool read(event_record_t &record);
+
+        s64 getTicksPerSecond() const { return mTicksPerSecond; }
+        tick_t getStartTicks() const { return mStartTicks; }
+        datetime_t getStartTime() const { return datetime_t(mStartTime); }
+
+        const char *getThreadName(u32 thread) const;
+
+        ///@name Conversion of ticks relative to the start of the log
+        f64 toSeconds(tick_t ticks) const;
+        s64 toMicroseconds(tick_t ticks) const;
+        datetime_t toDateTime(tick_t ticks) const;
+
+    private:
+        bool readBlock();
+        void setThreadName(u32 thread, const char *name);
+
+        enum
+        {
+            NAME_LENGTH = 32
+        };
+
+        void *mFile;
+        alloc_t *mAllocator;
+        s64 mTicksPerSecond;
+        tick_t mStartTicks;
+        u64 mStartTime;
+        u32 mRemaining;
+        char *mNames;
+        u32 mMaxNames;
+    };
+
+}; // namespace xcore
+
+#endif
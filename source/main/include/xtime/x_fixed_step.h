@@ -0,0 +1,89 @@
+#ifndef __X_TIME_FIXED_STEP_H__
+#define __X_TIME_FIXED_STEP_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      The accumulator of a fixed timestep loop. The elapsed real time is added
+     *      to an accumulator and update() returns how many fixed steps should be run
+     *      to catch up. What is left in the accumulator is less than one step, the
+     *      alpha (0 <= alpha < 1) is that remainder as a fraction of a step and can
+     *      be used to interpolate between the last two simulated states.
+     *
+     *      The step is kept as a fraction of ticks (numerator / denominator) and all
+     *      bookkeeping is done in integer ticks. A 60 Hz step on a 1 GHz clock is
+     *      16666666.67 ticks, after any number of steps the simulated time is exact.
+     *
+     *      When more than the maximum number of steps is due (the simulation can not
+     *      keep up, the spiral of death) only the maximum is returned and the extra
+     *      whole steps are dropped and counted, the fraction of a step is kept.
+     *
+     *  Example:
+     * <CODE>
+     *       fixed_step_t fixed;
+     *       fixed.setStepRate(60);
+     *       fixed.restart();
+     *
+     *       while (game_loop)
+     *       {
+     *           for (u32 n = fixed.update(); n > 0; --n)
+     *               simulate(fixed.getStepSec());
+     *           render(fixed.getAlpha());
+     *       }
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class fixed_step_t
+    {
+    public:
+        fixed_step_t();
+
+        ///< Steps per second, the step is exactly x_GetTicksPerSecond() / rate ticks
+        void setStepRate(u32 rate);
+        void setStep(tick_t ticks);
+        tick_t getStep() const { return mStepNum / mStepDen; }
+        f64 getStepSec() const;
+
+        void setMaxSteps(u32 max_steps) { mMaxSteps = max_steps > 0 ? max_steps : 1; }
+        u32 getMaxSteps() const { return mMaxSteps; }
+
+        ///< Empties the accumulator, the next update() measures from now
+        void restart() { restart(x_GetTime()); }
+        void restart(tick_t now);
+
+        ///< Returns the number of steps to run for the time elapsed since the previous update
+        u32 update() { return update(x_GetTime()); }
+        u32 update(tick_t now);
+        ///< Returns the number of steps to run for 'elapsed' ticks
+        u32 advance(tick_t elapsed);
+
+        ///< The accumulated time that is not a whole step yet, in ticks
+        tick_t getAccumulator() const { return (tick_t)(mAccumulator / mStepDen); }
+        f64 getAlpha() const { return (f64)mAccumulator / (f64)mStepNum; }
+
+        ///@name Totals since restart
+        u64 getNumSteps() const { return mNumSteps; }
+        u64 getNumDropped() const { return mNumDropped; }
+        tick_t getTime() const; ///< Simulated time, getNumSteps() steps
+
+    private:
+        s64 mStepNum;     ///< A step is mStepNum / mStepDen ticks
+        s64 mStepDen;
+        s64 mAccumulator; ///< In 1 / mStepDen ticks
+        u32 mMaxSteps;
+        tick_t mLastTime;
+        u64 mNumSteps;
+        u64 mNumDropped;
+    };
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef __X_TIME_FRAME_PACER_H__
+#define __X_TIME_FRAME_PACER_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_running_stats.h"
+
+namespace xcore
+{
+    class framerate_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      The frame_pacer_t holds a loop at a target frame rate. waitForNextFrame()
+     *      sleeps (see x_SleepUntil) until the next frame boundary.
+     *
+     *      Frame boundaries are on an absolute schedule (start + N * period), so small
+     *      errors in waking up do not accumulate. When a frame overruns one or more
+     *      boundaries these are counted as missed and the schedule skips ahead to the
+     *      next boundary in the future, keeping its phase.
+     *
+     *      The jitter is the time between a frame boundary and the moment the pacer
+     *      returned to the caller.
+     *
+     *  Example:
+     * <CODE>
+     *       framerate_t fps;
+     *       frame_pacer_t pacer;
+     *       pacer.setTargetRate(60.0);
+     *       pacer.attach(&fps);
+     *       pacer.restart();
+     *
+     *       while (game_loop)
+     *       {
+     *           update_and_render();
+     *           pacer.waitForNextFrame();
+     *       }
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class frame_pacer_t
+    {
+    public:
+        frame_pacer_t();
+
+        void setTargetRate(f64 fps);
+        void setTargetPeriod(tick_t period);
+        tick_t getTargetPeriod() const { return mPeriod; }
+        f64 getTargetRate() const;
+
+        void attach(framerate_t *framerate) { mFrameRate = framerate; }
+
+        void restart();
+        tick_t waitForNextFrame();
+
+        tick_t getNextDeadline() const { return mNextDeadline; }
+
+        ///@name Statistics
+        u64 getNumFrames() const { return mNumFrames; }
+        u64 getNumMissed() const { return mNumMissed; }
+        const running_stats_t &getJitter() const { return mJitter; } ///< In microseconds
+        void resetStats();
+
+    private:
+        tick_t mPeriod;
+        tick_t mNextDeadline;
+        framerate_t *mFrameRate;
+
+        u64 mNumFrames;
+        u64 mNumMissed;
+        running_stats_t mJitter;
+    };
+
+}; // namespace xcore
+
+#endif
@@ -57,6 +57,7 @@ namespace xcore
 		void		restart				();
 
 		void		markFrame			();
+		void		markFrame			(tick_t now);								///< With a time from x_GetTime() that the caller already read
 		bool		getFrameRate		(f32& fps) const;							///< Return true when the frame-rate is up-to-date
 
 	private:
@@ -0,0 +1,119 @@
+#ifndef __X_TIME_FRAME_STATS_H__
+#define __X_TIME_FRAME_STATS_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A summary of the frame times in the window of a frame_stats_t, all times are
+     *      in milliseconds. The lows are the average frame time of the slowest 1% and
+     *      0.1% of the frames, the corresponding frame rates are 1000 / low.
+     * ------------------------------------------------------------------------------
+     */
+    struct frame_stats_summary_t
+    {
+        u32 mNumFrames;
+        f64 mMinMs;
+        f64 mMaxMs;
+        f64 mMeanMs;
+        f64 mStdDevMs;
+        f64 mP50Ms;
+        f64 mP95Ms;
+        f64 mP99Ms;
+        f64 mLow1Ms;
+        f64 mLow01Ms;
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      The frame_stats_t keeps the durations of the last 'capacity' frames in a ring
+     *      buffer and reports statistics over a window of the most recent frames, the
+     *      window can be changed at any time as long as it fits in the capacity.
+     *
+     *      Adding a frame is O(1): the frame that leaves the window is subtracted from
+     *      the running sums, the histogram and the min/max queues. Frame times are kept
+     *      in microseconds in a log-linear histogram with a relative precision of about
+     *      1.5%, percentiles are found by scanning 27 group counts and at most 64 bins.
+     *      The minimum and maximum are exact.
+     *
+     *  Example:
+     * <CODE>
+     *       frame_stats_t stats;
+     *       stats.init(allocator, 1024);
+     *       stats.setWindow(300);
+     *       while (game_loop)
+     *       {
+     *           stats.markFrame();
+     *           frame_stats_summary_t s;
+     *           stats.getSummary(s);
+     *           draw_overlay(s.mMeanMs, s.mP99Ms, s.mLow1Ms);
+     *       }
+     *       stats.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class frame_stats_t
+    {
+    public:
+        frame_stats_t();
+        ~frame_stats_t();
+
+        void init(alloc_t *allocator, u32 capacity);
+        void exit();
+
+        void reset();
+        void setWindow(u32 frames);
+        u32 getWindow() const { return mWindow; }
+        u32 getCapacity() const { return mCapacity; }
+
+        void addFrame(tick_t duration);
+        void markFrame();
+
+        u32 getNumFrames() const { return mCount; }
+        f64 getMinMs() const;
+        f64 getMaxMs() const;
+        f64 getMeanMs() const;
+        f64 getStdDevMs() const;
+        f64 getPercentileMs(f64 percentile) const;
+        f64 getLowMs(f64 percent) const;
+        f64 getLowFps(f64 percent) const;
+
+        void getSummary(frame_stats_summary_t &summary) const;
+
+    private:
+        u32 at(u64 seq) const { return mFrames[seq & mMask]; }
+        void insert(u64 seq);
+        void remove(u64 seq);
+
+        alloc_t *mAllocator;
+        u32 *mFrames;    ///< Ring buffer of frame times in microseconds
+        u64 *mMinQueue;  ///< Monotonic queue of frame sequence numbers (increasing frame times)
+        u64 *mMaxQueue;  ///< Monotonic queue of frame sequence numbers (decreasing frame times)
+        u32 *mBins;      ///< Histogram
+        u32 *mGroups;    ///< Sum of every 64 histogram bins
+        u32 mCapacity;
+        u32 mMask;
+        u32 mWindow;
+        u32 mCount;
+        u64 mNextSeq;
+        u64 mMinHead, mMinTail;
+        u64 mMaxHead, mMaxTail;
+        u64 mSum;
+        u64 mSumSq;
+        tick_t mLastMark;
+        bool mMarked;
+    };
+
+}; // namespace xcore
+
+#endif
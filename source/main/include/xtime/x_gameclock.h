@@ -0,0 +1,114 @@
+#ifndef __X_TIME_GAMECLOCK_H__
+#define __X_TIME_GAMECLOCK_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A hierarchy of clocks that can be paused, slowed down or sped up, for
+     *      example a clock per world with a clock per entity below it.
+     *
+     *      A root clock follows x_GetTime(), a child clock follows its parent. Every
+     *      clock has a scale and a pause state relative to its parent. The local time
+     *      of a clock starts at 0 when it is initialized and is in the same unit as
+     *      x_GetTicksPerSecond().
+     *
+     *      Each clock caches the affine transform from x_GetTime() to its local time,
+     *          local = base + (real - anchor) * rate
+     *      where rate is the product of the scales on the path to the root (0 when any
+     *      of them is paused). now() is O(1) no matter how deep the clock is. When a
+     *      clock is paused, resumed or scaled the transforms of it and of the clocks
+     *      below it are re-anchored at the current time, so the local time of every
+     *      clock stays continuous and the cost is O(subtree) per change.
+     *
+     *      The clocks are not thread-safe, the hierarchy should be updated by one
+     *      thread. now() can be called from other threads while nothing changes.
+     *
+     *  Example:
+     * <CODE>
+     *       gameclock_t world, entity;
+     *       world.init();
+     *       entity.init(&world);
+     *
+     *       world.setScale(0.5);    // slow motion
+     *       entity.pause();
+     *       ...
+     *       tick_t const dt = world.trip();
+     *
+     *       entity.exit();
+     *       world.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class gameclock_t
+    {
+    public:
+        gameclock_t();
+        ~gameclock_t();
+
+        ///< A NULL parent makes this a root clock that follows x_GetTime()
+        void init(gameclock_t *parent = NULL);
+        ///< The children must have been exited before
+        void exit();
+
+        tick_t now() const { return now(x_GetTime()); }
+        tick_t now(tick_t real) const;
+        f64 nowSec() const { return x_TicksToSec(now()); }
+        f64 nowMs() const { return x_TicksToMs(now()); }
+
+        ///< Local time elapsed since the previous trip() (or since init)
+        tick_t trip();
+        f64 tripSec() { return x_TicksToSec(trip()); }
+        f64 tripMs() { return x_TicksToMs(trip()); }
+
+        ///< Sets the local time, the local time of the children continues unchanged
+        void set(tick_t local);
+
+        void setScale(f64 scale);
+        f64 getScale() const { return mScale; }
+        ///< The rate relative to x_GetTime(), 0 when this clock or a parent is paused
+        f64 getRate() const { return mRate; }
+
+        void pause();
+        void resume();
+        bool isPaused() const { return mPaused; }
+        ///< True when this clock or one of its parents is paused
+        bool isStopped() const { return mRate == 0.0; }
+
+        gameclock_t *getParent() const { return mParent; }
+        gameclock_t *getFirstChild() const { return mFirstChild; }
+        gameclock_t *getNextSibling() const { return mNextSibling; }
+
+    private:
+        void rebase(tick_t real);
+        void update(tick_t real);
+
+        gameclock_t *mParent;
+        gameclock_t *mFirstChild;
+        gameclock_t *mNextSibling;
+        tick_t mBase;
+        tick_t mAnchor;
+        f64 mRate;
+        f64 mScale;
+        bool mPaused;
+        bool mInitialized;
+        tick_t mLastTrip;
+
+        gameclock_t(const gameclock_t &);
+        gameclock_t &operator=(const gameclock_t &);
+    };
+
+#include "private/x_gameclock_inline.h"
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __X_TIME_LATENCY_HISTOGRAM_H__
+#define __X_TIME_LATENCY_HISTOGRAM_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A log-linear (HDR style) histogram of tick_t latencies with a fixed amount
+     *      of memory. Every power of two is split into 2^precision_bits buckets, so
+     *      the relative error of a recorded value is at most 1 / 2^precision_bits
+     *      (precision_bits = 7 gives better than 1%). Values up to 2^(precision_bits+1)
+     *      are recorded exactly, values above 'max_value' are clamped and counted as
+     *      overflow.
+     *
+     *      record() is O(1) and lock-free: a histogram has a single writer (usually one
+     *      histogram per thread) that updates its counters with relaxed atomic stores,
+     *      other threads may take a snapshot() at any time and merge() snapshots of
+     *      many threads into one. A snapshot taken while recording may be off by the
+     *      few values that were recorded during the copy.
+     *
+     *  Example:
+     * <CODE>
+     *       latency_histogram_t histogram;
+     *       histogram.init(allocator, 7, x_SecondsToTicks(10.0));
+     *
+     *       timer_t timer;
+     *       timer.start();
+     *       while (serving)
+     *       {
+     *           handle_request();
+     *           histogram.record(timer.trip());
+     *       }
+     *
+     *       f64 p999 = x_TicksToUs(histogram.getValueAtPercentile(99.9));
+     *       histogram.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class latency_histogram_t
+    {
+    public:
+        latency_histogram_t();
+        ~latency_histogram_t();
+
+        void init(alloc_t *allocator, u32 precision_bits, tick_t max_value);
+        void exit();
+
+        void reset();
+        void record(tick_t value);
+        void recordValues(tick_t value, u64 count);
+
+        void snapshot(latency_histogram_t &out) const;
+        void merge(const latency_histogram_t &other);
+
+        u32 getPrecisionBits() const { return mPrecisionBits; }
+        tick_t getMaxTrackableValue() const { return mMaxValue; }
+        u32 getNumBuckets() const { return mNumBuckets; }
+
+        u64 getTotalCount() const;
+        u64 getOverflowCount() const;
+        tick_t getMin() const;
+        tick_t getMax() const;
+        f64 getMean() const;
+        tick_t getValueAtPercentile(f64 percentile) const;
+
+        u32 getBucketIndex(tick_t value) const;
+        tick_t getBucketLowest(u32 index) const;
+        tick_t getBucketHighest(u32 index) const;
+        u64 getBucketCount(u32 index) const;
+
+    private:
+        struct counters_t;
+
+        alloc_t *mAllocator;
+        counters_t *mCounters;
+        u32 mPrecisionBits;
+        u32 mNumBuckets;
+        tick_t mMaxValue;
+
+        latency_histogram_t(const latency_histogram_t &);
+        latency_histogram_t &operator=(const latency_histogram_t &);
+    };
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef __X_TIME_PACKED_TICKS_H__
+#define __X_TIME_PACKED_TICKS_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A compressed column of timestamps (tick_t or datetime_t ticks) with random
+     *      access, stored as blocks of 128 values in frame of reference encoding:
+     *      every block keeps its minimum and maximum, the values are stored as the
+     *      offset to the minimum with just enough bits for the largest offset.
+     *      Sorted timestamps with a regular spacing need few bits, e.g. 128 samples
+     *      of 1 ms in 100 ns ticks need 21 bits per value.
+     *
+     *      Offsets of up to 32 bits are packed in 4 interleaved lanes, value i is in
+     *      lane i % 4, so one SIMD register unpacks 4 consecutive values (SSE2 on
+     *      x86, a scalar loop elsewhere). Blocks with a wider range store 64 bit
+     *      offsets unpacked.
+     *
+     *      count() and select() skip blocks that are entirely outside of the range
+     *      and count blocks that are entirely inside without unpacking them, the
+     *      values do not need to be sorted but sorted columns skip the most.
+     *
+     *      The last, partial block is kept unpacked until it is full.
+     *
+     *  Example:
+     * <CODE>
+     *       packed_ticks_t column;
+     *       column.init(allocator);
+     *       column.append(ticks, num_ticks);
+     *
+     *       tick_t t = column.get(1000);
+     *       u64 n = column.count(from, until);
+     *       column.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class packed_ticks_t
+    {
+    public:
+        enum
+        {
+            BLOCK_SIZE = 128,
+        };
+
+        packed_ticks_t();
+        ~packed_ticks_t();
+
+        void init(alloc_t *allocator, u32 initial_blocks = 16);
+        void exit();
+        void clear();
+
+        void append(tick_t value);
+        void append(const datetime_t &value) { append((tick_t)value.ticks()); }
+        void append(const tick_t *values, u32 count);
+
+        u32 getNumValues() const { return mNumBlocks * BLOCK_SIZE + mNumPending; }
+        u32 getNumBytes() const; ///< Size of the encoded data, including the block headers
+
+        tick_t get(u32 index) const;
+
+        ///@name Blocks, the partial block (if any) is the last one
+        u32 getNumBlocks() const { return mNumBlocks + (mNumPending > 0 ? 1 : 0); }
+        u32 getBlockSize(u32 block) const { return block < mNumBlocks ? (u32)BLOCK_SIZE : mNumPending; }
+        tick_t getBlockMin(u32 block) const { return block < mNumBlocks ? mBlocks[block].mMin : mPendingMin; }
+        tick_t getBlockMax(u32 block) const { return block < mNumBlocks ? mBlocks[block].mMax : mPendingMax; }
+        u32 getBlockBits(u32 block) const { return block < mNumBlocks ? mBlocks[block].mBits : 64; }
+
+        ///< Unpacks a block into 'out' (room for BLOCK_SIZE values), returns the number of values
+        u32 decode(u32 block, tick_t *out) const;
+
+        ///@name Range predicates, values in [from, until)
+        u64 count(tick_t from, tick_t until) const;
+        ///< Writes the indices of at most 'max_count' matching values, from 'first_index' on, returns the number written
+        u32 select(tick_t from, tick_t until, u32 first_index, u32 *out_indices, u32 max_count) const;
+
+    private:
+        struct block_t
+        {
+            tick_t mMin;
+            tick_t mMax;
+            u32 mOffset; ///< In u32 words into mData
+            u32 mBits;   ///< 0 to 32, or 64
+        };
+
+        void flush();
+
+        alloc_t *mAllocator;
+        block_t *mBlocks;
+        u32 mNumBlocks;
+        u32 mMaxBlocks;
+        u32 *mData;
+        u32 mDataSize;
+        u32 mDataCapacity;
+        tick_t *mPending;
+        u32 mNumPending;
+        tick_t mPendingMin;
+        tick_t mPendingMax;
+    };
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef __X_TIME_PROFILE_H__
+#define __X_TIME_PROFILE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Scoped profiling zones.
+     *
+     *      X_PROFILE_ZONE("name") records a begin and end event with x_GetTime() ticks
+     *      and a static zone id into a ring buffer that belongs to the calling thread.
+     *      The ring buffer is a single-producer/single-consumer queue, the thread that
+     *      owns it never waits. When a buffer is full new zones are dropped (counted)
+     *      instead of blocking, the end event of a recorded zone always fits.
+     *
+     *      x_ProfileFlush() drains the buffers of all threads into a profile_sink_t,
+     *      the profile_aggregator_t is a sink that builds a call tree with inclusive
+     *      and exclusive times per zone.
+     *
+     *      The macros only record when X_TIME_PROFILE is defined, otherwise they
+     *      compile to nothing.
+     *
+     *  Example:
+     * <CODE>
+     *       x_ProfileInit(allocator, 64 * 1024);
+     *
+     *       void update()
+     *       {
+     *           X_PROFILE_ZONE("update");
+     *           ...
+     *       }
+     *
+     *       profile_aggregator_t aggregator;
+     *       aggregator.init(allocator);
+     *       x_ProfileFlush(&aggregator);
+     *       aggregator.exit();
+     *       x_ProfileExit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class profile_zone_t
+    {
+    public:
+        profile_zone_t(const char *name, const char *file, s32 line);
+
+        const char *mName;
+        const char *mFile;
+        s32 mLine;
+        u32 mId;
+    };
+
+    struct profile_event_t
+    {
+        enum EKind
+        {
+            BEGIN = 0,
+            END = 1,
+        };
+
+        tick_t mTime;
+        u32 mZone;
+        u32 mKind;
+    };
+
+    class profile_sink_t
+    {
+    public:
+        virtual ~profile_sink_t() {}
+
+        ///< Called with consecutive events of one thread, 'thread' is the index the thread was registered with
+        virtual void onProfileEvents(u32 thread, const profile_event_t *events, u32 count) = 0;
+    };
+
+    extern void x_ProfileInit(alloc_t *allocator, u32 events_per_thread);
+    extern void x_ProfileExit();
+
+    extern bool x_ProfileBegin(u32 zone);
+    extern void x_ProfileEnd(u32 zone);
+
+    extern void x_ProfileSetThreadName(const char *name);
+    extern u32 x_ProfileGetNumThreads();
+    extern bool x_ProfileGetThreadName(u32 thread, char *name, u32 size);
+    extern u64 x_ProfileGetNumDropped(u32 thread);
+
+    extern u32 x_ProfileGetNumZones();
+    extern const profile_zone_t *x_ProfileGetZone(u32 zone);
+
+    extern void x_ProfileFlush(profile_sink_t *sink);
+
+    class profile_scope_t
+    {
+    public:
+        inline profile_scope_t(const profile_zone_t &zone) : mZone(zone.mId) { mRecorded = x_ProfileBegin(mZone); }
+        inline ~profile_scope_t()
+        {
+            if (mRecorded)
+                x_ProfileEnd(mZone);
+        }
+
+    private:
+        u32 mZone;
+        bool mRecorded;
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A profile_sink_t that builds a call tree from the zone events of all threads.
+     *      Zones with the same call path (from the root) on different threads share a
+     *      node. Node 0 is the root, it does not represent a zone.
+     *      The inclusive time of a node is the time spent in the zone, the exclusive time
+     *      excludes the time spent in child zones.
+     * ------------------------------------------------------------------------------
+     */
+    struct profile_node_t
+    {
+        u32 mZone;
+        u32 mParent;
+        u32 mFirstChild;
+        u32 mNextSibling;
+        u32 mDepth;
+        u64 mCalls;
+        tick_t mInclusive;
+        tick_t mExclusive;
+    };
+
+    class profile_aggregator_t : public profile_sink_t
+    {
+    public:
+        enum
+        {
+            NONE = 0xffffffff,
+            MAX_DEPTH = 64,
+        };
+
+        profile_aggregator_t();
+        ~profile_aggregator_t();
+
+        void init(alloc_t *allocator);
+        void exit();
+        void reset();
+
+        virtual void onProfileEvents(u32 thread, const profile_event_t *events, u32 count);
+
+        u32 getNumNodes() const { return mNumNodes; }
+        const profile_node_t &getNode(u32 index) const { return mNodes[index]; }
+
+        ///@name Totals per zone over all call paths
+        u64 getZoneCalls(u32 zone) const;
+        tick_t getZoneInclusive(u32 zone) const;
+        tick_t getZoneExclusive(u32 zone) const;
+
+        ///< Zones that were nested deeper than MAX_DEPTH and are not in the tree
+        u64 getNumDropped() const { return mNumDropped; }
+
+    private:
+        struct frame_t
+        {
+            u32 mNode;
+            tick_t mBegin;
+            tick_t mChildren;
+        };
+
+        struct thread_t
+        {
+            u32 mDepth;
+            u32 mOverflow; ///< Open zones beyond MAX_DEPTH
+            frame_t mStack[MAX_DEPTH];
+        };
+
+        u32 child(u32 parent, u32 zone);
+        thread_t *thread(u32 index);
+
+        alloc_t *mAllocator;
+        profile_node_t *mNodes;
+        u32 mNumNodes;
+        u32 mMaxNodes;
+        thread_t **mThreads;
+        u32 mMaxThreads;
+        u64 mNumDropped;
+    };
+
+}; // namespace xcore
+
+#define X_PROFILE_CONCAT_(a, b) a##b
+#define X_PROFILE_CONCAT(a, b) X_PROFILE_CONCAT_(a, b)
+
+#ifdef X_TIME_PROFILE
+#define X_PROFILE_ZONE(name)                                                                               \
+    static xcore::profile_zone_t X_PROFILE_CONCAT(sProfileZone, __LINE__)(name, __FILE__, __LINE__); \
+    xcore::profile_scope_t X_PROFILE_CONCAT(sProfileScope, __LINE__)(X_PROFILE_CONCAT(sProfileZone, __LINE__))
+#define X_PROFILE_THREAD(name) xcore::x_ProfileSetThreadName(name)
+#else
+#define X_PROFILE_ZONE(name)
+#define X_PROFILE_THREAD(name)
+#endif
+
+#endif
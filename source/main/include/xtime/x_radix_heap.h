@@ -0,0 +1,105 @@
+#ifndef __X_TIME_RADIX_HEAP_H__
+#define __X_TIME_RADIX_HEAP_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xbase/x_allocator.h"
+#include "xbase/x_debug.h"
+
+#include "xtime/x_time.h"
+#include "xtime/private/x_time_bits.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A radix heap is a monotone priority queue, it only accepts keys that are
+     *      greater or equal to the key that was popped last. This is exactly the case
+     *      for a discrete-event simulation that processes events in time order, the key
+     *      is a tick_t from x_GetTime() or the ticks of a datetime_t.
+     *
+     *      Entries are placed in one of 65 buckets based on the highest bit in which
+     *      their key differs from the last popped key. Push is O(1), pop is amortized
+     *      O(1) since every entry can only move to a lower bucket a limited number of
+     *      times. The payload is stored inline next to the key, it is copied with
+     *      the assignment operator so it should be a small, plain type.
+     *
+     *  Example:
+     * <CODE>
+     *       radix_heap_t<event_t> queue;
+     *       queue.init(allocator);
+     *       queue.push(x_GetTime(), event);
+     *
+     *       tick_t when;
+     *       while (queue.pop(when, event))
+     *           simulate(when, event);
+     *       queue.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    template <typename T>
+    class radix_heap_t
+    {
+    public:
+        radix_heap_t();
+        ~radix_heap_t();
+
+        void init(alloc_t *allocator, u32 initial_bucket_capacity = 16);
+        void exit();
+
+        void clear();
+
+        void push(u64 key, const T &value);
+        bool pop(u64 &key, T &value);
+        bool pop(tick_t &key, T &value);
+        bool top(u64 &key) const;
+        ///< Removes an entry with this payload, a linear search over all entries
+        bool remove(const T &value);
+
+        u32 size() const { return mSize; }
+        bool empty() const { return mSize == 0; }
+        u64 lastKey() const { return mLastKey; }
+
+    private:
+        enum
+        {
+            NUM_BUCKETS = 65
+        };
+
+        struct entry_t
+        {
+            u64 mKey;
+            T mValue;
+        };
+
+        struct bucket_t
+        {
+            entry_t *mEntries;
+            u32 mSize;
+            u32 mCapacity;
+            u64 mMinKey;
+        };
+
+        s32 bucketIndex(u64 key) const;
+        void append(s32 bucket, u64 key, const T &value);
+        void grow(bucket_t &bucket);
+
+        alloc_t *mAllocator;
+        u32 mInitialCapacity;
+        u32 mSize;
+        u64 mLastKey;
+        u64 mOccupied; ///< Bit (i-1) is set when bucket i (1..64) is not empty
+        bucket_t mBuckets[NUM_BUCKETS];
+
+        radix_heap_t(const radix_heap_t &);
+        radix_heap_t &operator=(const radix_heap_t &);
+    };
+
+#include "private/x_radix_heap_inline.h"
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef __X_TIME_RECORD_FILE_H__
+#define __X_TIME_RECORD_FILE_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/private/x_mapped_file.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A view on consecutive records of a record_file_t, directly in the mapped
+     *      file. It stays valid until the file is closed or grows.
+     * ------------------------------------------------------------------------------
+     */
+    class record_range_t
+    {
+    public:
+        record_range_t()
+            : mBase(NULL), mFirst(0), mCount(0), mStride(0)
+        {
+        }
+
+        record_range_t(const u8 *base, u64 first, u64 count, u32 stride)
+            : mBase(base), mFirst(first), mCount(count), mStride(stride)
+        {
+        }
+
+        bool isEmpty() const { return mCount == 0; }
+        u64 getFirst() const { return mFirst; } ///< Index of the first record in the file
+        u64 getNumRecords() const { return mCount; }
+
+        datetime_t getKey(u64 i) const { return datetime_t(*(const u64 *)(mBase + i * mStride)); }
+        const void *getRecord(u64 i) const { return mBase + i * mStride + sizeof(u64); }
+
+    private:
+        const u8 *mBase;
+        u64 mFirst;
+        u64 mCount;
+        u32 mStride;
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      An append-only file of fixed size records keyed by a datetime_t, mapped
+     *      into memory. Keys must not decrease, so a range of time is a range of
+     *      records that is found with a binary search and read in place.
+     *
+     *      A sparse index holds the key of the first record of every block (256
+     *      records by default), it is built when the file is opened by reading one
+     *      key per block. A lookup searches the index and then a single block.
+     *
+     *      Appended records are not part of the file until commit(): the records are
+     *      flushed to disk first and then the record count in the file header. After
+     *      a crash the file opens with the records of the last commit, a partially
+     *      written tail is ignored and overwritten by the next append. The file is
+     *      grown in large steps and truncated to the committed records on close().
+     *
+     *      A file can be opened by one writer and any number of readers, a reader
+     *      sees the records committed at open() and picks up newer ones with
+     *      refresh(). Keys and the header are stored in native byte order.
+     *
+     *  Example:
+     * <CODE>
+     *       record_file_t file;
+     *       file.open("ticks.rec", allocator, sizeof(quote_t));
+     *       file.append(datetime_t::sNow(), &quote);
+     *       file.commit();
+     *       file.close();
+     *
+     *       file.openReadOnly("ticks.rec", allocator);
+     *       record_range_t range = file.find(from, until);
+     *       for (u64 i = 0; i < range.getNumRecords(); ++i)
+     *           process(range.getKey(i), (const quote_t *)range.getRecord(i));
+     *       file.close();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class record_file_t
+    {
+    public:
+        enum
+        {
+            DEFAULT_BLOCK_SIZE = 256,
+        };
+
+        record_file_t();
+        ~record_file_t();
+
+        ///< Opens a file for appending, creates it when it does not exist. An existing file must have the same record size.
+        bool open(const char *filename, alloc_t *allocator, u32 record_size, u32 block_size = DEFAULT_BLOCK_SIZE);
+        bool openReadOnly(const char *filename, alloc_t *allocator);
+        ///< Commits and closes the file, returns false when anything failed
+        bool close();
+
+        bool isOpen() const { return mFile.mFile != NULL; }
+        bool isWritable() const { return mFile.mWritable; }
+
+        u32 getRecordSize() const { return mRecordSize; }
+        u32 getBlockSize() const { return mBlockSize; }
+        u64 getNumRecords() const { return mNumRecords; }
+        u64 getNumCommitted() const { return mNumCommitted; }
+
+        ///< Returns false when the file is read-only, the key is before the last key or the file can not grow
+        bool append(const datetime_t &key, const void *record);
+        ///< Makes all appended records durable
+        bool commit();
+        ///< Picks up records committed by a writer since the file was opened, for readers
+        bool refresh();
+
+        datetime_t getKey(u64 index) const;
+        const void *getRecord(u64 index) const;
+
+        ///< Index of the first record with a key not before 'key', getNumRecords() when there is none
+        u64 lowerBound(const datetime_t &key) const;
+        ///< The records with a key in [from, until)
+        record_range_t find(const datetime_t &from, const datetime_t &until) const;
+        record_range_t getRange(u64 first, u64 count) const;
+
+    private:
+        bool openFile(const char *filename, alloc_t *allocator, bool writable);
+        bool readHeader(u64 file_size);
+        void abandon();
+        bool remap(u64 size);
+        void extendIndex();
+        u8 *recordAt(u64 index) const;
+        u64 keyAt(u64 index) const { return *(const u64 *)recordAt(index); }
+
+        mapped_file_t mFile;
+        alloc_t *mAllocator;
+        u32 mRecordSize;
+        u32 mStride;
+        u32 mBlockSize;
+        u64 mNumRecords;
+        u64 mNumCommitted;
+        u64 mLastKey;
+        u64 *mIndex; ///< Key of the first record of every block
+        u64 mIndexSize;
+        u64 mIndexCapacity;
+        bool mError;
+    };
+
+}; // namespace xcore
+
+#endif
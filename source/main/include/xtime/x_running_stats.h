@@ -0,0 +1,46 @@
+#ifndef __X_TIME_RUNNING_STATS_H__
+#define __X_TIME_RUNNING_STATS_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Running mean, variance, minimum and maximum of a series of samples using
+     *      Welford's algorithm, every add() is O(1) and numerically stable.
+     *      Two running_stats_t can be merged (Chan et al.).
+     * ------------------------------------------------------------------------------
+     */
+    class running_stats_t
+    {
+    public:
+        running_stats_t();
+
+        void reset();
+        void add(f64 sample);
+        void merge(const running_stats_t &other);
+
+        u64 count() const { return mCount; }
+        f64 mean() const { return mMean; }
+        f64 variance() const;
+        f64 stddev() const;
+        f64 min() const { return mMin; }
+        f64 max() const { return mMax; }
+
+    private:
+        u64 mCount;
+        f64 mMean;
+        f64 mM2;
+        f64 mMin;
+        f64 mMax;
+    };
+
+#include "private/x_running_stats_inline.h"
+
+}; // namespace xcore
+
+#endif
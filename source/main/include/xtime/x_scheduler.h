@@ -0,0 +1,170 @@
+#ifndef __X_TIME_SCHEDULER_H__
+#define __X_TIME_SCHEDULER_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+#include <atomic>
+
+namespace xcore
+{
+    class alloc_t;
+    class scheduler_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A job that can be scheduled on the scheduler_t, either once or periodically.
+     *      A job is owned by the user and must stay alive until isIdle() returns true,
+     *      scheduler_t::cancel() returns when the scheduler has released the job. A job
+     *      can only be scheduled when it is idle.
+     *
+     *      cancel() on the job itself only sets a flag, it can be called from execute().
+     *      The scheduler drops the job when it becomes due, until then it is not idle.
+     *
+     *      FIXED_RATE jobs are scheduled relative to their previous deadline, so they
+     *      keep their cadence and catch up after running late. FIXED_DELAY jobs are
+     *      scheduled relative to the moment they finished executing.
+     *
+     *      The lateness statistics are relaxed atomics that are only written by the worker
+     *      that executes the job, they can be read at any time but the three values are
+     *      not a consistent snapshot while the job is active. Call resetStats() only
+     *      when the job is idle.
+     * ------------------------------------------------------------------------------
+     */
+    class job_t
+    {
+    public:
+        enum EMode
+        {
+            ONE_SHOT = 0,
+            FIXED_RATE = 1,
+            FIXED_DELAY = 2,
+        };
+
+        job_t();
+        virtual ~job_t() {}
+
+        virtual void execute(tick_t now) = 0;
+
+        void cancel() { mCancelled.store(true, std::memory_order_release); }
+        bool isCancelled() const { return mCancelled.load(std::memory_order_acquire); }
+        ///< True when the job is neither queued nor executing, it can be destroyed or scheduled again
+        bool isIdle() const { return mState.load(std::memory_order_acquire) == IDLE; }
+
+        EMode getMode() const { return mMode; }
+        tick_t getPeriod() const { return mPeriod; }
+        tick_t getDeadline() const { return mDeadline; }
+
+        ///@name Lateness statistics, lateness is the time between the deadline and the start of execution
+        u64 getNumRuns() const { return mNumRuns.load(std::memory_order_relaxed); }
+        tick_t getMaxLateness() const { return mMaxLateness.load(std::memory_order_relaxed); }
+        tick_t getTotalLateness() const { return mTotalLateness.load(std::memory_order_relaxed); }
+        f64 getAverageLatenessUs() const;
+        void resetStats();
+
+    private:
+        friend class scheduler_t;
+
+        enum EState
+        {
+            IDLE = 0,
+            QUEUED = 1,  ///< In the queue of worker mWorker
+            RUNNING = 2, ///< Being executed or scheduled
+        };
+
+        tick_t mDeadline;
+        tick_t mPeriod;
+        EMode mMode;
+        std::atomic<bool> mCancelled;
+        std::atomic<u32> mState;
+        std::atomic<u32> mWorker;
+
+        std::atomic<u64> mNumRuns;
+        std::atomic<tick_t> mMaxLateness;
+        std::atomic<tick_t> mTotalLateness;
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A deadline scheduler for one-shot and periodic jobs that runs on a number of
+     *      worker threads. Every worker owns a deadline queue (a radix_heap_t keyed on
+     *      x_GetTime() ticks). A worker first executes its own due jobs, when it has none
+     *      it steals due jobs from the queues of other workers that are busy.
+     *
+     *      The scheduler does not create threads, the user starts one thread per worker
+     *      and calls run(worker) on it, or calls runDue(worker) from an existing loop.
+     *      A worker in run() that has nothing due waits until the earliest deadline
+     *      of all the queues, scheduling a job or requestStop() wakes it up.
+     *
+     *  Example:
+     * <CODE>
+     *       scheduler_t scheduler;
+     *       scheduler.init(allocator, num_threads);
+     *       scheduler.schedulePeriodic(&job, x_GetTime(), x_MillisecondsToTicks(16.0), job_t::FIXED_RATE, 0);
+     *
+     *       // on thread 'i'
+     *       scheduler.run(i);
+     *
+     *       // on shutdown
+     *       scheduler.requestStop();
+     *       ... join threads ...
+     *       scheduler.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class scheduler_t
+    {
+    public:
+        scheduler_t();
+        ~scheduler_t();
+
+        void init(alloc_t *allocator, u32 num_workers);
+        void exit();
+
+        u32 getNumWorkers() const { return mNumWorkers; }
+
+        ///@name Return false when the job is not idle
+        bool scheduleAt(job_t *job, tick_t deadline, u32 worker);
+        bool scheduleIn(job_t *job, tick_t delay, u32 worker);
+        bool schedulePeriodic(job_t *job, tick_t first_deadline, tick_t period, job_t::EMode mode, u32 worker);
+
+        ///< Cancels the job and removes it from its queue, waits when it is executing. Not from the job's own execute().
+        void cancel(job_t *job);
+
+        u32 runDue(u32 worker);
+        void run(u32 worker);
+        void requestStop();
+        bool isStopRequested() const;
+
+        ///@name Per worker counters
+        u64 getNumExecuted(u32 worker) const;
+        u64 getNumStolen(u32 worker) const;
+
+    private:
+        struct worker_t;
+        struct state_t;
+
+        bool acquire(job_t *job);
+        void push(u32 worker, job_t *job);
+        job_t *popDue(worker_t &worker, tick_t now);
+        job_t *steal(u32 thief, tick_t now);
+        void execute(u32 worker, job_t *job, tick_t now);
+        tick_t getNextDeadline() const;
+        void waitForWork();
+
+        alloc_t *mAllocator;
+        state_t *mState;
+        u32 mNumWorkers;
+
+        scheduler_t(const scheduler_t &);
+        scheduler_t &operator=(const scheduler_t &);
+    };
+
+}; // namespace xcore
+
+#endif
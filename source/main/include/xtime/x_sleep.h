@@ -0,0 +1,57 @@
+#ifndef __X_TIME_SLEEP_H__
+#define __X_TIME_SLEEP_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class timespan_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Statistics of x_SleepUntil/x_SleepFor, all times are in tick_t.
+     *      The overshoot is the time between the requested wake-up time and the moment
+     *      the sleep function returned. The wake latency is how much later than requested
+     *      the kernel woke us up, the spin tail is derived from it.
+     * ------------------------------------------------------------------------------
+     */
+    struct sleep_stats_t
+    {
+        u64 mNumSleeps;         ///< Number of calls that had to wait
+        u64 mNumKernelSleeps;   ///< Number of calls that slept in the kernel before spinning
+        tick_t mTotalOvershoot;
+        tick_t mMaxOvershoot;
+        tick_t mWakeLatency;    ///< Running average of the kernel wake-up latency
+        tick_t mWakeDeviation;  ///< Running average of the deviation of the kernel wake-up latency
+        tick_t mSpinTail;       ///< The current spin tail
+
+        f64 getAverageOvershootUs() const { return mNumSleeps > 0 ? x_TicksToUs(mTotalOvershoot) / (f64)mNumSleeps : 0.0; }
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Summary:
+     *      Wait until x_GetTime() has reached 'inDeadline'.
+     *  Description:
+     *      Sleeps in the kernel for most of the interval and spins with a cpu pause
+     *      instruction for the remainder (the spin tail). The spin tail is calibrated
+     *      from the measured kernel wake-up latency, so it is just long enough to
+     *      absorb the latency of the kernel.
+     *      Note that this waits on x_GetTime(), so the time source must advance.
+     * ------------------------------------------------------------------------------
+     */
+    extern void x_SleepUntil(tick_t inDeadline);
+    extern void x_SleepFor(const timespan_t &inDuration);
+    extern void x_SleepForTicks(tick_t inTicks);
+
+    extern void x_GetSleepStats(sleep_stats_t &outStats);
+    extern void x_ResetSleepStats();
+
+}; // namespace xcore
+
+#endif
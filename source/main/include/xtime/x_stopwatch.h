@@ -0,0 +1,88 @@
+#ifndef __X_TIME_STOPWATCH_H__
+#define __X_TIME_STOPWATCH_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_running_stats.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A timer_t that remembers its laps. Every trip() ends a lap and adds it to
+     *      the running statistics (Welford mean/variance, minimum and maximum) and,
+     *      when a lap buffer is attached, to that buffer. Both are O(1), when the lap
+     *      buffer is full the oldest lap is overwritten.
+     *
+     *      Unlike timer_t::getAverageMs(), which divides by the number of trips
+     *      including the start() calls, the lap statistics only count laps.
+     *
+     *  Example:
+     * <CODE>
+     *       tick_t laps[64];
+     *       stopwatch_t sw;
+     *       sw.setLapBuffer(laps, 64);
+     *       sw.start();
+     *       for (s32 i = 0; i < 1000; i++)
+     *       {
+     *           someFunction();
+     *           sw.trip();
+     *       }
+     *       x_printf("mean %f ms, stddev %f ms", sw.getMeanMs(), sw.getStdDevMs());
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class stopwatch_t
+    {
+    public:
+        stopwatch_t();
+
+        void start();
+        void reset();
+        tick_t stop();
+        tick_t read() const;
+        tick_t trip();
+
+        bool isRunning() const { return mIsRunning; }
+
+        ///< The buffer is owned by the caller, pass NULL to detach it
+        void setLapBuffer(tick_t *laps, u32 capacity);
+
+        u64 getNumLaps() const { return mStats.count(); }
+        u32 getNumStoredLaps() const;
+        tick_t getLap(u32 index) const; ///< 0 is the oldest stored lap
+        tick_t getLastLap() const { return mLastLap; }
+
+        ///@name Lap statistics in ticks
+        f64 getMean() const { return mStats.mean(); }
+        f64 getStdDev() const { return mStats.stddev(); }
+        tick_t getMin() const { return (tick_t)mStats.min(); }
+        tick_t getMax() const { return (tick_t)mStats.max(); }
+        const running_stats_t &getStats() const { return mStats; }
+
+        ///@name Lap statistics in milliseconds
+        f64 getMeanMs() const;
+        f64 getStdDevMs() const;
+        f64 getMinMs() const;
+        f64 getMaxMs() const;
+
+    private:
+        tick_t mStartTime;
+        tick_t mTotalTime;
+        tick_t mLastLap;
+        bool mIsRunning;
+        running_stats_t mStats;
+        tick_t *mLaps;
+        u32 mLapCapacity;
+        u32 mLapHead;
+    };
+
+#include "private/x_stopwatch_inline.h"
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef __X_TIME_STOPWATCH_POOL_H__
+#define __X_TIME_STOPWATCH_POOL_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+
+namespace xcore
+{
+    class alloc_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A pool of stopwatches stored as a structure of arrays: start times, total
+     *      times and running flags live in separate arrays. Operating on all (or a
+     *      range of) stopwatches reads x_GetTime() once and runs a branch-free loop
+     *      that the compiler can vectorize, a batch of indices also shares a single
+     *      x_GetTime().
+     *
+     *      A stopped stopwatch keeps its total time, starting it again continues to
+     *      accumulate, like timer_t.
+     *
+     *  Example:
+     * <CODE>
+     *       stopwatch_pool_t pool;
+     *       pool.init(allocator, num_entities);
+     *       pool.startBatch(active, num_active);
+     *       ...
+     *       pool.stopAll();
+     *       pool.readMs(0, num_entities, times_ms);
+     *       pool.exit();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class stopwatch_pool_t
+    {
+    public:
+        stopwatch_pool_t();
+        ~stopwatch_pool_t();
+
+        void init(alloc_t *allocator, u32 capacity);
+        void exit();
+
+        u32 getCapacity() const { return mCapacity; }
+
+        ///@name Single stopwatch
+        void start(u32 index);
+        tick_t stop(u32 index);
+        void reset(u32 index);
+        tick_t read(u32 index) const;
+        bool isRunning(u32 index) const { return mRunning[index] != 0; }
+
+        ///@name A batch of stopwatches by index, one x_GetTime() per batch
+        void startBatch(const u32 *indices, u32 count);
+        void stopBatch(const u32 *indices, u32 count);
+
+        ///@name A range of stopwatches
+        void startRange(u32 first, u32 count);
+        void stopRange(u32 first, u32 count);
+        void resetRange(u32 first, u32 count);
+        void add(u32 first, u32 count, const tick_t *ticks); ///< Adds ticks[i] to the total of stopwatch first+i
+
+        void startAll() { startRange(0, mCapacity); }
+        void stopAll() { stopRange(0, mCapacity); }
+        void resetAll() { resetRange(0, mCapacity); }
+
+        ///@name Bulk readout of the (running) total of stopwatches [first, first+count)
+        void read(u32 first, u32 count, tick_t *out) const;
+        void readMs(u32 first, u32 count, f64 *out) const;
+        void readUs(u32 first, u32 count, f64 *out) const;
+
+    private:
+        void readScaled(u32 first, u32 count, f64 *out, f64 scale) const;
+
+        alloc_t *mAllocator;
+        u32 mCapacity;
+        tick_t *mStart;
+        tick_t *mTotal;
+        u8 *mRunning;
+
+        stopwatch_pool_t(const stopwatch_pool_t &);
+        stopwatch_pool_t &operator=(const stopwatch_pool_t &);
+    };
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef __X_TIME_SEARCH_H__
+#define __X_TIME_SEARCH_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Searching sorted (non-decreasing) arrays of tick_t or datetime_t. All of
+     *      them return the lower bound: the index of the first value that is not
+     *      less than the key, or 'count' when there is none, like std::lower_bound.
+     *
+     *      x_LowerBound            Branch free binary search.
+     *      x_InterpolationSearch   Estimates the position from the first and last
+     *                              value of the range and gallops from there, which
+     *                              takes a few probes on evenly spread timestamps.
+     *                              After a few rounds it finishes with a binary
+     *                              search, so clustered data costs O(log n).
+     *      x_GallopSearch          Exponential search outward from 'hint', the cost
+     *                              is O(log distance). For cursors that move a little
+     *                              at a time, pass the previous result as the hint.
+     *      x_LowerBoundBatch       The lower bounds of a batch of keys sorted in
+     *                              ascending order, every search starts where the
+     *                              previous one ended.
+     *
+     *  Example:
+     * <CODE>
+     *       u32 i = x_InterpolationSearch(events, num_events, from);
+     *
+     *       u32 cursor = 0;
+     *       while (playing)
+     *           cursor = x_GallopSearch(events, num_events, x_GetTime(), cursor);
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    extern u32 x_LowerBound(const tick_t *values, u32 count, tick_t key);
+    extern u32 x_LowerBound(const datetime_t *values, u32 count, const datetime_t &key);
+
+    extern u32 x_InterpolationSearch(const tick_t *values, u32 count, tick_t key);
+    extern u32 x_InterpolationSearch(const datetime_t *values, u32 count, const datetime_t &key);
+
+    extern u32 x_GallopSearch(const tick_t *values, u32 count, tick_t key, u32 hint);
+    extern u32 x_GallopSearch(const datetime_t *values, u32 count, const datetime_t &key, u32 hint);
+
+    extern void x_LowerBoundBatch(const tick_t *values, u32 count, const tick_t *keys, u32 num_keys, u32 *out_indices);
+    extern void x_LowerBoundBatch(const datetime_t *values, u32 count, const datetime_t *keys, u32 num_keys, u32 *out_indices);
+
+}; // namespace xcore
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef __X_TIME_TRACE_WRITER_H__
+#define __X_TIME_TRACE_WRITER_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_profile.h"
+
+namespace xcore
+{
+    class alloc_t;
+    class framerate_t;
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Writes timing data as a Chrome trace-event JSON file, the same file can be
+     *      opened in chrome://tracing and in the Perfetto UI (ui.perfetto.dev).
+     *
+     *      The trace_writer_t is a profile_sink_t, pass it to x_ProfileFlush() to write
+     *      all recorded zones as begin/end events. Counters and frame markers can be
+     *      written directly. Timestamps are converted from tick_t to microseconds
+     *      relative to the epoch of the session, which is the time open() was called
+     *      unless specified.
+     *
+     *      Output is formatted into a fixed size chunk that is written to the file when
+     *      it is full, so the size of a capture is not limited by memory. Flushing the
+     *      profiler regularly keeps the per-thread buffers small.
+     *
+     *  Example:
+     * <CODE>
+     *       trace_writer_t writer;
+     *       writer.open("capture.json", allocator);
+     *       while (game_loop)
+     *       {
+     *           ...
+     *           writer.markFrame(fps);
+     *           x_ProfileFlush(&writer);
+     *       }
+     *       writer.close();
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class trace_writer_t : public profile_sink_t
+    {
+    public:
+        trace_writer_t();
+        ~trace_writer_t();
+
+        bool open(const char *filename, alloc_t *allocator, u32 chunk_size = 64 * 1024);
+        bool open(const char *filename, alloc_t *allocator, u32 chunk_size, tick_t epoch);
+        bool close();
+        bool isOpen() const { return mFile != NULL; }
+
+        virtual void onProfileEvents(u32 thread, const profile_event_t *events, u32 count);
+
+        void writeZone(u32 thread, const char *name, tick_t begin, tick_t end);
+        void writeCounter(const char *name, tick_t time, f64 value); ///< Non-finite values are skipped
+        void writeFrameMarker(tick_t time, u64 frame);
+        void markFrame(framerate_t &framerate);
+
+        u64 getNumEvents() const { return mNumEvents; }
+        u64 getNumBytesWritten() const { return mNumBytes; }
+
+    private:
+        void beginEvent(const char *name, const char *phase, u32 thread, tick_t time);
+        void endEvent();
+        void append(const char *str);
+        void appendString(const char *str);
+        void appendNumber(u64 value);
+        void appendTime(tick_t time);
+        void flush();
+
+        void *mFile;
+        alloc_t *mAllocator;
+        char *mChunk;
+        u32 mChunkSize;
+        u32 mChunkUsed;
+        tick_t mEpoch;
+        u64 mNumEvents;
+        u64 mNumBytes;
+        u64 mNumFrames;
+        bool mError;
+    };
+
+}; // namespace xcore
+
+#endif
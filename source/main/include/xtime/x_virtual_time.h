@@ -0,0 +1,113 @@
+#ifndef __X_TIME_VIRTUAL_TIME_H__
+#define __X_TIME_VIRTUAL_TIME_H__
+#include "xbase/x_target.h"
+#ifdef USE_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/private/x_time_source.h"
+#include "xtime/private/x_datetime_source.h"
+
+#include <atomic>
+
+namespace xcore
+{
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      A time source and a datetime source whose time only moves when it is told
+     *      to, for deterministic simulations and tests that should not wait on the
+     *      wall clock.
+     *
+     *      The tick count starts at 0 and is advanced with advance() or advanceTo().
+     *      The date and time is the origin plus the elapsed ticks, local time is UTC
+     *      plus the time zone offset. x_SleepUntil() on a virtual source does not
+     *      wait, it advances the time to the deadline.
+     *
+     *      It can be installed for the whole process with x_SetTimeSource() and
+     *      x_SetDateTimeSource(), or for the calling thread only with the thread
+     *      overrides (see virtual_time_scope_t). Threads with their own virtual time
+     *      are independent, many simulations can run in parallel on separate cores.
+     *      A thread does not inherit the overrides of the thread that started it.
+     *
+     *  Example:
+     * <CODE>
+     *       virtual_time_t clock(1000000, datetime_t(2020, 1, 1));
+     *       virtual_time_scope_t scope(clock);
+     *
+     *       timer_t timer;
+     *       timer.start();
+     *       clock.advance(x_SecondsToTicks(3600.0));
+     *       ASSERT(timer.readMs() == 3600000.0);
+     * </CODE>
+     * ------------------------------------------------------------------------------
+     */
+    class virtual_time_t : public time_source_t, public datetime_source_t
+    {
+    public:
+        virtual_time_t(s64 ticks_per_second = 1000000000, const datetime_t &origin = datetime_t(2000, 1, 1));
+
+        tick_t now() const { return mTicks.load(std::memory_order_acquire); }
+
+        void set(tick_t ticks);
+        void advance(tick_t ticks);
+        void advanceTo(tick_t ticks); ///< Never moves the time backwards
+        void advanceSeconds(f64 seconds);
+
+        const datetime_t &getOrigin() const { return mOrigin; }
+        void setOrigin(const datetime_t &origin) { mOrigin = origin; }
+
+        ///< Local time is UTC plus this many minutes, getSystemTimeZone() returns the negated offset
+        s32 getTimeZone() const { return mTimeZone; }
+        void setTimeZone(s32 minutes) { mTimeZone = minutes; }
+
+        ///@name time_source_t
+        virtual s64 getTimeInTicks();
+        virtual s64 getTicksPerSecond();
+        virtual bool sleepUntil(tick_t deadline);
+
+        ///@name datetime_source_t
+        virtual u64 getSystemTimeUtc();
+        virtual u64 getSystemTimeLocal();
+        virtual s64 getSystemTimeZone();
+        virtual u64 getSystemTimeAsFileTime();
+        virtual u64 getSystemTimeFromFileTime(u64 inFileSystemTime);
+        virtual u64 getFileTimeFromSystemTime(u64 inSystemTime);
+
+    private:
+        std::atomic<s64> mTicks;
+        s64 mTicksPerSecond;
+        datetime_t mOrigin;
+        s32 mTimeZone;
+
+        virtual_time_t(const virtual_time_t &);
+        virtual_time_t &operator=(const virtual_time_t &);
+    };
+
+    /**
+     * ------------------------------------------------------------------------------
+     *  Description:
+     *      Installs a virtual_time_t as the time and datetime source of the calling
+     *      thread for the lifetime of the scope, the previous overrides are restored
+     *      when the scope ends.
+     * ------------------------------------------------------------------------------
+     */
+    class virtual_time_scope_t
+    {
+    public:
+        virtual_time_scope_t(virtual_time_t &time);
+        ~virtual_time_scope_t();
+
+    private:
+        time_source_t *mPreviousTime;
+        datetime_source_t *mPreviousDateTime;
+
+        virtual_time_scope_t(const virtual_time_scope_t &);
+        virtual_time_scope_t &operator=(const virtual_time_scope_t &);
+    };
+
+}; // namespace xcore
+
+#endif
@@ -12,6 +12,30 @@ UNITTEST_SUITE_DECLARE(xTimeUnitTest, datetime);
 UNITTEST_SUITE_DECLARE(xTimeUnitTest, timer);
 UNITTEST_SUITE_DECLARE(xTimeUnitTest, framerate);
 UNITTEST_SUITE_DECLARE(xTimeUnitTest, timespan);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, radix_heap);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, scheduler);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, sleep);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, running_stats);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, frame_pacer);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, frame_stats);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, latency_histogram);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, profile);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, trace_writer);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, event_log);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, stopwatch);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, stopwatch_pool);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, cpu_timer);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, clock_pair);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, time_source);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, virtual_time);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, gameclock);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, fixed_step);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, dt_filter);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, delta_codec);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, packed_ticks);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, record_file);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, time_search);
+UNITTEST_SUITE_DECLARE(xTimeUnitTest, asof_join);
 
 
 namespace xcore
@@ -0,0 +1,160 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_asof_join.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(asof_join)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static u64 sRandom(u64& state)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return state >> 33;
+		}
+
+		static const u32 sMaxRows = 20000;
+		static datetime_t sLeft[sMaxRows];
+		static datetime_t sRight[sMaxRows];
+		static asof_pair_t sPairs[sMaxRows];
+		static asof_pair_t sExpected[sMaxRows];
+
+		// Sorted times from 09:00 with random gaps of up to 'max_gap' ticks, 0 makes duplicates
+		static void sFill(datetime_t* times, u32 count, u64 max_gap, u64& state)
+		{
+			u64 t = datetime_t(2024, 5, 17, 9, 0, 0).ticks();
+			for (u32 i = 0; i < count; ++i)
+			{
+				t += sRandom(state) % (max_gap + 1);
+				times[i] = datetime_t(t);
+			}
+		}
+
+		static u32 sReference(u32 num_left, u32 num_right, const asof_options_t& options)
+		{
+			u32 n = 0;
+			for (u32 i = 0; i < num_left; ++i)
+			{
+				// The number of right rows at or before the left row
+				u32 lo = 0;
+				u32 hi = num_right;
+				while (lo < hi)
+				{
+					u32 const mid = (lo + hi) / 2;
+					if (sRight[mid].ticks() <= sLeft[i].ticks())
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+				u32 match = lo > 0 ? lo - 1 : (u32)asof_pair_t::NO_MATCH;
+				if (match != asof_pair_t::NO_MATCH && sLeft[i].ticks() - sRight[match].ticks() > options.mTolerance.ticks())
+					match = asof_pair_t::NO_MATCH;
+				if (match != asof_pair_t::NO_MATCH || options.mKeepUnmatched)
+				{
+					sExpected[n].mLeft = i;
+					sExpected[n].mRight = match;
+					++n;
+				}
+			}
+			return n;
+		}
+
+		static bool sCheck(u32 num_left, u32 num_right, const asof_options_t& options)
+		{
+			u32 const expected = sReference(num_left, num_right, options);
+			u32 const n = x_AsOfJoin(sLeft, num_left, sRight, num_right, sPairs, options);
+			if (n != expected)
+				return false;
+			for (u32 i = 0; i < n; ++i)
+			{
+				if (sPairs[i].mLeft != sExpected[i].mLeft || sPairs[i].mRight != sExpected[i].mRight)
+					return false;
+			}
+			return true;
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+		}
+
+		UNITTEST_TEST(merge)
+		{
+			u64 state = 17;
+			asof_options_t options;
+			CHECK_EQUAL(1, (s32)options.mNumThreads);
+
+			// Dense and sparse right columns with duplicates
+			u64 const gaps[][2] = { { 1000, 1000 }, { 100000, 50 }, { 10, 100000 }, { 3, 3 } };
+			for (u32 g = 0; g < 4; ++g)
+			{
+				sFill(sLeft, 2000, gaps[g][0], state);
+				sFill(sRight, 3000, gaps[g][1], state);
+				options.mKeepUnmatched = false;
+				options.mTolerance = timespan_t::sMaxValue;
+				CHECK_TRUE(sCheck(2000, 3000, options));
+				options.mKeepUnmatched = true;
+				CHECK_TRUE(sCheck(2000, 3000, options));
+				options.mTolerance = timespan_t::sFromTicks(500);
+				CHECK_TRUE(sCheck(2000, 3000, options));
+				options.mKeepUnmatched = false;
+				CHECK_TRUE(sCheck(2000, 3000, options));
+			}
+
+			CHECK_EQUAL(0, x_AsOfJoin(sLeft, 0, sRight, 10, sPairs));
+			CHECK_EQUAL(0, x_AsOfJoin(sLeft, 10, sRight, 0, sPairs));
+			options.mKeepUnmatched = true;
+			CHECK_EQUAL(10, x_AsOfJoin(sLeft, 10, sRight, 0, sPairs, options));
+			CHECK_EQUAL((u32)asof_pair_t::NO_MATCH, sPairs[9].mRight);
+		}
+
+		UNITTEST_TEST(example)
+		{
+			// Trades at 10:00:00.5 and 10:00:03, quotes at 10:00:00, 10:00:00.5 (twice) and 10:00:01
+			sLeft[0] = datetime_t(2024, 5, 17, 10, 0, 0, 500);
+			sLeft[1] = datetime_t(2024, 5, 17, 10, 0, 3);
+			sRight[0] = datetime_t(2024, 5, 17, 10, 0, 0);
+			sRight[1] = datetime_t(2024, 5, 17, 10, 0, 0, 500);
+			sRight[2] = datetime_t(2024, 5, 17, 10, 0, 0, 500);
+			sRight[3] = datetime_t(2024, 5, 17, 10, 0, 1);
+
+			CHECK_EQUAL(2, x_AsOfJoin(sLeft, 2, sRight, 4, sPairs));
+			CHECK_EQUAL(2, sPairs[0].mRight);
+			CHECK_EQUAL(3, sPairs[1].mRight);
+
+			asof_options_t options;
+			options.mTolerance = timespan_t::sFromSeconds(1);
+			CHECK_EQUAL(1, x_AsOfJoin(sLeft, 2, sRight, 4, sPairs, options));
+			CHECK_EQUAL(0, sPairs[0].mLeft);
+			CHECK_EQUAL(2, sPairs[0].mRight);
+		}
+
+		UNITTEST_TEST(partitioned)
+		{
+			u64 state = 99;
+			asof_options_t options;
+			options.mMinRowsPerThread = 1000;
+			sFill(sLeft, sMaxRows, 700, state);
+			sFill(sRight, sMaxRows, 1000, state);
+			for (u32 threads = 0; threads <= 7; ++threads)
+			{
+				options.mNumThreads = threads;
+				options.mTolerance = timespan_t::sMaxValue;
+				options.mKeepUnmatched = false;
+				CHECK_TRUE(sCheck(sMaxRows, sMaxRows, options));
+				options.mTolerance = timespan_t::sFromTicks(300);
+				CHECK_TRUE(sCheck(sMaxRows, sMaxRows, options));
+				options.mKeepUnmatched = true;
+				CHECK_TRUE(sCheck(sMaxRows, sMaxRows, options));
+			}
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,176 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_clock_pair.h"
+
+#include "xtime/private/x_time_source.h"
+#include "xtime/private/x_datetime_source.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(clock_pair)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static const u64 TicksPerDay = X_CONSTANT_64(0xc92a69c000);
+
+		// Every read of the time advances it, the wall clock runs at a configurable
+		// rate (in ppm) relative to the monotonic clock.
+		class xtime_source_test : public time_source_t
+		{
+		public:
+			tick_t			mTicks;
+			tick_t			mStep;
+
+			xtime_source_test()
+				: mTicks(0)
+				, mStep(0)
+			{
+			}
+
+			void			reset(tick_t step)
+			{
+				mTicks = 1000;
+				mStep = step;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				tick_t const t = mTicks;
+				mTicks += mStep;
+				return t;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+
+		class xdatetime_source_test : public datetime_source_t
+		{
+		public:
+			s64					mDriftPpm;
+			s64					mOffset;
+
+			void				reset(s64 drift_ppm)
+			{
+				mDriftPpm = drift_ppm;
+				mOffset = 0;
+			}
+
+			// 10 datetime ticks per microsecond, plus the drift
+			virtual u64			getSystemTimeUtc()
+			{
+				s64 const t = sTimeSource.mTicks * 10;
+				return TicksPerDay + (u64)(t + (t * mDriftPpm) / 1000000 + mOffset);
+			}
+
+			virtual s64			getSystemTimeZone()							{ return 0; }
+			virtual u64			getSystemTimeLocal()						{ return getSystemTimeUtc(); }
+			virtual u64			getSystemTimeAsFileTime()					{ return getSystemTimeUtc(); }
+			virtual u64			getSystemTimeFromFileTime(u64 inFileTime)	{ return inFileTime; }
+			virtual u64			getFileTimeFromSystemTime(u64 inSystemTime)	{ return inSystemTime; }
+		};
+
+		static xdatetime_source_test sDateTimeSource;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+			x_SetDateTimeSource(&sDateTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+			x_SetDateTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(sample)
+		{
+			sTimeSource.reset(4);
+			sDateTimeSource.reset(0);
+
+			// before = 1000, the wall clock is read at 1004, after = 1004
+			clock_pair_t pair;
+			x_SampleClockPair(pair, 1);
+			CHECK_EQUAL(1002, pair.mTicks);
+			CHECK_EQUAL(2, pair.mUncertainty);
+			CHECK_EQUAL(TicksPerDay + 10040, pair.mDateTime);
+
+			sTimeSource.reset(0);
+			x_SampleClockPair(pair);
+			CHECK_EQUAL(1000, pair.mTicks);
+			CHECK_EQUAL(0, pair.mUncertainty);
+			CHECK_EQUAL(TicksPerDay + 10000, pair.mDateTime);
+		}
+
+		UNITTEST_TEST(map)
+		{
+			sTimeSource.reset(0);
+			sDateTimeSource.reset(0);
+
+			tick_datetime_map_t map;
+			map.init(1000000);
+			CHECK_EQUAL(1, map.getNumAnchors());
+			CHECK_CLOSE(10.0, map.getNominalRate(), 0.0000001);
+			CHECK_CLOSE(10.0, map.getRate(), 0.0000001);
+
+			CHECK_EQUAL(TicksPerDay + 10000, map.toDateTimeTicks(1000));
+			CHECK_EQUAL(TicksPerDay + 20000, map.toDateTime(2000).ticks());
+			CHECK_EQUAL(1500, map.toTicks(datetime_t(TicksPerDay + 15000)));
+
+			// Not due yet
+			sTimeSource.mTicks += 500000;
+			CHECK_FALSE(map.update());
+			sTimeSource.mTicks += 500000;
+			CHECK_TRUE(map.update());
+			CHECK_EQUAL(2, map.getNumAnchors());
+			CHECK_EQUAL(0, map.getLastError());
+		}
+
+		UNITTEST_TEST(drift)
+		{
+			sTimeSource.reset(0);
+			sDateTimeSource.reset(100);
+
+			tick_datetime_map_t map;
+			map.init(1000000, 500);
+
+			// The first interval runs at the nominal rate, the error is the drift
+			sTimeSource.mTicks += 1000000;
+			CHECK_TRUE(map.update());
+			CHECK_EQUAL(-1000, map.getLastError());
+			CHECK_CLOSE(10.001, map.getRate(), 0.0000001);
+
+			// After that the map follows the drift
+			sTimeSource.mTicks += 1000000;
+			CHECK_TRUE(map.update());
+			CHECK_EQUAL(0, map.getLastError());
+			tick_t const t = sTimeSource.mTicks + 12345;
+			CHECK_EQUAL(sDateTimeSource.getSystemTimeUtc() + 123462, map.toDateTimeTicks(t));
+		}
+
+		UNITTEST_TEST(step)
+		{
+			sTimeSource.reset(0);
+			sDateTimeSource.reset(0);
+
+			tick_datetime_map_t map;
+			map.init(1000000, 500);
+
+			// A wall clock step of 1 second does not become a rate
+			sTimeSource.mTicks += 1000000;
+			sDateTimeSource.mOffset = 10000000;
+			CHECK_TRUE(map.update());
+			CHECK_EQUAL(-10000000, map.getLastError());
+			CHECK_CLOSE(10.005, map.getRate(), 0.0000001);
+			CHECK_EQUAL(sDateTimeSource.getSystemTimeUtc(), map.toDateTimeTicks(sTimeSource.mTicks));
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,102 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_sleep.h"
+#include "xtime/x_cpu_timer.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(cpu_timer)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static volatile u64 sSink = 0;
+
+		static void sBusy(f64 ms)
+		{
+			tick_t const end = x_GetTime() + x_MillisecondsToTicks(ms);
+			u64 x = 1;
+			while (x_GetTime() < end)
+			{
+				for (s32 i = 0; i < 1000; ++i)
+					x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+			}
+			sSink = x;
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			xtime::x_Init();
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			xtime::x_Exit();
+		}
+
+		UNITTEST_TEST(clocks)
+		{
+			tick_t const thread = x_GetThreadCpuTime();
+			tick_t const process = x_GetProcessCpuTime();
+			sBusy(5.0);
+			CHECK_TRUE(x_GetThreadCpuTime() > thread);
+			CHECK_TRUE(x_GetProcessCpuTime() > process);
+			tick_t const thread_now = x_GetThreadCpuTime();
+			CHECK_TRUE(x_GetProcessCpuTime() + x_MillisecondsToTicks(1.0) >= thread_now);
+		}
+
+		UNITTEST_TEST(start_stop_trip)
+		{
+			cpu_timer_t timer;
+			CHECK_EQUAL(cpu_timer_t::THREAD, timer.getClock());
+			CHECK_FALSE(timer.isRunning());
+			CHECK_EQUAL(0, timer.read());
+			CHECK_EQUAL(0, timer.trip());
+
+			timer.start();
+			CHECK_TRUE(timer.isRunning());
+			sBusy(20.0);
+			f64 const ms = timer.tripMs();
+			CHECK_TRUE(ms > 10.0 && ms < 40.0);
+			CHECK_TRUE(timer.readMs() < 5.0);
+
+			sBusy(10.0);
+			tick_t const t = timer.stop();
+			CHECK_FALSE(timer.isRunning());
+			CHECK_EQUAL(t, timer.read());
+			CHECK_EQUAL(2, timer.getNumTrips());
+
+			timer.reset();
+			CHECK_EQUAL(0, timer.read());
+			CHECK_EQUAL(0, timer.getNumTrips());
+		}
+
+		UNITTEST_TEST(utilization)
+		{
+			cpu_usage_timer_t timer;
+			cpu_usage_t usage;
+
+			timer.start();
+			CHECK_TRUE(timer.isRunning());
+			sBusy(20.0);
+			timer.trip(usage);
+			CHECK_TRUE(x_TicksToMs(usage.mWall) >= 20.0);
+			CHECK_TRUE(usage.mThreadUtilization > 0.5 && usage.mThreadUtilization < 1.1);
+			CHECK_TRUE(usage.mProcessCpu + x_MillisecondsToTicks(1.0) >= usage.mThreadCpu);
+
+			// Sleeping is wall time without CPU time
+			x_SleepFor(timespan_t::sFromMilliseconds(30));
+			timer.stop(usage);
+			CHECK_FALSE(timer.isRunning());
+			CHECK_TRUE(x_TicksToMs(usage.mWall) >= 30.0);
+			CHECK_TRUE(usage.mThreadUtilization < 0.5);
+
+			timer.reset();
+			timer.read(usage);
+			CHECK_EQUAL(0, usage.mWall);
+			CHECK_TRUE(usage.mThreadUtilization == 0.0);
+		}
+	}
+}
+UNITTEST_SUITE_END
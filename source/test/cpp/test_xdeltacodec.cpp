@@ -0,0 +1,186 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_delta_codec.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(delta_codec)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static u64 sRandom(u64& state)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return state >> 33;
+		}
+
+		static const u32 sCount = 4096;
+		static tick_t sValues[sCount];
+		static tick_t sDecoded[sCount];
+		static u8 sBuffer[sCount * 10];
+
+		static bool sRoundTrip(const tick_t* values, u32 count, u32& bytes)
+		{
+			delta_encoder_t encoder;
+			encoder.init(sBuffer, sizeof(sBuffer));
+			if (encoder.write(values, count) != count)
+				return false;
+			bytes = encoder.finish();
+
+			// Value by value
+			delta_decoder_t decoder;
+			decoder.init(sBuffer, bytes, count);
+			for (u32 i = 0; i < count; ++i)
+			{
+				tick_t t;
+				if (!decoder.read(t) || t != values[i])
+					return false;
+			}
+			tick_t t;
+			if (decoder.read(t))
+				return false;
+
+			// In batches of varying size
+			decoder.init(sBuffer, bytes, count);
+			u32 n = 0;
+			u32 batch = 1;
+			while (n < count)
+			{
+				u32 const got = decoder.read(sDecoded + n, batch);
+				if (got == 0)
+					return false;
+				n += got;
+				batch = batch * 3 + 1;
+			}
+			for (u32 i = 0; i < count; ++i)
+			{
+				if (sDecoded[i] != values[i])
+					return false;
+			}
+			return decoder.getNumRemaining() == 0;
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+		}
+
+		UNITTEST_TEST(regular)
+		{
+			for (u32 i = 0; i < sCount; ++i)
+				sValues[i] = X_CONSTANT_64(1000000000000) + (tick_t)i * 16666667;
+			u32 bytes;
+			CHECK_TRUE(sRoundTrip(sValues, sCount, bytes));
+			// 64 bits, one delta and then 1 bit per value
+			CHECK_TRUE(bytes < 8 + 8 + sCount / 8 + 1);
+		}
+
+		UNITTEST_TEST(jitter)
+		{
+			u64 state = 1;
+			for (u32 i = 0; i < sCount; ++i)
+				sValues[i] = (tick_t)i * 1000000 + (tick_t)(sRandom(state) % 2000);
+			u32 bytes;
+			CHECK_TRUE(sRoundTrip(sValues, sCount, bytes));
+			CHECK_TRUE(bytes < sCount * 3);
+		}
+
+		UNITTEST_TEST(extremes)
+		{
+			u64 state = 7;
+			for (u32 i = 0; i < sCount; ++i)
+			{
+				u64 const r = sRandom(state);
+				switch (i % 5)
+				{
+				case 0: sValues[i] = (tick_t)((r << 40) ^ (r << 7) ^ r); break;
+				case 1: sValues[i] = sValues[i - 1]; break;
+				case 2: sValues[i] = sValues[i - 1] - (tick_t)(r & 0xffffff); break;
+				case 3: sValues[i] = (tick_t)X_CONSTANT_64(0x7fffffffffffffff); break;
+				default: sValues[i] = -(tick_t)X_CONSTANT_64(0x7fffffffffffffff) - 1; break;
+				}
+			}
+			u32 bytes;
+			CHECK_TRUE(sRoundTrip(sValues, sCount, bytes));
+			CHECK_TRUE(sRoundTrip(sValues, 1, bytes));
+			CHECK_EQUAL(8, (s32)bytes);
+			CHECK_TRUE(sRoundTrip(sValues, 0, bytes));
+			CHECK_EQUAL(0, (s32)bytes);
+		}
+
+		UNITTEST_TEST(mixed)
+		{
+			// Every code length in random order, with runs of an unchanged delta in between
+			u64 state = 3;
+			u64 delta = 1000000;
+			sValues[0] = X_CONSTANT_64(1700000000000000000);
+			for (u32 i = 1; i < sCount; ++i)
+			{
+				u64 const r = sRandom(state);
+				static const u32 sBits[6] = { 0, 6, 12, 18, 30, 62 };
+				u32 const bits = sBits[r % 6];
+				if (bits > 0)
+					delta += (sRandom(state) & ((X_CONSTANT_64(1) << bits) - 1)) - (X_CONSTANT_64(1) << (bits - 1));
+				sValues[i] = (tick_t)((u64)sValues[i - 1] + delta);
+			}
+			u32 bytes;
+			CHECK_TRUE(sRoundTrip(sValues, sCount, bytes));
+			CHECK_TRUE(sRoundTrip(sValues, 77, bytes));
+		}
+
+		UNITTEST_TEST(datetime)
+		{
+			datetime_t const start(2024, 3, 1, 12, 0, 0);
+			u8 buffer[64];
+			delta_encoder_t encoder;
+			encoder.init(buffer, sizeof(buffer));
+			for (s32 i = 0; i < 10; ++i)
+			{
+				datetime_t dt(start);
+				dt.addSeconds(i * 15);
+				CHECK_TRUE(encoder.write(dt));
+			}
+			u32 const bytes = encoder.finish();
+
+			delta_decoder_t decoder;
+			decoder.init(buffer, bytes, encoder.getNumValues());
+			for (s32 i = 0; i < 10; ++i)
+			{
+				datetime_t dt;
+				CHECK_TRUE(decoder.read(dt));
+				CHECK_EQUAL(start.ticks() + (u64)i * 150000000, dt.ticks());
+			}
+		}
+
+		UNITTEST_TEST(buffer_full)
+		{
+			u8 buffer[10];
+			delta_encoder_t encoder;
+			encoder.init(buffer, sizeof(buffer));
+			CHECK_TRUE(encoder.write(100));
+			// The first delta of 2^40 needs 5 + 64 bits
+			CHECK_FALSE(encoder.write(100 + X_CONSTANT_64(0x10000000000)));
+			CHECK_TRUE(encoder.write(101));
+			u32 n = 2;
+			while (encoder.write(102 + (tick_t)(n - 2) + 1 - 1 + 0 * n) && n < 1000)
+				++n;
+			CHECK_TRUE(encoder.getNumBytes() <= 10);
+			u32 const bytes = encoder.finish();
+			CHECK_TRUE(bytes <= 10);
+
+			delta_decoder_t decoder;
+			decoder.init(buffer, bytes, encoder.getNumValues());
+			tick_t t;
+			CHECK_TRUE(decoder.read(t));
+			CHECK_EQUAL(100, t);
+			CHECK_TRUE(decoder.read(t));
+			CHECK_EQUAL(101, t);
+		}
+	}
+}
+UNITTEST_SUITE_END
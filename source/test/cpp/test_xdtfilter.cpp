@@ -0,0 +1,119 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_frame_rate.h"
+#include "xtime/x_dt_filter.h"
+#include "xtime/x_virtual_time.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(dt_filter)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static virtual_time_t sTime(1000000);
+		static time_source_t* sPrevious = NULL;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			sPrevious = x_SetThreadTimeSource(&sTime);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetThreadTimeSource(sPrevious);
+		}
+
+		UNITTEST_TEST(cap)
+		{
+			dt_filter_t dt;
+			CHECK_EQUAL(250000, dt.getMaxDelta());
+			CHECK_EQUAL(16000, dt.filter(16000));
+			CHECK_EQUAL(250000, dt.filter(2000000));
+			CHECK_EQUAL(2000000, dt.getRawDelta());
+			CHECK_EQUAL(1, (s32)dt.getNumCapped());
+			CHECK_EQUAL(0, dt.filter(-5));
+			dt.setMaxDelta(0);
+			CHECK_EQUAL(2000000, dt.filter(2000000));
+		}
+
+		UNITTEST_TEST(ema)
+		{
+			dt_filter_t dt;
+			dt.setMode(dt_filter_t::EMA);
+			dt.setEmaWeight(0.5);
+			CHECK_EQUAL(1000, dt.filter(1000));
+			CHECK_EQUAL(2000, dt.filter(3000));
+			CHECK_EQUAL(1500, dt.filter(1000));
+		}
+
+		UNITTEST_TEST(median)
+		{
+			dt_filter_t dt;
+			dt.setMode(dt_filter_t::MEDIAN);
+			dt.setMedianWindow(3);
+			CHECK_EQUAL(100, dt.filter(100));
+			CHECK_EQUAL(150, dt.filter(200));
+			CHECK_EQUAL(100, dt.filter(10));
+			// A single spike does not get through a window of 3
+			CHECK_EQUAL(200, dt.filter(100000));
+			CHECK_EQUAL(100, dt.filter(100));
+			CHECK_EQUAL(100, dt.filter(100));
+			CHECK_EQUAL(100, dt.filter(300));
+			CHECK_EQUAL(300, dt.filter(300));
+		}
+
+		UNITTEST_TEST(vsync)
+		{
+			dt_filter_t dt;
+			dt.setMode(dt_filter_t::VSYNC);
+			dt.setRefreshRate(60.0);
+			// 1/60 s is 16667 ticks at 1 MHz
+			CHECK_EQUAL(16667, dt.filter(16500));
+			CHECK_EQUAL(16667, dt.filter(16900));
+			// A missed vblank snaps to two periods
+			CHECK_EQUAL(2 * 16667, dt.filter(33000));
+
+			// The snapped deltas do not drift from real time
+			dt.reset();
+			tick_t raw = 0, filtered = 0;
+			for (s32 i = 0; i < 1000; ++i)
+			{
+				tick_t const d = (i & 1) != 0 ? 16000 : 17300;
+				raw += d;
+				filtered += dt.filter(d);
+			}
+			tick_t const diff = raw > filtered ? raw - filtered : filtered - raw;
+			CHECK_TRUE(diff <= 1667);
+
+			// A delta that fits no period passes through
+			dt.reset();
+			CHECK_EQUAL(25000, dt.filter(25000));
+
+			f64 const rates[] = { 60.0, 144.0 };
+			dt.setRefreshRates(rates, 2);
+			CHECK_EQUAL(6944, dt.filter(7000));
+		}
+
+		UNITTEST_TEST(mark_frame_shares_clock)
+		{
+			framerate_t fps;
+			dt_filter_t dt;
+			dt.attach(&fps);
+
+			sTime.set(0);
+			fps.restart();
+			CHECK_EQUAL(0, dt.markFrame());
+			for (s32 i = 0; i < 100; ++i)
+			{
+				sTime.advance(10000);
+				CHECK_EQUAL(10000, dt.markFrame());
+			}
+			f32 rate;
+			CHECK_TRUE(fps.getFrameRate(rate));
+			// The first mark counts as a frame as well
+			CHECK_EQUAL(101.0f, rate);
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,156 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_event_log.h"
+
+#include <stdio.h>
+#include <thread>
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(event_log)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static const char* sFilename = "test_xeventlog.bin";
+
+		static bool sEqual(const char* a, const char* b)
+		{
+			while (*a != '\0' && *a == *b)
+			{
+				++a;
+				++b;
+			}
+			return *a == *b;
+		}
+
+		static void sProducer()
+		{
+			// Renamed while the writer thread may be copying the name, the last one sticks
+			for (u32 i = 0; i < 1000; ++i)
+			{
+				if ((i % 100) == 0)
+					x_EventLogSetThreadName((i % 200) == 0 ? "producer thread" : "producer");
+				while (!x_EventLogWrite(2, i))
+					std::this_thread::yield();
+			}
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			xtime::x_Init();
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			xtime::x_Exit();
+		}
+
+		UNITTEST_TEST(closed)
+		{
+			CHECK_FALSE(x_EventLogIsOpen());
+			CHECK_FALSE(x_EventLogWrite(1, 1));
+			CHECK_FALSE(x_EventLogClose());
+		}
+
+		UNITTEST_TEST(write_and_read)
+		{
+			datetime_t const before = datetime_t::sNowUtc();
+			CHECK_TRUE(x_EventLogOpen(gTestAllocator, sFilename, 256, 4, 1));
+			CHECK_TRUE(x_EventLogIsOpen());
+			x_EventLogSetThreadName("main");
+
+			std::thread producer(sProducer);
+			for (u32 i = 0; i < 1000; ++i)
+			{
+				while (!x_EventLogWrite(1, i))
+					std::this_thread::yield();
+			}
+			producer.join();
+			tick_t const end = x_GetTime();
+			CHECK_TRUE(x_EventLogClose());
+			CHECK_FALSE(x_EventLogIsOpen());
+
+			event_log_reader_t reader;
+			CHECK_TRUE(reader.open(sFilename, gTestAllocator));
+			CHECK_EQUAL(x_GetTicksPerSecond(), reader.getTicksPerSecond());
+			CHECK_TRUE(reader.getStartTime().ticks() >= before.ticks());
+
+			u32 counts[2] = { 0, 0 };
+			tick_t last[2] = { 0, 0 };
+			u32 threads[2] = { 0, 0 };
+			bool ordered = true;
+			event_record_t record;
+			while (reader.read(record))
+			{
+				CHECK_TRUE(record.mId == 1 || record.mId == 2);
+				u32 const i = record.mId - 1;
+				ordered = ordered && record.mPayload == counts[i] && record.mTime >= last[i] && record.mTime <= end;
+				threads[i] = record.mThread;
+				last[i] = record.mTime;
+				counts[i]++;
+			}
+			CHECK_TRUE(ordered);
+			CHECK_EQUAL(1000, counts[0]);
+			CHECK_EQUAL(1000, counts[1]);
+			CHECK_TRUE(sEqual("main", reader.getThreadName(threads[0])));
+			CHECK_TRUE(sEqual("producer", reader.getThreadName(threads[1])));
+
+			CHECK_TRUE(reader.toSeconds(reader.getStartTicks()) == 0.0);
+			CHECK_EQUAL(1000000, reader.toMicroseconds(reader.getStartTicks() + reader.getTicksPerSecond()));
+			datetime_t const later = reader.toDateTime(reader.getStartTicks() + 2 * reader.getTicksPerSecond());
+			CHECK_EQUAL(reader.getStartTime().ticks() + 20000000, later.ticks());
+			reader.close();
+			remove(sFilename);
+		}
+
+		UNITTEST_TEST(dropped)
+		{
+			// One buffer of 64 events that is flushed rarely
+			CHECK_TRUE(x_EventLogOpen(gTestAllocator, sFilename, 64, 1, 1000));
+			u32 written = 0;
+			for (u32 i = 0; i < 100; ++i)
+				written += x_EventLogWrite(7, i) ? 1 : 0;
+			CHECK_TRUE(written >= 64);
+			CHECK_EQUAL(100 - written, x_EventLogGetNumDropped());
+
+			// The arena has room for a single thread
+			std::thread other([]() { x_EventLogWrite(8, 0); });
+			other.join();
+			CHECK_EQUAL(100 - written + 1, x_EventLogGetNumDropped());
+			CHECK_TRUE(x_EventLogClose());
+
+			event_log_reader_t reader;
+			CHECK_TRUE(reader.open(sFilename, gTestAllocator));
+			u32 count = 0;
+			event_record_t record;
+			while (reader.read(record))
+				count++;
+			CHECK_EQUAL(written, count);
+			reader.close();
+			remove(sFilename);
+		}
+
+		UNITTEST_TEST(arena_too_large)
+		{
+			// The arena must fit in one 32-bit allocation, nothing is created when it does not
+			remove(sFilename);
+			CHECK_FALSE(x_EventLogOpen(gTestAllocator, sFilename, 1 << 24, 1024, 1));
+			CHECK_FALSE(x_EventLogOpen(gTestAllocator, sFilename, 0xffffffff, 1, 1));
+			CHECK_FALSE(x_EventLogIsOpen());
+			FILE* file = fopen(sFilename, "rb");
+			CHECK_TRUE(file == NULL);
+			if (file != NULL)
+				fclose(file);
+
+			CHECK_TRUE(x_EventLogOpen(gTestAllocator, sFilename, 64, 1, 1));
+			CHECK_TRUE(x_EventLogClose());
+			remove(sFilename);
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,106 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_fixed_step.h"
+#include "xtime/x_virtual_time.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(fixed_step)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static virtual_time_t sTime(1000000000);
+		static time_source_t* sPrevious = NULL;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			sPrevious = x_SetThreadTimeSource(&sTime);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetThreadTimeSource(sPrevious);
+		}
+
+		UNITTEST_TEST(steps_and_alpha)
+		{
+			fixed_step_t fixed;
+			fixed.setStep(100);
+			fixed.restart(0);
+
+			CHECK_EQUAL(0, (s32)fixed.update(50));
+			CHECK_EQUAL(0.5, fixed.getAlpha());
+			CHECK_EQUAL(50, fixed.getAccumulator());
+
+			CHECK_EQUAL(1, (s32)fixed.update(175));
+			CHECK_EQUAL(0.75, fixed.getAlpha());
+
+			CHECK_EQUAL(3, (s32)fixed.update(475));
+			CHECK_EQUAL(0.75, fixed.getAlpha());
+			CHECK_EQUAL(4, (s32)fixed.getNumSteps());
+			CHECK_EQUAL(400, fixed.getTime());
+
+			// Time going backwards or standing still runs nothing
+			CHECK_EQUAL(0, (s32)fixed.update(475));
+			CHECK_EQUAL(0, (s32)fixed.advance(-10));
+		}
+
+		UNITTEST_TEST(spiral_of_death)
+		{
+			fixed_step_t fixed;
+			fixed.setStep(100);
+			fixed.setMaxSteps(4);
+			fixed.restart(0);
+
+			CHECK_EQUAL(4, (s32)fixed.advance(1050));
+			CHECK_EQUAL(6, (s32)fixed.getNumDropped());
+			CHECK_EQUAL(0.5, fixed.getAlpha());
+			CHECK_EQUAL(2, (s32)fixed.advance(150));
+			CHECK_EQUAL(6, (s32)fixed.getNumSteps());
+		}
+
+		// 60 Hz on a 1 GHz clock is not a whole number of ticks, there is no drift
+		UNITTEST_TEST(no_drift)
+		{
+			fixed_step_t fixed;
+			fixed.setStepRate(60);
+			CHECK_EQUAL(16666666, fixed.getStep());
+
+			sTime.set(0);
+			fixed.restart();
+			u64 steps = 0;
+			// One hour of frames at 144 Hz, with some jitter
+			for (s32 i = 0; i < 144 * 3600; ++i)
+			{
+				sTime.advance((i & 1) != 0 ? 6944444 + 100 : 6944444 - 100);
+				steps += fixed.update();
+			}
+			tick_t const elapsed = sTime.now();
+			CHECK_EQUAL((s64)(elapsed * 60 / 1000000000), (s64)steps);
+			CHECK_EQUAL(0, (s32)fixed.getNumDropped());
+			CHECK_TRUE(fixed.getTime() <= elapsed);
+			CHECK_TRUE(elapsed - fixed.getTime() < fixed.getStep() + 1);
+
+			// Exactly 60 steps per second
+			fixed.restart(0);
+			CHECK_EQUAL(8, (s32)fixed.getMaxSteps());
+			fixed.setMaxSteps(1000);
+			CHECK_EQUAL(60, (s32)fixed.update(1000000000));
+			CHECK_EQUAL(0.0, fixed.getAlpha());
+			CHECK_EQUAL(1000000000, fixed.getTime());
+		}
+
+		UNITTEST_TEST(change_step_keeps_alpha)
+		{
+			fixed_step_t fixed;
+			fixed.setStep(100);
+			fixed.restart(0);
+			fixed.advance(25);
+			fixed.setStep(200);
+			CHECK_EQUAL(0.25, fixed.getAlpha());
+			CHECK_EQUAL(50, fixed.getAccumulator());
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,148 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_frame_rate.h"
+#include "xtime/x_frame_pacer.h"
+#include "xtime/private/x_time_source.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(frame_pacer)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		// Every read of the time advances it by one tick, so waiting always terminates
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks++;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(target)
+		{
+			frame_pacer_t pacer;
+			pacer.setTargetRate(1000.0);
+			CHECK_EQUAL(1000, pacer.getTargetPeriod());
+			CHECK_CLOSE(1000.0, pacer.getTargetRate(), 0.001);
+
+			pacer.setTargetPeriod(250);
+			CHECK_EQUAL(250, pacer.getTargetPeriod());
+			CHECK_CLOSE(4000.0, pacer.getTargetRate(), 0.001);
+		}
+
+		UNITTEST_TEST(schedule)
+		{
+			sTimeSource.reset();
+
+			frame_pacer_t pacer;
+			pacer.setTargetPeriod(100);
+			pacer.restart();
+			tick_t const first = pacer.getNextDeadline();
+
+			for (s32 i = 0; i < 10; ++i)
+			{
+				sTimeSource.update(30);
+				tick_t const deadline = pacer.getNextDeadline();
+				tick_t const now = pacer.waitForNextFrame();
+				CHECK_TRUE(now >= deadline);
+				CHECK_EQUAL(first + (i + 1) * 100, pacer.getNextDeadline());
+			}
+
+			CHECK_EQUAL(10, pacer.getNumFrames());
+			CHECK_EQUAL(0, pacer.getNumMissed());
+			CHECK_EQUAL(10, pacer.getJitter().count());
+			CHECK_TRUE(pacer.getJitter().min() >= 0.0);
+		}
+
+		UNITTEST_TEST(missed)
+		{
+			sTimeSource.reset();
+
+			framerate_t fps;
+			frame_pacer_t pacer;
+			pacer.setTargetPeriod(100);
+			pacer.attach(&fps);
+			pacer.restart();
+			tick_t const first = pacer.getNextDeadline();
+
+			sTimeSource.update(350);
+			pacer.waitForNextFrame();
+			CHECK_EQUAL(3, pacer.getNumMissed());
+			CHECK_EQUAL(first + 300, pacer.getNextDeadline());
+			CHECK_EQUAL(0, pacer.getJitter().count());
+
+			pacer.waitForNextFrame();
+			CHECK_EQUAL(3, pacer.getNumMissed());
+			CHECK_EQUAL(2, pacer.getNumFrames());
+
+			pacer.resetStats();
+			CHECK_EQUAL(0, pacer.getNumMissed());
+			CHECK_EQUAL(0, pacer.getNumFrames());
+		}
+
+		UNITTEST_TEST(first_use_without_restart)
+		{
+			sTimeSource.reset();
+			sTimeSource.update(5000);
+
+			frame_pacer_t pacer;
+			pacer.setTargetPeriod(100);
+			CHECK_EQUAL(0, pacer.getNextDeadline());
+
+			// The schedule starts at the first wait, no frames are missed
+			tick_t const now = pacer.waitForNextFrame();
+			CHECK_TRUE(now >= 5100);
+			CHECK_EQUAL(0, pacer.getNumMissed());
+			CHECK_EQUAL(1, pacer.getNumFrames());
+			tick_t const next = pacer.getNextDeadline();
+			CHECK_TRUE(next > now && next <= now + 100);
+
+			// A new period starts a new schedule at the next wait
+			pacer.setTargetPeriod(100);
+			CHECK_EQUAL(next, pacer.getNextDeadline());
+			pacer.setTargetPeriod(40);
+			CHECK_EQUAL(0, pacer.getNextDeadline());
+			sTimeSource.update(1000);
+			pacer.waitForNextFrame();
+			CHECK_EQUAL(0, pacer.getNumMissed());
+			CHECK_EQUAL(2, pacer.getNumFrames());
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,167 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_frame_stats.h"
+#include "xtime/private/x_time_source.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(frame_stats)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(empty)
+		{
+			frame_stats_t stats;
+			stats.init(gTestAllocator, 100);
+			CHECK_EQUAL(128, stats.getCapacity());
+			CHECK_EQUAL(128, stats.getWindow());
+			CHECK_EQUAL(0, stats.getNumFrames());
+			CHECK_EQUAL(0.0, stats.getMeanMs());
+			CHECK_EQUAL(0.0, stats.getPercentileMs(99.0));
+			CHECK_EQUAL(0.0, stats.getLowMs(1.0));
+			stats.exit();
+		}
+
+		UNITTEST_TEST(constant)
+		{
+			frame_stats_t stats;
+			stats.init(gTestAllocator, 64);
+
+			for (s32 i = 0; i < 200; ++i)
+				stats.addFrame(16000);
+
+			CHECK_EQUAL(64, stats.getNumFrames());
+			CHECK_CLOSE(16.0, stats.getMinMs(), 0.0001);
+			CHECK_CLOSE(16.0, stats.getMaxMs(), 0.0001);
+			CHECK_CLOSE(16.0, stats.getMeanMs(), 0.0001);
+			CHECK_CLOSE(0.0, stats.getStdDevMs(), 0.0001);
+			CHECK_CLOSE(16.0, stats.getPercentileMs(50.0), 0.0001);
+			CHECK_CLOSE(16.0, stats.getPercentileMs(99.0), 0.0001);
+			CHECK_CLOSE(16.0, stats.getLowMs(1.0), 0.0001);
+			stats.exit();
+		}
+
+		UNITTEST_TEST(stutter)
+		{
+			frame_stats_t stats;
+			stats.init(gTestAllocator, 1024);
+			stats.setWindow(1000);
+
+			// 990 frames of 10 ms and 10 stutters of 50 ms
+			for (s32 i = 0; i < 1000; ++i)
+				stats.addFrame((i % 100) == 50 ? 50000 : 10000);
+
+			frame_stats_summary_t s;
+			stats.getSummary(s);
+			CHECK_EQUAL(1000, s.mNumFrames);
+			CHECK_CLOSE(10.0, s.mMinMs, 0.0001);
+			CHECK_CLOSE(50.0, s.mMaxMs, 0.0001);
+			CHECK_CLOSE(10.4, s.mMeanMs, 0.0001);
+			CHECK_CLOSE(10.0, s.mP50Ms, 10.0 * 0.02);
+			CHECK_CLOSE(10.0, s.mP95Ms, 10.0 * 0.02);
+			CHECK_CLOSE(10.0, s.mP99Ms, 10.0 * 0.02);
+			CHECK_CLOSE(50.0, stats.getPercentileMs(99.5), 50.0 * 0.02);
+			CHECK_CLOSE(50.0, s.mLow1Ms, 50.0 * 0.02);
+			CHECK_CLOSE(50.0, s.mLow01Ms, 0.0001);
+			CHECK_CLOSE(20.0, stats.getLowFps(1.0), 20.0 * 0.02);
+			CHECK_CLOSE(30.0, stats.getLowMs(2.0), 30.0 * 0.02);
+			stats.exit();
+		}
+
+		UNITTEST_TEST(window)
+		{
+			frame_stats_t stats;
+			stats.init(gTestAllocator, 16);
+
+			for (s32 i = 1; i <= 16; ++i)
+				stats.addFrame(i * 1000);
+			CHECK_CLOSE(1.0, stats.getMinMs(), 0.0001);
+			CHECK_CLOSE(16.0, stats.getMaxMs(), 0.0001);
+
+			stats.setWindow(4);
+			CHECK_EQUAL(4, stats.getNumFrames());
+			CHECK_CLOSE(13.0, stats.getMinMs(), 0.0001);
+			CHECK_CLOSE(14.5, stats.getMeanMs(), 0.0001);
+
+			// The maximum leaves the window
+			stats.addFrame(2000);
+			stats.addFrame(2000);
+			stats.addFrame(2000);
+			CHECK_CLOSE(2.0, stats.getMinMs(), 0.0001);
+			CHECK_CLOSE(16.0, stats.getMaxMs(), 0.0001);
+			stats.addFrame(3000);
+			CHECK_CLOSE(3.0, stats.getMaxMs(), 0.0001);
+			CHECK_CLOSE(2.25, stats.getMeanMs(), 0.0001);
+
+			stats.setWindow(16);
+			CHECK_EQUAL(16, stats.getNumFrames());
+			CHECK_CLOSE(2.0, stats.getMinMs(), 0.0001);
+			CHECK_CLOSE(16.0, stats.getMaxMs(), 0.0001);
+			stats.exit();
+		}
+
+		UNITTEST_TEST(markFrame)
+		{
+			sTimeSource.reset();
+
+			frame_stats_t stats;
+			stats.init(gTestAllocator, 8);
+			stats.markFrame();
+			CHECK_EQUAL(0, stats.getNumFrames());
+			sTimeSource.update(5000);
+			stats.markFrame();
+			sTimeSource.update(7000);
+			stats.markFrame();
+			CHECK_EQUAL(2, stats.getNumFrames());
+			CHECK_CLOSE(6.0, stats.getMeanMs(), 0.0001);
+			stats.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,156 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_gameclock.h"
+#include "xtime/x_virtual_time.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(gameclock)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static virtual_time_t sTime(1000000);
+		static time_source_t* sPrevious = NULL;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			sPrevious = x_SetThreadTimeSource(&sTime);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetThreadTimeSource(sPrevious);
+		}
+
+		UNITTEST_TEST(root)
+		{
+			gameclock_t clock;
+			clock.init();
+			CHECK_EQUAL(0, clock.now());
+			CHECK_EQUAL(1.0, clock.getRate());
+
+			sTime.advance(1000);
+			CHECK_EQUAL(1000, clock.now());
+			CHECK_EQUAL(1000, clock.trip());
+			CHECK_EQUAL(0, clock.trip());
+
+			clock.set(50);
+			CHECK_EQUAL(50, clock.now());
+			sTime.advance(10);
+			CHECK_EQUAL(60, clock.now());
+			clock.exit();
+		}
+
+		UNITTEST_TEST(scale_and_pause)
+		{
+			gameclock_t clock;
+			clock.init();
+
+			clock.setScale(0.5);
+			sTime.advance(1000);
+			CHECK_EQUAL(500, clock.now());
+
+			clock.pause();
+			CHECK_TRUE(clock.isPaused());
+			CHECK_TRUE(clock.isStopped());
+			sTime.advance(1000);
+			CHECK_EQUAL(500, clock.now());
+
+			// Scaling a paused clock takes effect when it resumes
+			clock.setScale(2.0);
+			clock.resume();
+			CHECK_FALSE(clock.isStopped());
+			CHECK_EQUAL(500, clock.now());
+			sTime.advance(1000);
+			CHECK_EQUAL(2500, clock.now());
+			clock.exit();
+		}
+
+		UNITTEST_TEST(hierarchy)
+		{
+			gameclock_t world, entity, effect;
+			world.init();
+			entity.init(&world);
+			effect.init(&entity);
+			CHECK_TRUE(effect.getParent() == &entity);
+			CHECK_TRUE(world.getFirstChild() == &entity);
+
+			entity.setScale(2.0);
+			effect.setScale(3.0);
+			CHECK_EQUAL(6.0, effect.getRate());
+
+			sTime.advance(100);
+			CHECK_EQUAL(100, world.now());
+			CHECK_EQUAL(200, entity.now());
+			CHECK_EQUAL(600, effect.now());
+
+			// Slowing the world slows everything below it, without a jump
+			world.setScale(0.5);
+			CHECK_EQUAL(600, effect.now());
+			sTime.advance(100);
+			CHECK_EQUAL(150, world.now());
+			CHECK_EQUAL(300, entity.now());
+			CHECK_EQUAL(900, effect.now());
+
+			// Pausing the world stops the children but keeps their own state
+			world.pause();
+			CHECK_TRUE(effect.isStopped());
+			CHECK_FALSE(effect.isPaused());
+			sTime.advance(100);
+			CHECK_EQUAL(900, effect.now());
+			world.resume();
+			sTime.advance(100);
+			CHECK_EQUAL(1200, effect.now());
+
+			// A child that is paused itself stays paused when the parent resumes
+			entity.pause();
+			world.pause();
+			world.resume();
+			CHECK_TRUE(effect.isStopped());
+			sTime.advance(100);
+			CHECK_EQUAL(1200, effect.now());
+
+			effect.exit();
+			entity.exit();
+			world.exit();
+			CHECK_TRUE(world.getFirstChild() == NULL);
+		}
+
+		UNITTEST_TEST(siblings)
+		{
+			gameclock_t world, a, b, c;
+			world.init();
+			a.init(&world);
+			b.init(&world);
+			c.init(&world);
+			b.exit();
+			a.setScale(2.0);
+			c.setScale(3.0);
+			world.setScale(2.0);
+			sTime.advance(10);
+			CHECK_EQUAL(40, a.now());
+			CHECK_EQUAL(60, c.now());
+			c.exit();
+			a.exit();
+			world.exit();
+		}
+
+		UNITTEST_TEST(init_under_paused_parent)
+		{
+			gameclock_t world, entity;
+			world.init();
+			world.pause();
+			entity.init(&world);
+			CHECK_TRUE(entity.isStopped());
+			sTime.advance(10);
+			CHECK_EQUAL(0, entity.now());
+			world.resume();
+			sTime.advance(10);
+			CHECK_EQUAL(10, entity.now());
+			entity.exit();
+			world.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
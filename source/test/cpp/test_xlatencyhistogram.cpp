@@ -0,0 +1,101 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_latency_histogram.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(latency_histogram)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		UNITTEST_TEST(buckets)
+		{
+			latency_histogram_t h;
+			h.init(gTestAllocator, 3, 1000);
+			CHECK_EQUAL(3, h.getPrecisionBits());
+
+			// Values below 2^(3+1) have their own bucket
+			for (tick_t v = 0; v < 16; ++v)
+			{
+				CHECK_EQUAL((u32)v, h.getBucketIndex(v));
+				CHECK_EQUAL(v, h.getBucketLowest((u32)v));
+				CHECK_EQUAL(v, h.getBucketHighest((u32)v));
+			}
+
+			// Every value falls in a bucket that contains it, with a relative error of at most 1/8
+			for (tick_t v = 16; v <= 1000; ++v)
+			{
+				u32 const i = h.getBucketIndex(v);
+				CHECK_TRUE(v >= h.getBucketLowest(i));
+				CHECK_TRUE(v <= h.getBucketHighest(i));
+				CHECK_TRUE((h.getBucketHighest(i) - h.getBucketLowest(i)) * 8 <= h.getBucketLowest(i));
+				CHECK_TRUE(i < h.getNumBuckets());
+			}
+			h.exit();
+		}
+
+		UNITTEST_TEST(record)
+		{
+			latency_histogram_t h;
+			h.init(gTestAllocator, 7, 1000000);
+			CHECK_EQUAL(0, h.getTotalCount());
+			CHECK_EQUAL(0, h.getValueAtPercentile(50.0));
+
+			for (tick_t v = 1; v <= 10000; ++v)
+				h.record(v);
+
+			CHECK_EQUAL(10000, h.getTotalCount());
+			CHECK_EQUAL(1, h.getMin());
+			CHECK_EQUAL(10000, h.getMax());
+			CHECK_CLOSE(5000.5, h.getMean(), 0.001);
+			CHECK_CLOSE(5000.0, (f64)h.getValueAtPercentile(50.0), 5000.0 / 128.0);
+			CHECK_CLOSE(9900.0, (f64)h.getValueAtPercentile(99.0), 9900.0 / 128.0);
+			CHECK_TRUE(h.getValueAtPercentile(99.0) >= 9900);
+			CHECK_EQUAL(10000, h.getValueAtPercentile(100.0));
+
+			h.record(5000000);
+			CHECK_EQUAL(1, h.getOverflowCount());
+			CHECK_EQUAL(1000000, h.getMax());
+
+			h.reset();
+			CHECK_EQUAL(0, h.getTotalCount());
+			CHECK_EQUAL(0, h.getMin());
+			h.exit();
+		}
+
+		UNITTEST_TEST(snapshot_merge)
+		{
+			latency_histogram_t a, b, snap;
+			a.init(gTestAllocator, 5, 100000);
+			b.init(gTestAllocator, 5, 100000);
+			snap.init(gTestAllocator, 5, 100000);
+
+			a.recordValues(100, 10);
+			b.recordValues(5000, 30);
+			b.record(7);
+
+			b.snapshot(snap);
+			CHECK_EQUAL(31, snap.getTotalCount());
+			CHECK_EQUAL(7, snap.getMin());
+
+			a.merge(snap);
+			CHECK_EQUAL(41, a.getTotalCount());
+			CHECK_EQUAL(7, a.getMin());
+			CHECK_EQUAL(5000, a.getMax());
+			CHECK_EQUAL(a.getBucketHighest(a.getBucketIndex(100)), a.getValueAtPercentile(25.0));
+			CHECK_EQUAL(5000, a.getValueAtPercentile(99.0));
+
+			a.exit();
+			b.exit();
+			snap.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
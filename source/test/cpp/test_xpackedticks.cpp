@@ -0,0 +1,144 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_packed_ticks.h"
+
+using namespace xcore;
+
+extern alloc_t* gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(packed_ticks)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static u64 sRandom(u64& state)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return state >> 33;
+		}
+
+		static const u32 sCount = 128 * 40 + 77;
+		static tick_t sValues[sCount];
+
+		// Blocks of every bit width from 0 to 40, the last block is partial
+		static void sFill()
+		{
+			u64 state = 3;
+			tick_t t = X_CONSTANT_64(630000000000000000);
+			for (u32 i = 0; i < sCount; ++i)
+			{
+				u32 const bits = (i / 128) % 41;
+				u64 const mask = bits == 0 ? 0 : ((X_CONSTANT_64(1) << bits) - 1);
+				u64 const r = (sRandom(state) << 31) ^ sRandom(state);
+				sValues[i] = t + (tick_t)(r & mask);
+				if ((i % 128) == 5)
+					sValues[i] = t + (tick_t)mask; // Make sure the full width is used
+				if ((i % 128) == 127)
+					t += 1000000;
+			}
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			sFill();
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+		}
+
+		UNITTEST_TEST(get_and_decode)
+		{
+			packed_ticks_t column;
+			column.init(gTestAllocator, 2);
+			column.append(sValues, sCount);
+			CHECK_EQUAL(sCount, column.getNumValues());
+			CHECK_EQUAL(41, (s32)column.getNumBlocks());
+
+			for (u32 i = 0; i < sCount; ++i)
+				CHECK_EQUAL(sValues[i], column.get(i));
+
+			tick_t values[packed_ticks_t::BLOCK_SIZE];
+			for (u32 b = 0; b < column.getNumBlocks(); ++b)
+			{
+				u32 const n = column.decode(b, values);
+				CHECK_EQUAL(column.getBlockSize(b), n);
+				tick_t lo = values[0], hi = values[0];
+				for (u32 i = 0; i < n; ++i)
+				{
+					CHECK_EQUAL(sValues[b * packed_ticks_t::BLOCK_SIZE + i], values[i]);
+					lo = values[i] < lo ? values[i] : lo;
+					hi = values[i] > hi ? values[i] : hi;
+				}
+				CHECK_EQUAL(lo, column.getBlockMin(b));
+				CHECK_EQUAL(hi, column.getBlockMax(b));
+			}
+			CHECK_EQUAL(0, (s32)column.getBlockBits(0));
+			CHECK_EQUAL(21, (s32)column.getBlockBits(21));
+			CHECK_EQUAL(32, (s32)column.getBlockBits(32));
+			CHECK_EQUAL(64, (s32)column.getBlockBits(33));
+
+			column.exit();
+		}
+
+		UNITTEST_TEST(range)
+		{
+			packed_ticks_t column;
+			column.init(gTestAllocator);
+			column.append(sValues, sCount);
+
+			tick_t const from = sValues[128 * 7 + 3];
+			tick_t const until = sValues[128 * 30 + 64];
+			u64 expected = 0;
+			for (u32 i = 0; i < sCount; ++i)
+				expected += (sValues[i] >= from && sValues[i] < until) ? 1 : 0;
+			CHECK_EQUAL(expected, column.count(from, until));
+			CHECK_EQUAL(0, (s64)column.count(until, from));
+			CHECK_EQUAL(sCount, (u32)column.count(sValues[0], sValues[sCount - 1] + X_CONSTANT_64(0x20000000000)));
+
+			u32 indices[64];
+			u32 first = 0;
+			u64 found = 0;
+			for (;;)
+			{
+				u32 const n = column.select(from, until, first, indices, 64);
+				for (u32 i = 0; i < n; ++i)
+				{
+					CHECK_TRUE(indices[i] >= first);
+					CHECK_TRUE(sValues[indices[i]] >= from && sValues[indices[i]] < until);
+				}
+				found += n;
+				if (n < 64)
+					break;
+				first = indices[n - 1] + 1;
+			}
+			CHECK_EQUAL(expected, found);
+
+			column.exit();
+		}
+
+		UNITTEST_TEST(datetime)
+		{
+			packed_ticks_t column;
+			column.init(gTestAllocator);
+			datetime_t dt(2024, 6, 1, 8, 0, 0);
+			for (u32 i = 0; i < 1000; ++i)
+			{
+				column.append(dt);
+				dt.addMilliseconds(1);
+			}
+			CHECK_EQUAL((tick_t)datetime_t(2024, 6, 1, 8, 0, 0).ticks(), column.get(0));
+			// 128 ms in 100 ns ticks needs 21 bits
+			CHECK_EQUAL(21, (s32)column.getBlockBits(0));
+			CHECK_TRUE(column.getNumBytes() < 1000 * 4);
+
+			column.clear();
+			CHECK_EQUAL(0, column.getNumValues());
+			CHECK_EQUAL(0, column.getNumBlocks());
+			column.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
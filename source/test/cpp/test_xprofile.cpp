@@ -0,0 +1,257 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#define X_TIME_PROFILE
+#include "xtime/x_time.h"
+#include "xtime/x_profile.h"
+#include "xtime/private/x_time_source.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(profile)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static bool sEqual(const char* a, const char* b)
+		{
+			while (*a != '\0' && *a == *b)
+			{
+				++a;
+				++b;
+			}
+			return *a == *b;
+		}
+
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+
+		static void sInner()
+		{
+			X_PROFILE_ZONE("inner");
+			sTimeSource.update(10);
+		}
+
+		static void sOuter()
+		{
+			X_PROFILE_ZONE("outer");
+			sTimeSource.update(5);
+			sInner();
+			sInner();
+			sTimeSource.update(5);
+		}
+
+		static u32 sFindZone(const char* name)
+		{
+			for (u32 i = 0; i < x_ProfileGetNumZones(); ++i)
+			{
+				const profile_zone_t* zone = x_ProfileGetZone(i);
+				const char* a = zone->mName;
+				const char* b = name;
+				while (*a != '\0' && *a == *b)
+				{
+					++a;
+					++b;
+				}
+				if (*a == *b)
+					return zone->mId;
+			}
+			return profile_aggregator_t::NONE;
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(disabled)
+		{
+			// Without x_ProfileInit nothing is recorded
+			CHECK_FALSE(x_ProfileBegin(0));
+			sOuter();
+			CHECK_EQUAL(0, x_ProfileGetNumThreads());
+		}
+
+		UNITTEST_TEST(aggregate)
+		{
+			sTimeSource.reset();
+			x_ProfileInit(gTestAllocator, 1024);
+			X_PROFILE_THREAD("main");
+
+			sOuter();
+			sOuter();
+			sInner();
+
+			CHECK_EQUAL(1, x_ProfileGetNumThreads());
+			CHECK_EQUAL(0, x_ProfileGetNumDropped(0));
+
+			char name[8];
+			CHECK_TRUE(x_ProfileGetThreadName(0, name, sizeof(name)));
+			CHECK_TRUE(sEqual("main", name));
+			CHECK_TRUE(x_ProfileGetThreadName(0, name, 3));
+			CHECK_TRUE(sEqual("ma", name));
+			CHECK_FALSE(x_ProfileGetThreadName(1, name, sizeof(name)));
+			CHECK_EQUAL('\0', name[0]);
+
+			u32 const outerZone = sFindZone("outer");
+			u32 const innerZone = sFindZone("inner");
+			CHECK_NOT_EQUAL(profile_aggregator_t::NONE, outerZone);
+			CHECK_NOT_EQUAL(profile_aggregator_t::NONE, innerZone);
+			CHECK_EQUAL(outerZone, x_ProfileGetZone(outerZone)->mId);
+
+			profile_aggregator_t aggregator;
+			aggregator.init(gTestAllocator);
+			x_ProfileFlush(&aggregator);
+
+			// root, outer, outer/inner and inner
+			CHECK_EQUAL(4, aggregator.getNumNodes());
+			CHECK_EQUAL(2, aggregator.getZoneCalls(outerZone));
+			CHECK_EQUAL(5, aggregator.getZoneCalls(innerZone));
+			CHECK_EQUAL(60, aggregator.getZoneInclusive(outerZone));
+			CHECK_EQUAL(20, aggregator.getZoneExclusive(outerZone));
+			CHECK_EQUAL(50, aggregator.getZoneInclusive(innerZone));
+			CHECK_EQUAL(50, aggregator.getZoneExclusive(innerZone));
+
+			const profile_node_t& root = aggregator.getNode(0);
+			CHECK_EQUAL(0, root.mDepth);
+			for (u32 c = root.mFirstChild; c != profile_aggregator_t::NONE; c = aggregator.getNode(c).mNextSibling)
+			{
+				const profile_node_t& node = aggregator.getNode(c);
+				CHECK_EQUAL(1, node.mDepth);
+				if (node.mZone == outerZone)
+				{
+					CHECK_EQUAL(2, node.mCalls);
+					const profile_node_t& inner = aggregator.getNode(node.mFirstChild);
+					CHECK_EQUAL(innerZone, inner.mZone);
+					CHECK_EQUAL(4, inner.mCalls);
+					CHECK_EQUAL(40, inner.mInclusive);
+				}
+				else
+				{
+					CHECK_EQUAL(innerZone, node.mZone);
+					CHECK_EQUAL(1, node.mCalls);
+				}
+			}
+
+			aggregator.exit();
+			x_ProfileExit();
+		}
+
+		UNITTEST_TEST(dropped)
+		{
+			sTimeSource.reset();
+			x_ProfileInit(gTestAllocator, 64);
+
+			for (s32 i = 0; i < 100; ++i)
+				sInner();
+			u32 const outerZone = sFindZone("outer");
+			u32 const innerZone = sFindZone("inner");
+			CHECK_TRUE(x_ProfileGetNumDropped(0) > 0);
+
+			profile_aggregator_t aggregator;
+			aggregator.init(gTestAllocator);
+			x_ProfileFlush(&aggregator);
+			CHECK_EQUAL(32, aggregator.getZoneCalls(innerZone));
+
+			// After the flush there is room again
+			sOuter();
+			x_ProfileFlush(&aggregator);
+			CHECK_EQUAL(34, aggregator.getZoneCalls(innerZone));
+			CHECK_EQUAL(1, aggregator.getZoneCalls(outerZone));
+
+			aggregator.exit();
+			x_ProfileExit();
+		}
+
+		UNITTEST_TEST(too_deep)
+		{
+			// Zone i begins at tick i and ends at tick 2 * depth - i, then zone 1 runs once more at the root
+			u32 const depth = profile_aggregator_t::MAX_DEPTH + 2;
+			profile_event_t events[2 * depth + 2];
+			for (u32 i = 0; i < depth; ++i)
+			{
+				events[i].mTime = (tick_t)i;
+				events[i].mZone = i;
+				events[i].mKind = profile_event_t::BEGIN;
+				events[2 * depth - 1 - i].mTime = (tick_t)(2 * depth - i);
+				events[2 * depth - 1 - i].mZone = i;
+				events[2 * depth - 1 - i].mKind = profile_event_t::END;
+			}
+			events[2 * depth].mTime = 1000;
+			events[2 * depth].mZone = 1;
+			events[2 * depth].mKind = profile_event_t::BEGIN;
+			events[2 * depth + 1].mTime = 1010;
+			events[2 * depth + 1].mZone = 1;
+			events[2 * depth + 1].mKind = profile_event_t::END;
+
+			profile_aggregator_t aggregator;
+			aggregator.init(gTestAllocator);
+			aggregator.onProfileEvents(0, events, 2 * depth + 2);
+
+			CHECK_EQUAL(2, aggregator.getNumDropped());
+			CHECK_EQUAL(1 + profile_aggregator_t::MAX_DEPTH + 1, aggregator.getNumNodes());
+			for (u32 i = 2; i < profile_aggregator_t::MAX_DEPTH; ++i)
+			{
+				CHECK_EQUAL(1, aggregator.getZoneCalls(i));
+				CHECK_EQUAL((tick_t)(2 * (depth - i)), aggregator.getZoneInclusive(i));
+			}
+			CHECK_EQUAL(2 * depth, aggregator.getZoneInclusive(0));
+			CHECK_EQUAL(2, aggregator.getZoneCalls(1));
+			CHECK_EQUAL(0, aggregator.getZoneCalls(depth - 1));
+
+			// Zone 1 after the deep stack is a child of the root again
+			const profile_node_t& root = aggregator.getNode(0);
+			bool found = false;
+			for (u32 c = root.mFirstChild; c != profile_aggregator_t::NONE; c = aggregator.getNode(c).mNextSibling)
+			{
+				const profile_node_t& node = aggregator.getNode(c);
+				if (node.mZone == 1)
+				{
+					found = true;
+					CHECK_EQUAL(10, node.mInclusive);
+				}
+			}
+			CHECK_TRUE(found);
+
+			aggregator.reset();
+			CHECK_EQUAL(0, aggregator.getNumDropped());
+			aggregator.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,129 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_radix_heap.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(radix_heap)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		UNITTEST_TEST(constructor)
+		{
+			radix_heap_t<s32> heap;
+			heap.init(gTestAllocator);
+			CHECK_TRUE(heap.empty());
+			CHECK_EQUAL(0, heap.size());
+
+			u64 key = 0;
+			s32 value = 0;
+			CHECK_FALSE(heap.top(key));
+			CHECK_FALSE(heap.pop(key, value));
+			heap.exit();
+		}
+
+		UNITTEST_TEST(push_pop_sorted)
+		{
+			radix_heap_t<s32> heap;
+			heap.init(gTestAllocator, 2);
+
+			u64 const keys[] = { 50, 3, 3, 1000000, 7, 0, 64, 65, 1, 999 };
+			s32 const n = sizeof(keys) / sizeof(keys[0]);
+			for (s32 i = 0; i < n; ++i)
+				heap.push(keys[i], (s32)keys[i] * 2);
+			CHECK_EQUAL(n, heap.size());
+
+			u64 top;
+			CHECK_TRUE(heap.top(top));
+			CHECK_EQUAL(0, top);
+
+			u64 prev = 0;
+			for (s32 i = 0; i < n; ++i)
+			{
+				u64 key = 0;
+				s32 value = 0;
+				CHECK_TRUE(heap.pop(key, value));
+				CHECK_TRUE(key >= prev);
+				CHECK_EQUAL((s32)key * 2, value);
+				prev = key;
+			}
+			CHECK_EQUAL(1000000, prev);
+			CHECK_TRUE(heap.empty());
+			heap.exit();
+		}
+
+		UNITTEST_TEST(simulation)
+		{
+			radix_heap_t<u32> heap;
+			heap.init(gTestAllocator);
+
+			// Every popped event schedules a new event somewhere in the future
+			u32 rnd = 12345;
+			for (u32 i = 0; i < 64; ++i)
+			{
+				rnd = rnd * 1664525 + 1013904223;
+				heap.push(rnd >> 20, i);
+			}
+
+			tick_t prev = 0;
+			for (u32 i = 0; i < 10000; ++i)
+			{
+				tick_t when = 0;
+				u32 id = 0;
+				CHECK_TRUE(heap.pop(when, id));
+				CHECK_TRUE(when >= prev);
+				CHECK_EQUAL((u64)when, heap.lastKey());
+				prev = when;
+
+				rnd = rnd * 1664525 + 1013904223;
+				heap.push((u64)when + (rnd >> 16), id);
+			}
+			CHECK_EQUAL(64, heap.size());
+
+			heap.clear();
+			CHECK_TRUE(heap.empty());
+			CHECK_EQUAL(0, heap.lastKey());
+			heap.exit();
+		}
+
+		UNITTEST_TEST(remove)
+		{
+			radix_heap_t<s32> heap;
+			heap.init(gTestAllocator);
+			for (s32 i = 0; i < 100; ++i)
+				heap.push((u64)(i * 10), i);
+
+			u64 key = 0;
+			s32 value = 0;
+			CHECK_TRUE(heap.pop(key, value));
+			CHECK_EQUAL(0, value);
+
+			// The minimum of a bucket, an entry of a higher bucket and one that was popped
+			CHECK_TRUE(heap.remove(1));
+			CHECK_TRUE(heap.remove(64));
+			CHECK_FALSE(heap.remove(0));
+			CHECK_EQUAL(97, heap.size());
+			CHECK_TRUE(heap.top(key));
+			CHECK_EQUAL(20, key);
+
+			s32 expected = 2;
+			while (heap.pop(key, value))
+			{
+				if (expected == 64)
+					expected++;
+				CHECK_EQUAL(expected, value);
+				CHECK_EQUAL((u64)(expected * 10), key);
+				expected++;
+			}
+			CHECK_EQUAL(100, expected);
+			heap.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
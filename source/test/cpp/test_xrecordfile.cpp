@@ -0,0 +1,195 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_record_file.h"
+
+#include <stdio.h>
+
+using namespace xcore;
+
+extern alloc_t* gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(record_file)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static const char* sFilename = "test_xrecordfile.rec";
+
+		struct quote_t
+		{
+			u32 mId;
+			f32 mPrice;
+			u16 mVolume; // The stride is padded to 8 bytes
+		};
+
+		static datetime_t sKey(u32 i)
+		{
+			// Every 10 ms, 4 records share a key
+			datetime_t dt(2024, 2, 29, 23, 59, 0);
+			dt.addMilliseconds((s32)(i / 4) * 10);
+			return dt;
+		}
+
+		static bool sAppend(record_file_t& file, u32 first, u32 count)
+		{
+			for (u32 i = first; i < first + count; ++i)
+			{
+				quote_t q = { i, (f32)i * 0.5f, (u16)(i & 0xffff) };
+				if (!file.append(sKey(i), &q))
+					return false;
+			}
+			return true;
+		}
+
+		// Copies the file without the last 'cut' bytes
+		static void sCut(u32 cut)
+		{
+			static u8 sContent[256 * 1024];
+			FILE* file = fopen(sFilename, "rb");
+			u32 const size = (u32)fread(sContent, 1, sizeof(sContent), file);
+			fclose(file);
+			file = fopen(sFilename, "wb");
+			fwrite(sContent, 1, size - cut, file);
+			fclose(file);
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			remove(sFilename);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			remove(sFilename);
+		}
+
+		UNITTEST_TEST(append_and_find)
+		{
+			record_file_t file;
+			CHECK_TRUE(file.open(sFilename, gTestAllocator, sizeof(quote_t), 16));
+			CHECK_TRUE(sAppend(file, 0, 1000));
+			CHECK_EQUAL(1000, (s32)file.getNumRecords());
+			CHECK_EQUAL(0, (s32)file.getNumCommitted());
+			CHECK_TRUE(file.commit());
+			CHECK_EQUAL(1000, (s32)file.getNumCommitted());
+
+			// Keys must not decrease
+			quote_t q = { 0, 0.0f, 0 };
+			CHECK_FALSE(file.append(sKey(0), &q));
+			CHECK_TRUE(file.close());
+
+			CHECK_TRUE(file.openReadOnly(sFilename, gTestAllocator));
+			CHECK_FALSE(file.isWritable());
+			CHECK_EQUAL(1000, (s32)file.getNumRecords());
+			CHECK_EQUAL((s32)sizeof(quote_t), (s32)file.getRecordSize());
+			CHECK_EQUAL(16, (s32)file.getBlockSize());
+			CHECK_FALSE(file.append(sKey(1000), &q));
+
+			for (u32 i = 0; i < 1000; i += 37)
+			{
+				CHECK_TRUE(file.getKey(i) == sKey(i));
+				CHECK_EQUAL(i, ((const quote_t*)file.getRecord(i))->mId);
+			}
+
+			// Lookups of every key, the first of equal keys is found
+			for (u32 i = 0; i < 1000; i += 4)
+				CHECK_EQUAL(i, (u32)file.lowerBound(sKey(i)));
+			CHECK_EQUAL(0, (s32)file.lowerBound(datetime_t(2000, 1, 1)));
+			CHECK_EQUAL(1000, (s32)file.lowerBound(sKey(1000)));
+
+			datetime_t from = sKey(100);
+			from.addMilliseconds(5);
+			record_range_t range = file.find(from, sKey(400));
+			CHECK_EQUAL(104, (s32)range.getFirst());
+			CHECK_EQUAL(296, (s32)range.getNumRecords());
+			for (u64 i = 0; i < range.getNumRecords(); ++i)
+			{
+				u32 const id = ((const quote_t*)range.getRecord(i))->mId;
+				CHECK_EQUAL((u32)(104 + i), id);
+				CHECK_TRUE(range.getKey(i) == sKey(id));
+			}
+			CHECK_TRUE(file.find(sKey(400), sKey(100)).isEmpty());
+			CHECK_TRUE(file.close());
+		}
+
+		UNITTEST_TEST(reopen_and_append)
+		{
+			record_file_t file;
+			CHECK_TRUE(file.open(sFilename, gTestAllocator, sizeof(quote_t), 16));
+			CHECK_TRUE(sAppend(file, 0, 100));
+			CHECK_TRUE(file.close());
+
+			// The record size of an existing file must match
+			CHECK_FALSE(file.open(sFilename, gTestAllocator, sizeof(quote_t) + 1));
+			CHECK_TRUE(file.open(sFilename, gTestAllocator, sizeof(quote_t)));
+			CHECK_EQUAL(100, (s32)file.getNumRecords());
+			CHECK_EQUAL(16, (s32)file.getBlockSize());
+			CHECK_TRUE(sAppend(file, 100, 5000));
+			CHECK_TRUE(file.close());
+
+			CHECK_TRUE(file.openReadOnly(sFilename, gTestAllocator));
+			CHECK_EQUAL(5100, (s32)file.getNumRecords());
+			CHECK_EQUAL(4000, (s32)file.lowerBound(sKey(4000)));
+			CHECK_EQUAL(5099, ((const quote_t*)file.getRecord(5099))->mId);
+			CHECK_TRUE(file.close());
+		}
+
+		UNITTEST_TEST(reader_refresh)
+		{
+			record_file_t writer;
+			CHECK_TRUE(writer.open(sFilename, gTestAllocator, sizeof(quote_t), 16));
+			CHECK_TRUE(sAppend(writer, 0, 100));
+			CHECK_TRUE(writer.commit());
+			CHECK_TRUE(sAppend(writer, 100, 50));
+
+			// Only committed records are visible
+			record_file_t reader;
+			CHECK_TRUE(reader.openReadOnly(sFilename, gTestAllocator));
+			CHECK_EQUAL(100, (s32)reader.getNumRecords());
+
+			CHECK_TRUE(sAppend(writer, 150, 3000));
+			CHECK_TRUE(writer.commit());
+			CHECK_TRUE(reader.refresh());
+			CHECK_EQUAL(3150, (s32)reader.getNumRecords());
+			CHECK_EQUAL(2000, (s32)reader.lowerBound(sKey(2000)));
+
+			CHECK_TRUE(reader.close());
+			CHECK_TRUE(writer.close());
+		}
+
+		UNITTEST_TEST(torn_tail)
+		{
+			record_file_t file;
+			CHECK_TRUE(file.open(sFilename, gTestAllocator, sizeof(quote_t), 16));
+			CHECK_TRUE(sAppend(file, 0, 200));
+			CHECK_TRUE(file.close());
+
+			// A file cut in the middle of a record keeps the whole records before it
+			sCut(30); // A stride of 24 bytes
+			CHECK_TRUE(file.open(sFilename, gTestAllocator, sizeof(quote_t)));
+			CHECK_EQUAL(198, (s32)file.getNumRecords());
+			CHECK_EQUAL(198, (s32)file.getNumCommitted());
+
+			// Records that were never committed are not part of the file
+			CHECK_TRUE(sAppend(file, 198, 10));
+			CHECK_TRUE(file.commit());
+			CHECK_TRUE(sAppend(file, 208, 10));
+			record_file_t reader;
+			CHECK_TRUE(reader.openReadOnly(sFilename, gTestAllocator));
+			CHECK_EQUAL(208, (s32)reader.getNumRecords());
+			CHECK_EQUAL(207, ((const quote_t*)reader.getRecord(207))->mId);
+			CHECK_TRUE(reader.close());
+			CHECK_TRUE(file.close());
+
+			// Not a record file
+			FILE* other = fopen(sFilename, "wb");
+			fputs("{\"traceEvents\":[]}                                                       ", other);
+			fclose(other);
+			CHECK_FALSE(file.openReadOnly(sFilename, gTestAllocator));
+			CHECK_FALSE(file.isOpen());
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,54 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_running_stats.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(running_stats)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		UNITTEST_FIXTURE_SETUP() {}
+		UNITTEST_FIXTURE_TEARDOWN() {}
+
+		UNITTEST_TEST(add)
+		{
+			running_stats_t stats;
+			CHECK_EQUAL(0, stats.count());
+			CHECK_EQUAL(0.0, stats.variance());
+
+			f64 const samples[] = { 2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0 };
+			for (s32 i = 0; i < 8; ++i)
+				stats.add(samples[i]);
+
+			CHECK_EQUAL(8, stats.count());
+			CHECK_CLOSE(5.0, stats.mean(), 0.000001);
+			CHECK_CLOSE(32.0 / 7.0, stats.variance(), 0.000001);
+			CHECK_CLOSE(2.13808993, stats.stddev(), 0.000001);
+			CHECK_EQUAL(2.0, stats.min());
+			CHECK_EQUAL(9.0, stats.max());
+
+			stats.reset();
+			CHECK_EQUAL(0, stats.count());
+		}
+
+		UNITTEST_TEST(merge)
+		{
+			running_stats_t a, b, all;
+			for (s32 i = 0; i < 10; ++i)
+			{
+				f64 const v = (f64)(i * i) * 0.5;
+				(i < 4 ? a : b).add(v);
+				all.add(v);
+			}
+
+			a.merge(b);
+			CHECK_EQUAL(all.count(), a.count());
+			CHECK_CLOSE(all.mean(), a.mean(), 0.000001);
+			CHECK_CLOSE(all.variance(), a.variance(), 0.000001);
+			CHECK_EQUAL(all.min(), a.min());
+			CHECK_EQUAL(all.max(), a.max());
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,275 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_scheduler.h"
+#include "xtime/private/x_time_source.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(scheduler)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			set(tick_t t)
+			{
+				mTicks = t;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		class counting_job : public job_t
+		{
+		public:
+			counting_job() : mCount(0), mLastNow(0), mCost(0) {}
+
+			virtual void	execute(tick_t now)
+			{
+				mCount++;
+				mLastNow = now;
+				sTimeSource.update(mCost);
+			}
+
+			s32				mCount;
+			tick_t			mLastNow;
+			tick_t			mCost;
+			static xtime_source_test sTimeSource;
+		};
+
+		xtime_source_test counting_job::sTimeSource;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&counting_job::sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(one_shot)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 2);
+			CHECK_EQUAL(2, scheduler.getNumWorkers());
+
+			counting_job job;
+			scheduler.scheduleIn(&job, 100, 0);
+
+			CHECK_EQUAL(0, scheduler.runDue(0));
+			counting_job::sTimeSource.update(99);
+			CHECK_EQUAL(0, scheduler.runDue(0));
+			counting_job::sTimeSource.update(11);
+			CHECK_EQUAL(1, scheduler.runDue(0));
+			CHECK_EQUAL(1, job.mCount);
+			CHECK_EQUAL(1, job.getNumRuns());
+			CHECK_EQUAL(10, job.getMaxLateness());
+			CHECK_EQUAL(0, scheduler.runDue(0));
+			CHECK_EQUAL(1, scheduler.getNumExecuted(0));
+
+			CHECK_TRUE(job.isIdle());
+			job.resetStats();
+			CHECK_EQUAL(0, job.getNumRuns());
+			CHECK_EQUAL(0, job.getMaxLateness());
+			CHECK_EQUAL(0.0, job.getAverageLatenessUs());
+
+			scheduler.exit();
+		}
+
+		UNITTEST_TEST(fixed_rate)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 1);
+
+			counting_job job;
+			job.mCost = 5;
+			scheduler.schedulePeriodic(&job, 100, 100, job_t::FIXED_RATE, 0);
+
+			counting_job::sTimeSource.update(100);
+			CHECK_EQUAL(1, scheduler.runDue(0));
+			CHECK_EQUAL(200, job.getDeadline());
+
+			// Running late, the fixed-rate job catches up with the missed deadlines
+			counting_job::sTimeSource.set(450);
+			CHECK_EQUAL(3, scheduler.runDue(0));
+			CHECK_EQUAL(500, job.getDeadline());
+			CHECK_EQUAL(4, job.getNumRuns());
+			CHECK_EQUAL(250, job.getMaxLateness());
+
+			// The job stays queued until the scheduler drops it at its deadline
+			job.cancel();
+			CHECK_TRUE(job.isCancelled());
+			CHECK_FALSE(job.isIdle());
+			CHECK_FALSE(scheduler.scheduleAt(&job, 2000, 0));
+			counting_job::sTimeSource.set(1000);
+			scheduler.runDue(0);
+			CHECK_EQUAL(4, job.mCount);
+			CHECK_TRUE(job.isIdle());
+
+			scheduler.exit();
+		}
+
+		UNITTEST_TEST(cancel_queued)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 2);
+
+			counting_job job1, job2;
+			CHECK_TRUE(scheduler.schedulePeriodic(&job1, 100, 100, job_t::FIXED_RATE, 1));
+			CHECK_TRUE(scheduler.scheduleAt(&job2, 50, 1));
+			CHECK_FALSE(job1.isIdle());
+			CHECK_FALSE(scheduler.scheduleAt(&job1, 10, 0));
+
+			// Removed from the queue right away, the other job stays
+			scheduler.cancel(&job1);
+			CHECK_TRUE(job1.isIdle());
+			CHECK_TRUE(job1.isCancelled());
+
+			counting_job::sTimeSource.set(1000);
+			CHECK_EQUAL(1, scheduler.runDue(1));
+			CHECK_EQUAL(0, job1.mCount);
+			CHECK_EQUAL(1, job2.mCount);
+			CHECK_TRUE(job2.isIdle());
+
+			// A released job can be scheduled again
+			CHECK_TRUE(scheduler.scheduleAt(&job1, 1000, 0));
+			CHECK_FALSE(job1.isCancelled());
+			CHECK_EQUAL(1, scheduler.runDue(0));
+			CHECK_EQUAL(1, job1.mCount);
+			CHECK_TRUE(job1.isIdle());
+
+			scheduler.cancel(&job1);
+			CHECK_TRUE(job1.isIdle());
+
+			scheduler.exit();
+		}
+
+		UNITTEST_TEST(exit_releases_jobs)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 1);
+
+			counting_job job;
+			CHECK_TRUE(scheduler.schedulePeriodic(&job, 100, 100, job_t::FIXED_DELAY, 0));
+			CHECK_FALSE(job.isIdle());
+			scheduler.exit();
+			CHECK_TRUE(job.isIdle());
+		}
+
+		UNITTEST_TEST(fixed_delay)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 1);
+
+			counting_job job;
+			job.mCost = 5;
+			scheduler.schedulePeriodic(&job, 100, 100, job_t::FIXED_DELAY, 0);
+
+			counting_job::sTimeSource.set(150);
+			CHECK_EQUAL(1, scheduler.runDue(0));
+			CHECK_EQUAL(255, job.getDeadline());
+			CHECK_EQUAL(50, job.getMaxLateness());
+
+			counting_job::sTimeSource.set(1000);
+			CHECK_EQUAL(1, scheduler.runDue(0));
+			CHECK_EQUAL(1105, job.getDeadline());
+
+			scheduler.exit();
+		}
+
+		UNITTEST_TEST(steal)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 4);
+
+			counting_job job1, job2;
+			scheduler.scheduleAt(&job1, 10, 2);
+			scheduler.scheduleAt(&job2, 1000, 3);
+
+			counting_job::sTimeSource.set(20);
+			CHECK_EQUAL(1, scheduler.runDue(0));
+			CHECK_EQUAL(1, job1.mCount);
+			CHECK_EQUAL(0, job2.mCount);
+			CHECK_EQUAL(1, scheduler.getNumStolen(0));
+			CHECK_EQUAL(0, scheduler.runDue(2));
+
+			scheduler.exit();
+		}
+
+		static void		sRunWorker(scheduler_t* scheduler)
+		{
+			scheduler->run(0);
+		}
+
+		UNITTEST_TEST(run_waits_for_work)
+		{
+			counting_job::sTimeSource.reset();
+
+			scheduler_t scheduler;
+			scheduler.init(gTestAllocator, 2);
+
+			// With empty queues the worker only wakes up for a push or a stop
+			std::thread thread(sRunWorker, &scheduler);
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+			counting_job job;
+			CHECK_TRUE(scheduler.scheduleAt(&job, 0, 1));
+			for (s32 i = 0; i < 1000 && !job.isIdle(); ++i)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			CHECK_TRUE(job.isIdle());
+			CHECK_EQUAL(1, job.mCount);
+			CHECK_EQUAL(1, scheduler.getNumStolen(0));
+
+			scheduler.requestStop();
+			thread.join();
+			scheduler.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
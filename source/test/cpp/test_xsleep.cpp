@@ -0,0 +1,69 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timespan.h"
+#include "xtime/x_sleep.h"
+
+#include "xtime/private/x_time_source.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(sleep)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		UNITTEST_FIXTURE_SETUP()
+		{
+			xtime::x_Init();
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			xtime::x_Exit();
+		}
+
+		UNITTEST_TEST(sleep_until_past)
+		{
+			x_ResetSleepStats();
+
+			tick_t const now = x_GetTime();
+			x_SleepUntil(now - 100);
+
+			sleep_stats_t stats;
+			x_GetSleepStats(stats);
+			CHECK_EQUAL(0, stats.mNumSleeps);
+			CHECK_EQUAL(0, stats.mTotalOvershoot);
+		}
+
+		UNITTEST_TEST(sleep_until)
+		{
+			x_ResetSleepStats();
+
+			for (s32 i = 0; i < 4; ++i)
+			{
+				tick_t const deadline = x_GetTime() + x_MillisecondsToTicks(2.0);
+				x_SleepUntil(deadline);
+				CHECK_TRUE(x_GetTime() >= deadline);
+			}
+
+			sleep_stats_t stats;
+			x_GetSleepStats(stats);
+			CHECK_EQUAL(4, stats.mNumSleeps);
+			CHECK_TRUE(stats.mMaxOvershoot >= 0);
+			CHECK_TRUE(stats.mTotalOvershoot >= stats.mMaxOvershoot);
+			CHECK_TRUE(stats.mSpinTail >= 0);
+		}
+
+		UNITTEST_TEST(sleep_for)
+		{
+			tick_t const start = x_GetTime();
+			x_SleepFor(timespan_t::sFromMilliseconds(3));
+			CHECK_TRUE(x_TicksToMs(x_GetTime() - start) >= 3.0);
+
+			tick_t const start2 = x_GetTime();
+			x_SleepForTicks(x_MicrosecondsToTicks(500.0));
+			CHECK_TRUE(x_TicksToUs(x_GetTime() - start2) >= 500.0);
+		}
+	}
+}
+UNITTEST_SUITE_END
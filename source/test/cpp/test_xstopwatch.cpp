@@ -0,0 +1,156 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_stopwatch.h"
+
+#include "xtime/private/x_time_source.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(stopwatch)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(constructor)
+		{
+			stopwatch_t sw;
+			CHECK_FALSE(sw.isRunning());
+			CHECK_EQUAL(0, sw.read());
+			CHECK_EQUAL(0, sw.trip());
+			CHECK_EQUAL(0, sw.getNumLaps());
+			CHECK_EQUAL(0, sw.getNumStoredLaps());
+		}
+
+		UNITTEST_TEST(laps)
+		{
+			sTimeSource.reset();
+
+			stopwatch_t sw;
+			sw.start();
+			sw.start();
+			CHECK_EQUAL(0, sw.getNumLaps());
+
+			// Laps of 1, 2, 3, 4 and 5 ms
+			for (s32 i = 1; i <= 5; ++i)
+			{
+				sTimeSource.update(i * 1000);
+				CHECK_EQUAL(i * 1000, sw.trip());
+			}
+			CHECK_EQUAL(5, sw.getNumLaps());
+			CHECK_EQUAL(5000, sw.getLastLap());
+			CHECK_EQUAL(1000, sw.getMin());
+			CHECK_EQUAL(5000, sw.getMax());
+			CHECK_CLOSE(3000.0, sw.getMean(), 0.001);
+			CHECK_CLOSE(1581.1388, sw.getStdDev(), 0.001);
+			CHECK_CLOSE(3.0, sw.getMeanMs(), 0.000001);
+			CHECK_CLOSE(1.5811388, sw.getStdDevMs(), 0.000001);
+			CHECK_CLOSE(1.0, sw.getMinMs(), 0.000001);
+			CHECK_CLOSE(5.0, sw.getMaxMs(), 0.000001);
+
+			sw.reset();
+			CHECK_FALSE(sw.isRunning());
+			CHECK_EQUAL(0, sw.getNumLaps());
+		}
+
+		UNITTEST_TEST(paused)
+		{
+			sTimeSource.reset();
+
+			stopwatch_t sw;
+			sw.start();
+			sTimeSource.update(100);
+			CHECK_EQUAL(100, sw.stop());
+			sTimeSource.update(1000);
+			CHECK_EQUAL(0, sw.trip());
+			CHECK_EQUAL(0, sw.getNumLaps());
+
+			// The time the stopwatch was stopped is not part of the lap
+			sw.start();
+			sTimeSource.update(50);
+			CHECK_EQUAL(150, sw.read());
+			CHECK_EQUAL(150, sw.trip());
+			CHECK_EQUAL(0, sw.read());
+			CHECK_EQUAL(1, sw.getNumLaps());
+		}
+
+		UNITTEST_TEST(lap_buffer)
+		{
+			sTimeSource.reset();
+
+			tick_t laps[4];
+			stopwatch_t sw;
+			sw.setLapBuffer(laps, 4);
+			sw.start();
+
+			for (s32 i = 1; i <= 3; ++i)
+			{
+				sTimeSource.update(i);
+				sw.trip();
+			}
+			CHECK_EQUAL(3, sw.getNumStoredLaps());
+			CHECK_EQUAL(1, sw.getLap(0));
+			CHECK_EQUAL(3, sw.getLap(2));
+			CHECK_EQUAL(0, sw.getLap(3));
+
+			// Keeps the last 4 laps
+			for (s32 i = 4; i <= 11; ++i)
+			{
+				sTimeSource.update(i);
+				sw.trip();
+			}
+			CHECK_EQUAL(11, sw.getNumLaps());
+			CHECK_EQUAL(4, sw.getNumStoredLaps());
+			for (u32 i = 0; i < 4; ++i)
+				CHECK_EQUAL((tick_t)(8 + i), sw.getLap(i));
+
+			sw.setLapBuffer(NULL, 0);
+			CHECK_EQUAL(0, sw.getNumStoredLaps());
+			sTimeSource.update(12);
+			CHECK_EQUAL(12, sw.trip());
+			CHECK_EQUAL(12, sw.getNumLaps());
+		}
+	}
+}
+UNITTEST_SUITE_END
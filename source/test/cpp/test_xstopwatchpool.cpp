@@ -0,0 +1,159 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_stopwatch_pool.h"
+
+#include "xtime/private/x_time_source.h"
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(stopwatch_pool)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(single)
+		{
+			sTimeSource.reset();
+
+			stopwatch_pool_t pool;
+			pool.init(gTestAllocator, 4);
+			CHECK_EQUAL(4, pool.getCapacity());
+			CHECK_FALSE(pool.isRunning(2));
+
+			pool.start(2);
+			CHECK_TRUE(pool.isRunning(2));
+			sTimeSource.update(100);
+			CHECK_EQUAL(100, pool.read(2));
+			CHECK_EQUAL(0, pool.read(1));
+			CHECK_EQUAL(100, pool.stop(2));
+			sTimeSource.update(100);
+			CHECK_EQUAL(100, pool.read(2));
+
+			// Starting again continues to accumulate
+			pool.start(2);
+			sTimeSource.update(50);
+			CHECK_EQUAL(150, pool.stop(2));
+
+			pool.reset(2);
+			CHECK_EQUAL(0, pool.read(2));
+			pool.exit();
+		}
+
+		UNITTEST_TEST(batch)
+		{
+			sTimeSource.reset();
+
+			stopwatch_pool_t pool;
+			pool.init(gTestAllocator, 8);
+
+			u32 const even[] = { 0, 2, 4, 6 };
+			u32 const odd[] = { 1, 3, 5, 7 };
+			pool.startBatch(even, 4);
+			sTimeSource.update(10);
+			pool.startBatch(odd, 4);
+			pool.startBatch(even, 4);	// already running
+			sTimeSource.update(10);
+			pool.stopBatch(even, 4);
+			sTimeSource.update(10);
+
+			tick_t times[8];
+			pool.read(0, 8, times);
+			for (u32 i = 0; i < 8; ++i)
+				CHECK_EQUAL(20, times[i]);
+
+			pool.stopAll();
+			sTimeSource.update(10);
+			pool.read(0, 8, times);
+			for (u32 i = 0; i < 8; ++i)
+			{
+				CHECK_FALSE(pool.isRunning(i));
+				CHECK_EQUAL(20, times[i]);
+			}
+			pool.exit();
+		}
+
+		UNITTEST_TEST(range)
+		{
+			sTimeSource.reset();
+
+			stopwatch_pool_t pool;
+			pool.init(gTestAllocator, 100);
+
+			pool.startRange(10, 20);
+			sTimeSource.update(1000);
+			pool.startAll();
+			sTimeSource.update(1000);
+			pool.stopRange(0, 50);
+
+			f64 ms[100];
+			f64 us[100];
+			pool.readMs(0, 100, ms);
+			pool.readUs(0, 100, us);
+			for (u32 i = 0; i < 100; ++i)
+			{
+				f64 const expected = (i >= 10 && i < 30) ? 2.0 : 1.0;
+				CHECK_CLOSE(expected, ms[i], 0.000001);
+				CHECK_CLOSE(expected * 1000.0, us[i], 0.000001);
+			}
+
+			tick_t ticks[10];
+			for (u32 i = 0; i < 10; ++i)
+				ticks[i] = i;
+			pool.add(90, 10, ticks);
+			CHECK_EQUAL(1009, pool.read(99));
+
+			pool.resetRange(0, 50);
+			CHECK_EQUAL(0, pool.read(20));
+			CHECK_TRUE(pool.isRunning(50));
+			pool.resetAll();
+			CHECK_FALSE(pool.isRunning(50));
+			pool.exit();
+		}
+	}
+}
+UNITTEST_SUITE_END
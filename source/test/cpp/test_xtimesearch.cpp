@@ -0,0 +1,146 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_time_search.h"
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(time_search)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		static u64 sRandom(u64& state)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			return state >> 33;
+		}
+
+		static const u32 sCount = 5000;
+		static tick_t sValues[sCount];
+		static u32 sIndices[sCount];
+
+		static u32 sReference(const tick_t* values, u32 count, tick_t key)
+		{
+			u32 i = 0;
+			while (i < count && values[i] < key)
+				++i;
+			return i;
+		}
+
+		enum EPattern
+		{
+			EVEN,
+			DUPLICATES,
+			CLUSTERED,
+			EXTREMES,
+			NUM_PATTERNS
+		};
+
+		static void sFill(EPattern pattern, u64& state)
+		{
+			tick_t t = -(tick_t)sCount * 500;
+			for (u32 i = 0; i < sCount; ++i)
+			{
+				switch (pattern)
+				{
+				case EVEN: t += 1000 + (tick_t)(sRandom(state) % 100); break;
+				case DUPLICATES: t += (sRandom(state) % 4) == 0 ? 7 : 0; break;
+				case CLUSTERED: t += (i % 500) == 0 ? X_CONSTANT_64(1000000000000) : (tick_t)(sRandom(state) % 3); break;
+				default: t = (i < 10) ? -(tick_t)X_CONSTANT_64(0x7fffffffffffffff) - 1 + (tick_t)i : (i >= sCount - 10) ? (tick_t)X_CONSTANT_64(0x7fffffffffffffff) - (tick_t)(sCount - 1 - i) : t + 997; break;
+				}
+				sValues[i] = t;
+			}
+		}
+
+		static tick_t sRandomKey(u64& state)
+		{
+			u32 const i = (u32)(sRandom(state) % sCount);
+			switch (sRandom(state) % 4)
+			{
+			case 0: return sValues[i];
+			case 1: return sValues[i] - 1;
+			case 2: return sValues[i] + 1;
+			default: return (tick_t)((sRandom(state) << 33) ^ (sRandom(state) << 2) ^ sRandom(state));
+			}
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+		}
+
+		UNITTEST_TEST(single)
+		{
+			u64 state = 11;
+			for (s32 p = 0; p < NUM_PATTERNS; ++p)
+			{
+				sFill((EPattern)p, state);
+				for (u32 k = 0; k < 2000; ++k)
+				{
+					tick_t const key = sRandomKey(state);
+					u32 const count = (k & 1) ? sCount : (u32)(sRandom(state) % 70);
+					u32 const expected = sReference(sValues, count, key);
+					CHECK_EQUAL(expected, x_LowerBound(sValues, count, key));
+					CHECK_EQUAL(expected, x_InterpolationSearch(sValues, count, key));
+					CHECK_EQUAL(expected, x_GallopSearch(sValues, count, key, (u32)(sRandom(state) % (sCount + 10))));
+				}
+				tick_t const lowest = -(tick_t)X_CONSTANT_64(0x7fffffffffffffff) - 1;
+				tick_t const highest = (tick_t)X_CONSTANT_64(0x7fffffffffffffff);
+				CHECK_EQUAL(sReference(sValues, sCount, lowest), x_InterpolationSearch(sValues, sCount, lowest));
+				CHECK_EQUAL(sReference(sValues, sCount, highest), x_InterpolationSearch(sValues, sCount, highest));
+			}
+			CHECK_EQUAL(0, x_LowerBound(sValues, 0, 0));
+			CHECK_EQUAL(0, x_InterpolationSearch(sValues, 0, 0));
+			CHECK_EQUAL(0, x_GallopSearch(sValues, 0, 0, 5));
+		}
+
+		UNITTEST_TEST(batch)
+		{
+			u64 state = 5;
+			static tick_t sKeys[sCount];
+			for (s32 p = 0; p < NUM_PATTERNS; ++p)
+			{
+				sFill((EPattern)p, state);
+
+				// Dense and sparse sorted query sets
+				for (u32 stride = 1; stride <= 1000; stride *= 10)
+				{
+					u32 n = 0;
+					for (u32 i = 0; i < sCount; i += stride)
+						sKeys[n++] = sValues[i] + (tick_t)(sRandom(state) % 3) - 1;
+					x_LowerBoundBatch(sValues, sCount, sKeys, n, sIndices);
+					for (u32 i = 0; i < n; ++i)
+						CHECK_EQUAL(sReference(sValues, sCount, sKeys[i]), sIndices[i]);
+				}
+			}
+		}
+
+		UNITTEST_TEST(datetime)
+		{
+			static datetime_t sDates[1000];
+			datetime_t dt(2023, 12, 31, 23, 0, 0);
+			for (u32 i = 0; i < 1000; ++i)
+			{
+				sDates[i] = dt;
+				dt.addSeconds(7);
+			}
+
+			datetime_t key(2024, 1, 1);
+			u32 const expected = (3600 + 6) / 7;
+			CHECK_EQUAL(expected, x_LowerBound(sDates, 1000, key));
+			CHECK_EQUAL(expected, x_InterpolationSearch(sDates, 1000, key));
+			CHECK_EQUAL(expected, x_GallopSearch(sDates, 1000, key, 900));
+
+			datetime_t keys[3] = { datetime_t(2023, 1, 1), key, datetime_t(2025, 1, 1) };
+			x_LowerBoundBatch(sDates, 1000, keys, 3, sIndices);
+			CHECK_EQUAL(0, sIndices[0]);
+			CHECK_EQUAL(expected, sIndices[1]);
+			CHECK_EQUAL(1000, sIndices[2]);
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,142 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_datetime.h"
+#include "xtime/private/x_time_source.h"
+#include "xtime/private/x_datetime_source.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(time_source)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		// Counts the calls that are in flight and the calls that were made while
+		// the source was retired, the latter must never happen.
+		class xtime_source_test : public time_source_t
+		{
+		public:
+			xtime_source_test(s64 base, s64 rate = 1000 * 1000) : mBase(base), mRate(rate), mInside(0), mCalls(0), mErrors(0), mRetired(true) {}
+
+			virtual s64			getTimeInTicks()
+			{
+				mInside.fetch_add(1);
+				if (mRetired.load())
+					mErrors.fetch_add(1);
+				mCalls.fetch_add(1);
+				s64 const t = mBase;
+				mInside.fetch_sub(1);
+				return t;
+			}
+
+			virtual s64			getTicksPerSecond()
+			{
+				return mRate;
+			}
+
+			s64					mBase;
+			s64					mRate;
+			std::atomic<s32>	mInside;
+			std::atomic<u64>	mCalls;
+			std::atomic<u64>	mErrors;
+			std::atomic<bool>	mRetired;
+		};
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+			x_SetDateTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(default_source)
+		{
+			x_SetTimeSource(NULL);
+			CHECK_EQUAL(1000000000, x_GetTicksPerSecond());
+			tick_t const t0 = x_GetTime();
+			tick_t const t1 = x_GetTime();
+			CHECK_TRUE(t1 >= t0);
+
+			x_SetDateTimeSource(NULL);
+			datetime_t const now = datetime_t::sNowUtc();
+			CHECK_TRUE(now.year() >= 2020);
+			datetime_t const dt(2020, 2, 29, 12, 30, 15);
+			CHECK_EQUAL(dt.ticks(), datetime_t::sFromFileTime(dt.toFileTime()).ticks());
+			CHECK_EQUAL(X_CONSTANT_64(0), datetime_t(1601, 1, 1).toFileTime());
+		}
+
+		UNITTEST_TEST(set_returns_previous)
+		{
+			xtime_source_test a(100), b(200);
+			time_source_t* const def = x_SetTimeSource(&a);
+			CHECK_TRUE(def != NULL);
+			a.mRetired = false;
+			CHECK_EQUAL(100, x_GetTime());
+			CHECK_EQUAL(1000000, x_GetTicksPerSecond());
+
+			b.mRetired = false;
+			CHECK_TRUE(x_SetTimeSource(&b) == &a);
+			CHECK_EQUAL(200, x_GetTime());
+			CHECK_TRUE(x_SetTimeSource(NULL) == &b);
+			CHECK_TRUE(x_SetTimeSource(NULL) == def);
+			CHECK_EQUAL(1000000000, x_GetTicksPerSecond());
+		}
+
+		UNITTEST_TEST(hot_swap)
+		{
+			xtime_source_test a(1), b(2, 2000 * 1000);
+			xtime_source_test* sources[2] = { &a, &b };
+			a.mRetired = false;
+			x_SetTimeSource(&a);
+
+			std::atomic<bool> stop(false);
+			std::atomic<u64> invalid(0);
+			std::vector<std::thread> readers;
+			for (s32 t = 0; t < 4; ++t)
+			{
+				readers.push_back(std::thread([&]() {
+					while (!stop.load())
+					{
+						tick_t const v = x_GetTime();
+						s64 const rate = x_GetTicksPerSecond();
+						if ((v != 1 && v != 2) || (rate != 1000 * 1000 && rate != 2000 * 1000))
+							invalid.fetch_add(1);
+					}
+				}));
+			}
+
+			s32 retired_in_use = 0;
+			for (s32 i = 1; i <= 200; ++i)
+			{
+				xtime_source_test* next = sources[i & 1];
+				next->mRetired = false;
+				xtime_source_test* previous = (xtime_source_test*)x_SetTimeSource(next);
+				CHECK_EQUAL(next->mRate, x_GetTicksPerSecond());
+				// Nobody may be inside the previous source anymore
+				if (previous->mInside.load() != 0)
+					retired_in_use++;
+				previous->mRetired = true;
+				if ((i % 16) == 0)
+					std::this_thread::yield();
+			}
+
+			stop = true;
+			for (size_t t = 0; t < readers.size(); ++t)
+				readers[t].join();
+			x_SetTimeSource(NULL);
+
+			CHECK_EQUAL(0, retired_in_use);
+			CHECK_EQUAL(0, (s32)invalid.load());
+			CHECK_EQUAL(0, (s32)(a.mErrors.load() + b.mErrors.load()));
+			CHECK_TRUE(a.mCalls.load() + b.mCalls.load() > 0);
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,161 @@
+#include "xbase/x_allocator.h"
+#include "xunittest/xunittest.h"
+
+#define X_TIME_PROFILE
+#include "xtime/x_time.h"
+#include "xtime/x_profile.h"
+#include "xtime/x_trace_writer.h"
+#include "xtime/private/x_time_source.h"
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace xcore;
+
+extern xcore::alloc_t *gTestAllocator;
+
+UNITTEST_SUITE_BEGIN(trace_writer)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		class xtime_source_test : public time_source_t
+		{
+			tick_t			mTicks;
+		public:
+			xtime_source_test()
+				: mTicks(0)
+			{
+			}
+
+			void			reset()
+			{
+				mTicks = 0;
+			}
+
+			void			update(tick_t ticks)
+			{
+				mTicks += ticks;
+			}
+
+			virtual tick_t	getTimeInTicks()
+			{
+				return mTicks;
+			}
+
+			virtual s64		getTicksPerSecond()
+			{
+				return 1000 * 1000;
+			}
+		};
+
+		static xtime_source_test sTimeSource;
+		static const char* sFilename = "test_xtracewriter.json";
+		static char sContent[64 * 1024];
+
+		static u32 sLoad()
+		{
+			FILE* file = fopen(sFilename, "rb");
+			if (file == NULL)
+				return 0;
+			u32 const size = (u32)fread(sContent, 1, sizeof(sContent) - 1, file);
+			fclose(file);
+			remove(sFilename);
+			sContent[size] = '\0';
+			return size;
+		}
+
+		static s32 sCount(const char* pattern)
+		{
+			s32 count = 0;
+			for (const char* s = sContent; *s != '\0'; ++s)
+			{
+				const char* a = s;
+				const char* b = pattern;
+				while (*a != '\0' && *a == *b)
+				{
+					++a;
+					++b;
+				}
+				if (*b == '\0')
+					count++;
+			}
+			return count;
+		}
+
+		static void sZone()
+		{
+			X_PROFILE_ZONE("zone \"quoted\"");
+			sTimeSource.update(1500);
+		}
+
+		UNITTEST_FIXTURE_SETUP()
+		{
+			x_SetTimeSource(&sTimeSource);
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(events)
+		{
+			sTimeSource.reset();
+			sTimeSource.update(1000000);
+
+			trace_writer_t writer;
+			CHECK_TRUE(writer.open(sFilename, gTestAllocator));
+			CHECK_TRUE(writer.isOpen());
+
+			// Times are relative to the epoch (the time of open)
+			writer.writeZone(3, "work", 1000000 + 250, 1000000 + 1250);
+			writer.writeCounter("memory", 1000000 + 2000, 42.0);
+			writer.writeCounter("memory", 1000000 + 3000, HUGE_VAL);
+			writer.writeCounter("memory", 1000000 + 4000, HUGE_VAL - HUGE_VAL);
+			writer.writeFrameMarker(1000000 + 16667, 7);
+			CHECK_EQUAL(3, writer.getNumEvents());
+			CHECK_TRUE(writer.close());
+			CHECK_FALSE(writer.isOpen());
+
+			u32 const size = sLoad();
+			CHECK_TRUE(size > 0);
+			CHECK_EQUAL(1, sCount("{\"traceEvents\":["));
+			CHECK_EQUAL(1, sCount("{\"name\":\"work\",\"ph\":\"X\",\"ts\":250.000,\"pid\":1,\"tid\":3,\"dur\":1000.000}"));
+			CHECK_EQUAL(1, sCount("{\"name\":\"memory\",\"ph\":\"C\",\"ts\":2000.000,\"pid\":1,\"tid\":0,\"args\":{\"value\":42}}"));
+			CHECK_EQUAL(1, sCount("\"name\":\"memory\""));
+			CHECK_EQUAL(0, sCount("inf"));
+			CHECK_EQUAL(0, sCount("nan"));
+			CHECK_EQUAL(1, sCount("\"ph\":\"i\",\"ts\":16667.000"));
+			CHECK_EQUAL(1, sCount("\"args\":{\"frame\":7}"));
+			CHECK_EQUAL(1, sCount("],\"displayTimeUnit\":\"ms\"}"));
+		}
+
+		UNITTEST_TEST(profile)
+		{
+			sTimeSource.reset();
+			x_ProfileInit(gTestAllocator, 1024);
+			X_PROFILE_THREAD("main");
+
+			trace_writer_t writer;
+			CHECK_TRUE(writer.open(sFilename, gTestAllocator, 1024, 0));
+
+			// Enough events to stream several chunks
+			for (s32 i = 0; i < 200; ++i)
+				sZone();
+			x_ProfileFlush(&writer);
+			CHECK_EQUAL(400, writer.getNumEvents());
+			CHECK_TRUE(writer.getNumBytesWritten() > 1024);
+			CHECK_TRUE(writer.close());
+			x_ProfileExit();
+
+			sLoad();
+			CHECK_EQUAL(200, sCount("\"ph\":\"B\""));
+			CHECK_EQUAL(200, sCount("\"ph\":\"E\""));
+			CHECK_EQUAL(200, sCount("{\"name\":\"zone \\\"quoted\\\"\",\"ph\":\"E\""));
+			CHECK_EQUAL(2, sCount("\"ts\":1500.000,"));
+			CHECK_EQUAL(1, sCount("\"ts\":300000.000,"));
+			CHECK_EQUAL(1, sCount("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}"));
+		}
+	}
+}
+UNITTEST_SUITE_END
@@ -0,0 +1,150 @@
+#include "xunittest/xunittest.h"
+
+#include "xtime/x_time.h"
+#include "xtime/x_timer.h"
+#include "xtime/x_sleep.h"
+#include "xtime/x_datetime.h"
+#include "xtime/x_virtual_time.h"
+
+#include <thread>
+#include <vector>
+
+using namespace xcore;
+
+UNITTEST_SUITE_BEGIN(virtual_time)
+{
+	UNITTEST_FIXTURE(main)
+	{
+		UNITTEST_FIXTURE_SETUP()
+		{
+		}
+
+		UNITTEST_FIXTURE_TEARDOWN()
+		{
+			x_SetTimeSource(NULL);
+			x_SetDateTimeSource(NULL);
+		}
+
+		UNITTEST_TEST(advance)
+		{
+			virtual_time_t clock(1000000);
+			CHECK_EQUAL(0, clock.now());
+			clock.advance(10);
+			CHECK_EQUAL(10, clock.now());
+			clock.advanceTo(5);
+			CHECK_EQUAL(10, clock.now());
+			clock.advanceTo(20);
+			CHECK_EQUAL(20, clock.now());
+			clock.advanceSeconds(1.5);
+			CHECK_EQUAL(1500020, clock.now());
+			clock.set(0);
+			CHECK_EQUAL(0, clock.now());
+		}
+
+		UNITTEST_TEST(timer)
+		{
+			virtual_time_t clock(1000000);
+			virtual_time_scope_t scope(clock);
+			CHECK_EQUAL(1000000, x_GetTicksPerSecond());
+
+			xcore::timer_t timer;
+			timer.start();
+			CHECK_EQUAL(0, timer.read());
+			clock.advance(x_SecondsToTicks(3600.0));
+			CHECK_EQUAL(3600000.0, timer.readMs());
+		}
+
+		UNITTEST_TEST(datetime)
+		{
+			virtual_time_t clock(1000, datetime_t(2020, 1, 1));
+			virtual_time_scope_t scope(clock);
+
+			clock.advance(90 * 1000 + 250);
+			datetime_t const utc = datetime_t::sNowUtc();
+			CHECK_EQUAL(datetime_t(2020, 1, 1, 0, 1, 30, 250).ticks(), utc.ticks());
+
+			clock.setTimeZone(60);
+			datetime_t const local = datetime_t::sNow();
+			CHECK_EQUAL(1, local.hour());
+			CHECK_EQUAL(1, local.minute());
+
+			// UTC = local + bias, the convention of the platform sources
+			CHECK_EQUAL(-60, clock.getSystemTimeZone());
+			CHECK_EQUAL(clock.getSystemTimeUtc(), clock.getSystemTimeLocal() + (u64)(clock.getSystemTimeZone() * 60 * 10000000));
+
+			datetime_t const dt(2019, 6, 15, 12, 0, 0);
+			CHECK_EQUAL(dt.ticks(), datetime_t::sFromFileTime(dt.toFileTime()).ticks());
+		}
+
+		UNITTEST_TEST(sleep)
+		{
+			virtual_time_t clock(1000000);
+			virtual_time_scope_t scope(clock);
+
+			x_SleepForTicks(x_SecondsToTicks(10.0 * 3600.0));
+			CHECK_EQUAL(x_SecondsToTicks(10.0 * 3600.0), clock.now());
+			x_SleepUntil(clock.now() - 1);
+			CHECK_EQUAL(x_SecondsToTicks(10.0 * 3600.0), clock.now());
+		}
+
+		UNITTEST_TEST(scope_restores)
+		{
+			s64 const global = x_GetTicksPerSecond();
+			virtual_time_t outer(1000);
+			virtual_time_t inner(2000);
+			{
+				virtual_time_scope_t a(outer);
+				outer.advance(7);
+				{
+					virtual_time_scope_t b(inner);
+					CHECK_EQUAL(2000, x_GetTicksPerSecond());
+					CHECK_EQUAL(0, x_GetTime());
+				}
+				CHECK_EQUAL(1000, x_GetTicksPerSecond());
+				CHECK_EQUAL(7, x_GetTime());
+			}
+			CHECK_EQUAL(global, x_GetTicksPerSecond());
+		}
+
+		UNITTEST_TEST(global)
+		{
+			virtual_time_t clock(1000000);
+			x_SetTimeSource(&clock);
+			clock.advance(42);
+
+			tick_t seen = 0;
+			std::thread other([&]() { seen = x_GetTime(); });
+			other.join();
+			CHECK_EQUAL(42, seen);
+			x_SetTimeSource(NULL);
+		}
+
+		// Every thread runs its own simulation with its own clock
+		UNITTEST_TEST(parallel)
+		{
+			s32 const num = 4;
+			std::vector<s32> errors(num, 0);
+			std::vector<std::thread> threads;
+			for (s32 t = 0; t < num; ++t)
+			{
+				threads.push_back(std::thread([&errors, t]() {
+					virtual_time_t clock(1000000);
+					virtual_time_scope_t scope(clock);
+					tick_t const step = (tick_t)(t + 1);
+					for (s32 i = 1; i <= 10000; ++i)
+					{
+						x_SleepForTicks(step);
+						if (x_GetTime() != step * i)
+							errors[t]++;
+					}
+				}));
+			}
+			for (s32 t = 0; t < num; ++t)
+			{
+				threads[t].join();
+				CHECK_EQUAL(0, errors[t]);
+			}
+		}
+	}
+}
+UNITTEST_SUITE_END
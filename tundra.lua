@@ -53,6 +53,13 @@ Build {
 			Includes = { "source/main/include","source/test/include","../xunittest/source/main/include","../xbase/source/main/include","source/main/include" },
 			Depends = { xunittest_library,xbase_library,xtime_library },
 		}
+		local benchmark = Program {
+			Name = "xtime_bench",
+			Config = "*-*-release-*",
+			Sources = { SourceGlob("source/bench/cpp") },
+			Includes = { "source/main/include","source/bench/include","../xbase/source/main/include" },
+			Depends = { xbase_library,xtime_library },
+		}
 		Default(unittest)
 	end,
 	Configs = {